@@ -321,6 +321,119 @@ class MAGNUM_OPENDDL_EXPORT Document {
         /** @todo some sane way to ensure that the initializer lists are valid for whole Document lifetime */
         bool parse(Containers::ArrayView<const char> data, std::initializer_list<CharacterLiteral> structureIdentifiers, std::initializer_list<CharacterLiteral> propertyIdentifiers);
 
+        /**
+         * @brief Parse data on multiple threads
+         * @param data                      Document data
+         * @param structureIdentifiers      Structure identifiers
+         * @param propertyIdentifiers       Property identifiers
+         * @param threadCount               Thread count
+         * @return Whether the parsing succeeded
+         *
+         * Same as @ref parse(Containers::ArrayView<const char>, std::initializer_list<CharacterLiteral>, std::initializer_list<CharacterLiteral>),
+         * but top-level structures are first split into up to @p threadCount
+         * consecutive chunks of roughly equal size, which are then parsed
+         * in parallel and merged together in the original order. The
+         * resulting document is the same as if it was parsed on a single
+         * thread. Setting @p threadCount to @cpp 0 @ce uses the value of
+         * @ref std::thread::hardware_concurrency(), @cpp 1 @ce parses
+         * everything on the calling thread. On
+         * @ref CORRADE_TARGET_EMSCRIPTEN "Emscripten" the data are always
+         * parsed on the calling thread.
+         *
+         * The library doesn't link to `pthread` on its own, the
+         * *application* has to be linked to it for the threads to be
+         * created. In CMake that can be done like this:
+         *
+         * @code{.cmake}
+         * find_package(Threads REQUIRED)
+         * target_link_libraries(your-application PRIVATE Threads::Threads)
+         * @endcode
+         */
+        bool parse(Containers::ArrayView<const char> data, std::initializer_list<CharacterLiteral> structureIdentifiers, std::initializer_list<CharacterLiteral> propertyIdentifiers, UnsignedInt threadCount);
+
+        /**
+         * @brief Set deferred structures
+         * @return Reference to self (for method chaining)
+         *
+         * Contents of custom structures with given identifiers are not parsed
+         * by subsequent @ref parse() calls --- only the structure name and
+         * properties are, and the contents are skipped until the matching
+         * closing brace. Such structures then appear as having no children in
+         * the document and their contents can be parsed on demand using
+         * @ref parseDeferred(). The data passed to @ref parse() have to stay
+         * in scope until all deferred structures are parsed.
+         *
+         * Structures that contain any names or references (i.e., a `$` or
+         * `%` character outside of literals and comments) are parsed right
+         * away instead, as references inside them may point outside of the
+         * contents and names inside may be referenced from elsewhere, and
+         * neither could be resolved by @ref parseDeferred().
+         * @ref validate() checks only the properties of deferred structures.
+         */
+        Document& setDeferredStructures(std::initializer_list<Int> identifiers);
+
+        /**
+         * @brief Whether given structure is deferred
+         *
+         * Returns @cpp true @ce if contents of given structure were skipped
+         * during parsing because of @ref setDeferredStructures().
+         */
+        bool isDeferred(Structure structure) const;
+
+        /**
+         * @brief Parse contents of a deferred structure
+         * @param structure     Structure for which @ref isDeferred() is
+         *      @cpp true @ce
+         * @param out           Document to parse the contents into
+         * @return Whether the parsing succeeded
+         *
+         * Children of @p structure are parsed as top-level structures of
+         * @p out, using the same identifiers as this document. References can
+         * point only to structures inside the contents. Line numbers in error
+         * messages are relative to the structure contents.
+         */
+        bool parseDeferred(Structure structure, Document& out) const;
+
+        /**
+         * @brief Serialize parsed data
+         * @param sourceKey Data identifying the source the document was
+         *      parsed from
+         *
+         * Produces a binary blob that can be loaded back with
+         * @ref deserialize() without going through the text parser again.
+         * The data are stored with native byte order and type sizes and are
+         * meant to be used only as a cache on the same platform, not as an
+         * interchange format. A SHA-1 digest of @p sourceKey is stored
+         * alongside so @ref deserialize() can detect that the cache is
+         * outdated. The key can be the full source text, which detects any
+         * change but means the whole source has to be read and hashed again
+         * when deserializing, or anything cheaper that changes together with
+         * the source, such as file size and modification time. Expects that
+         * the document doesn't contain any deferred structures.
+         */
+        Containers::Array<char> serialize(Containers::ArrayView<const char> sourceKey = nullptr) const;
+
+        /**
+         * @brief Deserialize data
+         * @param data                      Data produced by @ref serialize()
+         * @param structureIdentifiers      Structure identifiers
+         * @param propertyIdentifiers       Property identifiers
+         * @param sourceKey                 Data identifying the source the
+         *      document was parsed from
+         * @return Whether the deserialization succeeded
+         *
+         * Expects that the document is empty. The identifier lists have to be
+         * the same as the ones used when parsing the serialized document and
+         * @p sourceKey the same as passed to @ref serialize(). If the data
+         * were produced on an incompatible platform, with different
+         * identifiers, from a different source key or are otherwise invalid,
+         * a message is printed on error output and the document has undefined
+         * contents. All sizes and indices are checked to be in bounds, so
+         * damaged data can't cause out-of-bounds access later, but the values
+         * themselves are not validated.
+         */
+        bool deserialize(Containers::ArrayView<const char> data, std::initializer_list<CharacterLiteral> structureIdentifiers, std::initializer_list<CharacterLiteral> propertyIdentifiers, Containers::ArrayView<const char> sourceKey = nullptr);
+
         /** @brief Whether the document is empty */
         bool isEmpty() { return _structures.empty(); }
 
@@ -433,11 +546,14 @@ class MAGNUM_OPENDDL_EXPORT Document {
         struct PropertyData;
         struct StructureData;
 
+        MAGNUM_OPENDDL_LOCAL bool parseInternal(Containers::ArrayView<const char> data, UnsignedInt threadCount);
+        MAGNUM_OPENDDL_LOCAL Containers::ArrayView<const char> deferredData(Structure structure) const;
         MAGNUM_OPENDDL_LOCAL const char* parseProperty(Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, Int position, Implementation::ParseError& error);
         MAGNUM_OPENDDL_LOCAL std::pair<const char*, std::size_t> parseStructure(std::size_t parent, Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, Implementation::ParseError& error);
         MAGNUM_OPENDDL_LOCAL const char* parseStructureList(std::size_t parent, Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, Implementation::ParseError& error);
+        MAGNUM_OPENDDL_LOCAL std::size_t merge(Document& other, std::size_t last, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, const std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& otherReferences);
 
-        MAGNUM_OPENDDL_LOCAL std::size_t dereference(std::size_t originatingStructure, Containers::ArrayView<const char> reference) const;
+        MAGNUM_OPENDDL_LOCAL std::size_t dereference(const std::vector<std::pair<std::size_t, std::size_t>>& names, std::size_t originatingStructure, Containers::ArrayView<const char> reference) const;
 
         MAGNUM_OPENDDL_LOCAL bool validateLevel(const Containers::Optional<Structure>& first, Containers::ArrayView<const std::pair<Int, std::pair<Int, Int>>> allowedStructures, Containers::ArrayView<const Validation::Structure> structures, std::vector<Int>& counts) const;
         MAGNUM_OPENDDL_LOCAL bool validateStructure(Structure structure, const Validation::Structure& validation, Containers::ArrayView<const Validation::Structure> structures, std::vector<Int>& counts) const;
@@ -472,6 +588,10 @@ class MAGNUM_OPENDDL_EXPORT Document {
 
         Containers::ArrayView<const CharacterLiteral> _structureIdentifiers;
         Containers::ArrayView<const CharacterLiteral> _propertyIdentifiers;
+
+        std::vector<Int> _deferredIdentifiers;
+        /* Structure index and its unparsed contents, sorted by the index */
+        std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>> _deferred;
 };
 
 #ifndef DOXYGEN_GENERATING_OUTPUT
@@ -25,8 +25,12 @@
 
 #include "Parsers.h"
 
+#include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <limits>
+#include <locale>
+#include <sstream>
 #include <tuple>
 #include <Corrade/Utility/Debug.h>
 
@@ -36,6 +40,10 @@
 #include <climits>
 #endif
 
+#ifdef CORRADE_TARGET_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace Magnum { namespace OpenDdl { namespace Implementation {
 
 Debug& operator<<(Debug& debug, const ParseErrorType value) {
@@ -93,6 +101,10 @@ constexpr bool isAlphaDecimal(char c) {
     return isAlpha(c) || isBaseN<10>(c);
 }
 
+constexpr UnsignedInt digitValue(char c) {
+    return c >= 'a' ? c - 'a' + 0xa : (c >= 'A' ? c - 'A' + 0xA : c - '0');
+}
+
 template<class T> inline T parseHex(const char* data) {
     T out{};
     for(std::size_t i = 0; i != sizeof(T)*2; ++i)
@@ -293,56 +305,23 @@ template<> struct IntegralType<Double> {
 };
 template<class T> using IntegralTypeFor = typename IntegralType<T>::Type;
 
-template<class> struct ExtractToType;
-/** @todo isn't there something better for extracting to unsigned int on webgl? */
-#ifndef CORRADE_TARGET_EMSCRIPTEN
-template<> struct ExtractToType<UnsignedLong> {
-    typedef UnsignedLong Type;
-    static UnsignedLong extract(const std::string& buffer, Int base) {
-        return std::stoul(buffer, nullptr, base);
-    }
-};
-template<> struct ExtractToType<UnsignedByte>: ExtractToType<UnsignedLong> {};
-template<> struct ExtractToType<Byte>: ExtractToType<UnsignedLong> {};
-template<> struct ExtractToType<UnsignedShort>: ExtractToType<UnsignedLong> {};
-template<> struct ExtractToType<Short>: ExtractToType<UnsignedLong> {};
-template<> struct ExtractToType<UnsignedInt>: ExtractToType<UnsignedLong> {};
-template<> struct ExtractToType<Int>: ExtractToType<UnsignedLong> {};
-template<> struct ExtractToType<Long>: ExtractToType<UnsignedLong> {};
-#ifdef CORRADE_TARGET_APPLE
-template<> struct ExtractToType<unsigned long>: ExtractToType<UnsignedLong> {};
-template<> struct ExtractToType<long>: ExtractToType<UnsignedLong> {};
-#endif
-#else
-template<> struct ExtractToType<UnsignedInt> {
-    typedef UnsignedInt Type;
-    static UnsignedInt extract(const std::string& buffer, Int base) {
-        return std::stoi(buffer, nullptr, base);
-    }
-};
-template<> struct ExtractToType<UnsignedByte>: ExtractToType<UnsignedInt> {};
-template<> struct ExtractToType<Byte>: ExtractToType<UnsignedInt> {};
-template<> struct ExtractToType<UnsignedShort>: ExtractToType<UnsignedInt> {};
-template<> struct ExtractToType<Short>: ExtractToType<UnsignedInt> {};
-template<> struct ExtractToType<Int>: ExtractToType<UnsignedInt> {};
-/* Emscripten 1.38.10 and newer has std::size_t defined as unsigned long, while
-   it was unsigned int before. We should support both cases,
-   integralLiteral<std::size_t>() is used in some places in the parsers. */
-static_assert(sizeof(unsigned long) == 4, "unsigned long is not four bytes on Emscripten");
-template<> struct ExtractToType<unsigned long>: ExtractToType<UnsignedInt> {};
-#endif
-template<class T> using ExtractedType = typename ExtractToType<T>::Type;
-
-template<> struct ExtractToType<Float> {
-    static Float extract(const std::string& buffer) {
-        return std::stof(buffer);
-    }
-};
-template<> struct ExtractToType<Double> {
-    static Double extract(const std::string& buffer) {
-        return std::stod(buffer);
-    }
-};
+/* Converts an already validated decimal literal with the underscores
+   stripped. Unlike std::stof() / std::stod(), the stream is imbued with the
+   classic locale so the result doesn't depend on the global C or C++ locale.
+   The conversion is done by strtof() / strtod() in the C locale underneath,
+   so it's correctly rounded. On overflow the stream reports a failure and
+   sets the value to the largest finite value (or an infinity, depending on
+   the implementation), turn that into an infinity same as strtof() would.
+   Values that underflow are kept as-is. */
+template<class T> T extractLocaleIndependent(const std::string& buffer) {
+    std::istringstream in{buffer};
+    in.imbue(std::locale::classic());
+    T out{};
+    in >> out;
+    if(in.fail() && std::abs(out) >= std::numeric_limits<T>::max())
+        return out < T(0) ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+    return out;
+}
 
 template<class> constexpr Type typeFor();
 #define _c(T) template<> constexpr Type typeFor<T>() { return Type::T; }
@@ -404,7 +383,7 @@ template<Int base, class T> const char* numericCharacters(const Containers::Arra
     return i;
 }
 
-template<Int base, class T> std::pair<const char*, T> baseNLiteral(const Containers::ArrayView<const char> data, std::string& buffer, ParseError& error) {
+template<Int base, class T> std::pair<const char*, T> baseNLiteral(const Containers::ArrayView<const char> data, ParseError& error) {
     /* Propagate errors */
     if(!data) return {};
 
@@ -413,9 +392,19 @@ template<Int base, class T> std::pair<const char*, T> baseNLiteral(const Contain
     /* Propagate errors */
     if(!i) return {};
 
-    extractWithoutUnderscore(data.prefix(i), buffer);
-    const ExtractedType<T> out = ExtractToType<T>::extract(buffer, base);
-    if(out > ExtractedType<T>(std::numeric_limits<T>::max())) {
+    /* Accumulate the value directly, skipping the underscores. Values that
+       don't fit into 64 bits are out of range for any type. */
+    std::uint64_t out = 0;
+    bool overflow = false;
+    for(const char c: data.prefix(i)) {
+        if(c == '_') continue;
+        const UnsignedInt digit = digitValue(c);
+        if(out > (std::numeric_limits<std::uint64_t>::max() - digit)/base)
+            overflow = true;
+        out = out*base + digit;
+    }
+
+    if(overflow || out > std::uint64_t(std::numeric_limits<T>::max())) {
         error = {ParseErrorType::LiteralOutOfRange, typeFor<T>(), data};
         return {};
     }
@@ -423,9 +412,104 @@ template<Int base, class T> std::pair<const char*, T> baseNLiteral(const Contain
     return {i, T(out)};
 }
 
+/* Powers of ten that are exactly representable in a double */
+constexpr Double ExactPowersOfTen[]{
+    1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9,
+    1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18,
+    1.0e19, 1.0e20, 1.0e21, 1.0e22
+};
+
+/* Whether rounding a correctly rounded double to T gives a correctly rounded
+   T as well. Always the case for doubles. For floats it isn't only if the
+   double lands exactly in the middle between two floats (and the original
+   value thus could be slightly on either side), or if the value isn't a
+   normal float. */
+template<class> bool isRoundingExact(Double);
+template<> inline bool isRoundingExact<Double>(Double) { return true; }
+template<> inline bool isRoundingExact<Float>(const Double value) {
+    if(value < Double(std::numeric_limits<Float>::min()) ||
+       value > Double(std::numeric_limits<Float>::max()))
+        return false;
+
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(Double));
+    return (bits & ((1ull << 29) - 1)) != (1ull << 28);
+}
+
+/* Parses an already validated decimal floating-point literal. If the
+   significand fits into 53 bits and the power of ten is exactly
+   representable, the result is a single correctly rounded multiplication or
+   division of two doubles. Otherwise it falls back to the standard library,
+   which is slower and allocates, but handles all the remaining cases
+   exactly. */
+template<class T> T decimalLiteral(const Containers::ArrayView<const char> data, std::string& buffer) {
+    const char* i = data;
+    bool negative = false;
+    if(*i == '+') ++i;
+    else if(*i == '-') {
+        negative = true;
+        ++i;
+    }
+
+    std::uint64_t significand = 0;
+    Int significantDigits = 0;
+    Int exponent = 0;
+    bool afterDot = false;
+    for(; i != data.end(); ++i) {
+        const char c = *i;
+        if(c == '_') continue;
+        if(c == '.') {
+            afterDot = true;
+            continue;
+        }
+        if(!isBaseN<10>(c)) break;
+
+        /* Leading zeros don't count towards the precision, more than 19
+           significant digits could overflow */
+        if((significand || c != '0') && ++significantDigits > 19) {
+            extractWithoutUnderscore(data, buffer);
+            return extractLocaleIndependent<T>(buffer);
+        }
+
+        significand = significand*10 + (c - '0');
+        if(afterDot) --exponent;
+    }
+
+    /* Exponent, clamped to a value that's out of range for any type */
+    if(i != data.end()) {
+        CORRADE_INTERNAL_ASSERT(*i == 'e' || *i == 'E');
+        ++i;
+        bool negativeExponent = false;
+        if(*i == '+') ++i;
+        else if(*i == '-') {
+            negativeExponent = true;
+            ++i;
+        }
+
+        Int exponentValue = 0;
+        for(; i != data.end(); ++i)
+            if(*i != '_' && exponentValue < 100000)
+                exponentValue = exponentValue*10 + (*i - '0');
+        exponent += negativeExponent ? -exponentValue : exponentValue;
+    }
+
+    if(!significand) return negative ? -T(0) : T(0);
+
+    if(significand <= (1ull << 53) && exponent >= -22 && exponent <= 22) {
+        const Double value = exponent < 0 ?
+            Double(significand)/ExactPowersOfTen[-exponent] :
+            Double(significand)*ExactPowersOfTen[exponent];
+        if(isRoundingExact<T>(value))
+            return T(negative ? -value : value);
+    }
+
+    extractWithoutUnderscore(data, buffer);
+    return extractLocaleIndependent<T>(buffer);
+}
+
 }
 
-template<class T> std::tuple<const char*, T, Int> integralLiteral(const Containers::ArrayView<const char> data, std::string& buffer, ParseError& error) {
+template<class T> std::tuple<const char*, T, Int> integralLiteral(const Containers::ArrayView<const char> data, std::string&, ParseError& error) {
     /* Propagate errors */
     if(!data) return {};
 
@@ -462,19 +546,19 @@ template<class T> std::tuple<const char*, T, Int> integralLiteral(const Containe
         case 'x':
         case 'X': {
             base = 16;
-            std::tie(i, value) = baseNLiteral<16, T>(data.suffix(i + 2), buffer, error);
+            std::tie(i, value) = baseNLiteral<16, T>(data.suffix(i + 2), error);
             break;
         }
         case 'o':
         case 'O': {
             base = 8;
-            std::tie(i, value) = baseNLiteral<8, T>(data.suffix(i + 2), buffer, error);
+            std::tie(i, value) = baseNLiteral<8, T>(data.suffix(i + 2), error);
             break;
         }
         case 'b':
         case 'B': {
             base = 2;
-            std::tie(i, value) = baseNLiteral<2, T>(data.suffix(i + 2), buffer, error);
+            std::tie(i, value) = baseNLiteral<2, T>(data.suffix(i + 2), error);
             break;
         }
 
@@ -483,7 +567,7 @@ template<class T> std::tuple<const char*, T, Int> integralLiteral(const Containe
     /* Decimal literal  */
     } else {
         base = 10;
-        std::tie(i, value) = baseNLiteral<10, T>(data.suffix(i), buffer, error);
+        std::tie(i, value) = baseNLiteral<10, T>(data.suffix(i), error);
     }
 
     /** @todo C++14: use {} */
@@ -536,17 +620,17 @@ template<class T> std::pair<const char*, T> floatingPointLiteral(const Container
         switch(i[1]) {
             case 'x':
             case 'X': {
-                std::tie(i, integralValue) = baseNLiteral<16, IntegralTypeFor<T>>(data.suffix(i + 2), buffer, error);
+                std::tie(i, integralValue) = baseNLiteral<16, IntegralTypeFor<T>>(data.suffix(i + 2), error);
                 break;
             }
             case 'o':
             case 'O': {
-                std::tie(i, integralValue) = baseNLiteral<8, IntegralTypeFor<T>>(data.suffix(i + 2), buffer, error);
+                std::tie(i, integralValue) = baseNLiteral<8, IntegralTypeFor<T>>(data.suffix(i + 2), error);
                 break;
             }
             case 'b':
             case 'B': {
-                std::tie(i, integralValue) = baseNLiteral<2, IntegralTypeFor<T>>(data.suffix(i + 2), buffer, error);
+                std::tie(i, integralValue) = baseNLiteral<2, IntegralTypeFor<T>>(data.suffix(i + 2), error);
                 break;
             }
 
@@ -592,8 +676,7 @@ template<class T> std::pair<const char*, T> floatingPointLiteral(const Container
 
     /** @todo verifying out-of-range */
 
-    extractWithoutUnderscore(data.prefix(i), buffer);
-    return {i, ExtractToType<T>::extract(buffer)};
+    return {i, decimalLiteral<T>(data.prefix(i), buffer)};
 }
 
 template std::pair<const char*, Float> floatingPointLiteral<Float>(Containers::ArrayView<const char>, std::string&, ParseError&);
@@ -632,10 +715,13 @@ std::pair<const char*, std::string> stringLiteral(const Containers::ArrayView<co
 
             i = j + 1;
 
-        /* Any other character, append it to result */
+        /* Any other character, append it to result together with all that
+           follow up to the next special one */
         } else {
-            out += c;
-            ++i;
+            const char* j = i + 1;
+            for(; j != data.end() && *j != '\\' && *j != '"' && UnsignedByte(*j) >= 0x20; ++j);
+            out.append(i, j);
+            i = j;
         }
     }
 
@@ -733,6 +819,105 @@ std::pair<const char*, Type> typeLiteral(const Containers::ArrayView<const char>
     return {};
 }
 
+namespace {
+
+#ifdef CORRADE_TARGET_SSE2
+inline UnsignedInt popcount16(UnsignedInt value) {
+    value = value - ((value >> 1) & 0x5555);
+    value = (value & 0x3333) + ((value >> 2) & 0x3333);
+    value = (value + (value >> 4)) & 0x0f0f;
+    return (value + (value >> 8)) & 0x1f;
+}
+#endif
+
+}
+
+/* If there's a string or character literal or a comment at given position,
+   returns pointer to its last character or end if it's not terminated.
+   Otherwise returns the position unchanged. */
+const char* skipLiteralOrComment(const char* i, const char* const end) {
+    /* String or character literal, skip escaped characters */
+    if(*i == '"' || *i == '\'') {
+        const char quote = *i;
+        for(++i; i != end && *i != quote; ++i)
+            if(*i == '\\' && i + 1 != end) ++i;
+        return i;
+    }
+
+    /* Comments */
+    if(*i == '/' && i + 1 != end && i[1] == '/') {
+        for(i += 2; i != end && *i != '\n'; ++i);
+        return i;
+    }
+    if(*i == '/' && i + 1 != end && i[1] == '*') {
+        for(i += 2; i + 1 < end && !(*i == '*' && i[1] == '/'); ++i);
+        return i + 1 < end ? i + 1 : end;
+    }
+
+    return i;
+}
+
+std::size_t dataListSizeHint(const Containers::ArrayView<const char> data) {
+    /* Counts separators until the } that ends the list, nested subarray
+       braces included. Since a list of N items, either flat or split into
+       subarrays, has exactly N - 1 separators at any nesting level, this
+       gives the item count without having to parse anything. Separators and
+       braces in string and character literals and in comments are skipped.
+       No validation is done, so for invalid input the result is only a
+       hint. */
+    if(data.empty() || *data == '}') return 0;
+
+    const char* i = data;
+    std::size_t separators = 0;
+    std::size_t depth = 0;
+
+    #ifdef CORRADE_TARGET_SSE2
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+    const __m128i doubleQuote = _mm_set1_epi8('"');
+    const __m128i singleQuote = _mm_set1_epi8('\'');
+    const __m128i slash = _mm_set1_epi8('/');
+    for(; data.end() - i >= 16; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(i));
+
+        /* If there's a possible literal or comment in the chunk, let the
+           scalar loop below handle the rest */
+        if(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(
+            _mm_cmpeq_epi8(chunk, doubleQuote),
+            _mm_cmpeq_epi8(chunk, singleQuote)),
+            _mm_cmpeq_epi8(chunk, slash)))) break;
+
+        const UnsignedInt commas = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, comma));
+        const UnsignedInt opens = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, open));
+        const UnsignedInt closes = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, close));
+
+        /* For each } in the chunk check whether it's the one that ends the
+           list, i.e. it's on zero depth */
+        for(UnsignedInt c = closes; c; c &= c - 1) {
+            const UnsignedInt below = (c & (~c + 1)) - 1;
+            if(depth + popcount16(opens & below) == popcount16(closes & below))
+                return separators + popcount16(commas & below) + 1;
+        }
+
+        separators += popcount16(commas);
+        depth += popcount16(opens);
+        depth -= popcount16(closes);
+    }
+    #endif
+
+    for(; i != data.end(); ++i) {
+        if(*i == ',') ++separators;
+        else if(*i == '{') ++depth;
+        else if(*i == '}') {
+            if(!depth) break;
+            --depth;
+        } else if((i = skipLiteralOrComment(i, data.end())) == data.end()) break;
+    }
+
+    return separators + 1;
+}
+
 std::pair<const char*, InternalPropertyType> propertyValue(const Containers::ArrayView<const char> data, bool& boolValue, Int& integerValue, Float& floatingPointValue, std::string& stringValue, Containers::ArrayView<const char>& referenceValue, Type& typeValue, std::string& buffer, ParseError& error) {
     /* Propagate errors */
     if(!data) return {};
@@ -97,6 +97,10 @@ std::pair<const char*, Containers::ArrayView<const char>> referenceLiteral(Conta
 std::pair<const char*, Type> possiblyTypeLiteral(Containers::ArrayView<const char> data);
 std::pair<const char*, Type> typeLiteral(Containers::ArrayView<const char> data, ParseError& error);
 
+const char* skipLiteralOrComment(const char* i, const char* end);
+
+std::size_t dataListSizeHint(Containers::ArrayView<const char> data);
+
 std::pair<const char*, InternalPropertyType> propertyValue(Containers::ArrayView<const char> data, bool& boolValue, Int& integerValue, Float& floatingPointValue, std::string& stringValue, Containers::ArrayView<const char>& referenceValue, Type& typeValue, std::string& buffer, ParseError& error);
 
 }}}
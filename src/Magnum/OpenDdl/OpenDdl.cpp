@@ -24,9 +24,14 @@
 */
 
 #include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <thread>
 #include <tuple>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Sha1.h>
 
 #include "Magnum/OpenDdl/Document.h"
 #include "Magnum/OpenDdl/Property.h"
@@ -34,6 +39,7 @@
 #include "Magnum/OpenDdl/Validation.h"
 
 #include "Magnum/OpenDdl/Implementation/Parsers.h"
+#include "MagnumPlugins/Implementation/parallelFor.h"
 
 namespace Magnum { namespace OpenDdl {
 
@@ -158,43 +164,165 @@ bool checkReferencePrefix(Containers::Optional<Structure> s, Containers::ArrayVi
     return true;
 }
 
+/* FNV-1a, names are short so anything more elaborate isn't worth it */
+std::size_t hashName(const Containers::ArrayView<const char> name) {
+    std::size_t hash = 2166136261u;
+    for(const char c: name) hash = (hash ^ UnsignedByte(c))*16777619u;
+    return hash;
 }
 
-std::size_t Document::dereference(const std::size_t originatingStructure, const Containers::ArrayView<const char> reference) const {
+}
+
+std::size_t Document::dereference(const std::vector<std::pair<std::size_t, std::size_t>>& names, const std::size_t originatingStructure, const Containers::ArrayView<const char> reference) const {
     CORRADE_INTERNAL_ASSERT(!reference.empty());
 
     const Containers::ArrayView<const char> leafName = reference.suffix(Implementation::findLastOf(reference, "$%"));
 
+    /* All structures named the same as the leaf, in order they are in the
+       document */
+    const std::size_t hash = hashName(leafName);
+    const auto begin = std::lower_bound(names.begin(), names.end(), std::make_pair(hash, std::size_t{}));
+    auto end = begin;
+    for(; end != names.end() && end->first == hash; ++end);
+
     /* If the reference is a single local name, try to find in in siblings first */
     if(leafName.begin() == reference.begin() && reference[0] == '%') {
         const std::size_t parentIndex = _structures[originatingStructure].parent;
-        std::size_t i = parentIndex == NoParent ? 0 : _structures[parentIndex].custom.firstChild;
-        for(Containers::Optional<Structure> s{Structure{*this, _structures[i]}}; s; i = s->_data.get().next, s = s->findNext())
-            if(Implementation::equals(leafName, {s->name().data(), s->name().size()})) return i;
+        for(auto it = begin; it != end; ++it) {
+            const StructureData& s = _structures[it->second];
+            if(s.parent == parentIndex && Implementation::equals(leafName, {_strings[s.name].data(), _strings[s.name].size()}))
+                return it->second;
+        }
     }
 
     /* The element which has leaf name is the result if also the rest of the
        reference prefix matches in parent structures */
     const Containers::ArrayView<const char> referencePrefix = reference.prefix(leafName.begin());
-    for(std::size_t i = 0; i != _structures.size(); ++i) {
-        const Structure s{*this, _structures[i]};
-        if(s.hasName() && Implementation::equals(leafName, {s.name().data(), s.name().size()}) && checkReferencePrefix(s.parent(), referencePrefix))
-            return i;
+    for(auto it = begin; it != end; ++it) {
+        const Structure s{*this, _structures[it->second]};
+        if(Implementation::equals(leafName, {s.name().data(), s.name().size()}) && checkReferencePrefix(s.parent(), referencePrefix))
+            return it->second;
     }
 
     return NullReference;
 }
 
-bool Document::parse(Containers::ArrayView<const char> data, const std::initializer_list<CharacterLiteral> structureIdentifiers, const std::initializer_list<CharacterLiteral> propertyIdentifiers) {
+namespace {
+
+/* Splits top-level structures into consecutive chunks of at least given size.
+   Braces in string and character literals and in comments are skipped. No
+   validation is done here, errors are discovered only during the actual
+   parsing -- if the braces are not balanced, everything after goes into the
+   last chunk, which makes the parser fail at the same place as if the whole
+   document was parsed at once. */
+std::vector<Containers::ArrayView<const char>> splitTopLevelStructures(const Containers::ArrayView<const char> data, const std::size_t minChunkSize) {
+    std::vector<Containers::ArrayView<const char>> chunks;
+    const char* chunkBegin = data.begin();
+    std::size_t depth = 0;
+    for(const char* i = data.begin(); i != data.end(); ++i) {
+        if(*i == '{') ++depth;
+        else if(*i == '}') {
+            /* Unbalanced brace, let the parser deal with it */
+            if(!depth) break;
+
+            /* End of a top-level structure, cut the chunk if large enough */
+            if(!--depth && std::size_t(i + 1 - chunkBegin) >= minChunkSize) {
+                chunks.push_back(data.slice(chunkBegin, i + 1));
+                chunkBegin = i + 1;
+            }
+        } else if((i = Implementation::skipLiteralOrComment(i, data.end())) == data.end()) break;
+    }
+
+    /* The remaining data, if there's anything else than whitespace. If
+       there's nothing at all, add an empty chunk so the parser has something
+       to go through. */
+    if(chunks.empty() || Implementation::whitespace(data.suffix(chunkBegin)) != data.end())
+        chunks.push_back(data.suffix(chunkBegin));
+
+    return chunks;
+}
+
+/* Finds the closing brace of a list whose opening brace was already
+   consumed, skipping everything in between. Returns nullptr if the list is
+   not terminated. Sets hasNames to whether there's any name or reference
+   (i.e., a $ or % outside of literals and comments) in the list. */
+const char* findListEnd(const Containers::ArrayView<const char> data, bool& hasNames) {
+    hasNames = false;
+    std::size_t depth = 0;
+    for(const char* i = data.begin(); i != data.end(); ++i) {
+        if(*i == '{') ++depth;
+        else if(*i == '}') {
+            if(!depth) return i;
+            --depth;
+        } else if(*i == '$' || *i == '%') hasNames = true;
+        else if((i = Implementation::skipLiteralOrComment(i, data.end())) == data.end()) break;
+    }
+
+    return nullptr;
+}
+
+}
+
+bool Document::parse(const Containers::ArrayView<const char> data, const std::initializer_list<CharacterLiteral> structureIdentifiers, const std::initializer_list<CharacterLiteral> propertyIdentifiers) {
+    return parse(data, structureIdentifiers, propertyIdentifiers, 1);
+}
+
+bool Document::parse(const Containers::ArrayView<const char> data, const std::initializer_list<CharacterLiteral> structureIdentifiers, const std::initializer_list<CharacterLiteral> propertyIdentifiers, const UnsignedInt threadCount) {
     _structureIdentifiers = {structureIdentifiers.begin(), structureIdentifiers.size()};
     _propertyIdentifiers = {propertyIdentifiers.begin(), propertyIdentifiers.size()};
+    return parseInternal(data, threadCount);
+}
 
-    Implementation::ParseError error;
-    std::string buffer;
-
+bool Document::parseInternal(const Containers::ArrayView<const char> data, UnsignedInt threadCount) {
     const char* i = Implementation::whitespace(data);
+
+    /* Split the top-level structures into chunks, one for each thread */
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    if(!threadCount) threadCount = std::thread::hardware_concurrency();
+    #else
+    threadCount = 1;
+    #endif
+    const std::vector<Containers::ArrayView<const char>> chunks = threadCount > 1 ?
+        splitTopLevelStructures(data.suffix(i), (data.end() - i + threadCount - 1)/threadCount) :
+        std::vector<Containers::ArrayView<const char>>{data.suffix(i)};
+
+    /* All chunks except the first are parsed into temporary documents. Copy
+       the identifiers to them upfront so the parsing doesn't need to touch
+       this document from other threads. */
+    struct Chunk {
+        Document document;
+        std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>> references;
+        Implementation::ParseError error;
+        const char* end = nullptr;
+    };
+    Containers::Array<Chunk> otherChunks{Containers::DefaultInit, chunks.size() - 1};
+    for(Chunk& chunk: otherChunks) {
+        chunk.document._structureIdentifiers = _structureIdentifiers;
+        chunk.document._propertyIdentifiers = _propertyIdentifiers;
+        chunk.document._deferredIdentifiers = _deferredIdentifiers;
+    }
+
+    /* The first chunk is parsed directly into this document */
+    Implementation::ParseError error;
+    const std::size_t structureBegin = _structures.size();
     std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>> references;
-    i = parseStructureList(NoParent, data.suffix(i), references, buffer, error);
+    Magnum::Implementation::parallelFor(threadCount, chunks.size(), [&](const std::size_t j) {
+        std::string buffer;
+        if(j == 0) {
+            i = parseStructureList(NoParent, chunks[0], references, buffer, error);
+            return;
+        }
+
+        Chunk& chunk = otherChunks[j - 1];
+        const Containers::ArrayView<const char> chunkData = chunks[j];
+        chunk.end = chunk.document.parseStructureList(NoParent, chunkData.suffix(Implementation::whitespace(chunkData)), chunk.references, buffer, chunk.error);
+    });
+
+    /* Report the first error in the document, if any */
+    for(std::size_t j = 0; i && j != otherChunks.size(); ++j) {
+        i = otherChunks[j].end;
+        error = otherChunks[j].error;
+    }
 
     if(!i) {
         /* Calculate line number */
@@ -297,7 +425,30 @@ bool Document::parse(Containers::ArrayView<const char> data, const std::initiali
         return false;
     }
 
-    /* Everything parsed, dereference references */
+    /* Everything parsed, merge the other chunks in order. Top-level
+       structures of each are attached after the last top-level structure of
+       the previous one. */
+    if(!otherChunks.empty()) {
+        std::size_t last = NoParent;
+        if(structureBegin != _structures.size())
+            for(last = structureBegin; _structures[last].next; last = _structures[last].next);
+        for(Chunk& chunk: otherChunks)
+            last = merge(chunk.document, last, references, chunk.references);
+    }
+
+    /* Index all named structures by a hash of their name. Sorted, so
+       structures with the same name are in the order they are in the
+       document. */
+    std::vector<std::pair<std::size_t, std::size_t>> names;
+    if(!references.empty()) {
+        for(std::size_t j = 0; j != _structures.size(); ++j) {
+            const std::string& name = _strings[_structures[j].name];
+            if(!name.empty()) names.emplace_back(hashName({name.data(), name.size()}), j);
+        }
+        std::sort(names.begin(), names.end());
+    }
+
+    /* Dereference references */
     for(const std::pair<std::size_t, Containers::ArrayView<const char>> reference: references) {
         /* Null reference */
         if(reference.second.empty())
@@ -305,7 +456,7 @@ bool Document::parse(Containers::ArrayView<const char> data, const std::initiali
 
         /* Non-null, try to dereference */
         else {
-            std::size_t r = dereference(reference.first, reference.second);
+            std::size_t r = dereference(names, reference.first, reference.second);
             if(r == NullReference) {
                 Error() << "OpenDdl::Document::parse(): reference" << std::string{reference.second, reference.second.size()} << "was not found";
                 return false;
@@ -317,6 +468,549 @@ bool Document::parse(Containers::ArrayView<const char> data, const std::initiali
     return true;
 }
 
+std::size_t Document::merge(Document& other, std::size_t last, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, const std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& otherReferences) {
+    /* Nothing to merge */
+    if(other._structures.empty()) return last;
+
+    /* The first string in both documents is the empty name, all other indices
+       get shifted */
+    const std::size_t stringOffset = _strings.size() - 1;
+    const std::size_t structureOffset = _structures.size();
+    const std::size_t propertyOffset = _properties.size();
+    const std::size_t referenceOffset = references.size();
+
+    /* Attach the first top-level structure to the last one in this
+       document */
+    if(last != NoParent) _structures[last].next = structureOffset;
+
+    _structures.reserve(_structures.size() + other._structures.size());
+    std::size_t otherLast = 0;
+    for(std::size_t i = 0; i != other._structures.size(); ++i) {
+        StructureData structure = other._structures[i];
+        if(structure.name) structure.name += stringOffset;
+        if(structure.next) structure.next += structureOffset;
+
+        /* Top-level structure, remember the last one */
+        if(structure.parent == NoParent) {
+            if(!structure.next) otherLast = i;
+        } else structure.parent += structureOffset;
+
+        if(structure.primitive.type >= Type::Custom) {
+            structure.custom.propertiesBegin += propertyOffset;
+            if(structure.custom.firstChild)
+                structure.custom.firstChild += structureOffset;
+        } else switch(structure.primitive.type) {
+            #define _c(type, T) \
+            case Type::type: \
+                structure.primitive.begin += data<T>().size(); \
+                break;
+            _c(Bool, bool)
+            _c(UnsignedByte, UnsignedByte)
+            _c(Byte, Byte)
+            _c(UnsignedShort, UnsignedShort)
+            _c(Short, Short)
+            _c(UnsignedInt, UnsignedInt)
+            _c(Int, Int)
+            #ifndef CORRADE_TARGET_EMSCRIPTEN
+            _c(UnsignedLong, UnsignedLong)
+            _c(Long, Long)
+            #endif
+            /** @todo Half */
+            _c(Float, Float)
+            _c(Double, Double)
+            _c(Type, Type)
+            #undef _c
+            case Type::String:
+                structure.primitive.begin += stringOffset;
+                break;
+            case Type::Reference:
+                structure.primitive.begin += referenceOffset;
+                break;
+            case Type::Custom:
+                CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        }
+
+        _structures.push_back(structure);
+    }
+
+    _properties.reserve(_properties.size() + other._properties.size());
+    for(PropertyData property: other._properties) {
+        switch(property.type) {
+            case Implementation::InternalPropertyType::Bool:
+                property.position += _bools.size();
+                break;
+            case Implementation::InternalPropertyType::Binary:
+            case Implementation::InternalPropertyType::Character:
+            case Implementation::InternalPropertyType::Integral:
+                property.position += _ints.size();
+                break;
+            case Implementation::InternalPropertyType::Float:
+                property.position += _floats.size();
+                break;
+            case Implementation::InternalPropertyType::String:
+                property.position += stringOffset;
+                break;
+            case Implementation::InternalPropertyType::Reference:
+                property.position += referenceOffset;
+                break;
+            case Implementation::InternalPropertyType::Type:
+                property.position += _types.size();
+                break;
+        }
+
+        _properties.push_back(property);
+    }
+
+    references.reserve(references.size() + otherReferences.size());
+    for(const std::pair<std::size_t, Containers::ArrayView<const char>>& reference: otherReferences)
+        references.emplace_back(reference.first + structureOffset, reference.second);
+
+    /* Data have to be appended only after all offsets were calculated */
+    _bools.insert(_bools.end(), other._bools.begin(), other._bools.end());
+    _unsignedBytes.insert(_unsignedBytes.end(), other._unsignedBytes.begin(), other._unsignedBytes.end());
+    _bytes.insert(_bytes.end(), other._bytes.begin(), other._bytes.end());
+    _unsignedShorts.insert(_unsignedShorts.end(), other._unsignedShorts.begin(), other._unsignedShorts.end());
+    _shorts.insert(_shorts.end(), other._shorts.begin(), other._shorts.end());
+    _unsignedInts.insert(_unsignedInts.end(), other._unsignedInts.begin(), other._unsignedInts.end());
+    _ints.insert(_ints.end(), other._ints.begin(), other._ints.end());
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    _unsignedLongs.insert(_unsignedLongs.end(), other._unsignedLongs.begin(), other._unsignedLongs.end());
+    _longs.insert(_longs.end(), other._longs.begin(), other._longs.end());
+    #endif
+    _floats.insert(_floats.end(), other._floats.begin(), other._floats.end());
+    _doubles.insert(_doubles.end(), other._doubles.begin(), other._doubles.end());
+    _strings.insert(_strings.end(), std::make_move_iterator(other._strings.begin() + 1), std::make_move_iterator(other._strings.end()));
+    _types.insert(_types.end(), other._types.begin(), other._types.end());
+    for(const std::pair<std::size_t, Containers::ArrayView<const char>>& deferred: other._deferred)
+        _deferred.emplace_back(deferred.first + structureOffset, deferred.second);
+
+    return otherLast + structureOffset;
+}
+
+namespace {
+
+/* Everything is stored in native byte order and with native type sizes, the
+   serialized data are meant as a cache on the machine that produced them,
+   not as an interchange format */
+enum SerializedSection: std::size_t {
+    SerializedBools,
+    SerializedUnsignedBytes,
+    SerializedBytes,
+    SerializedUnsignedShorts,
+    SerializedShorts,
+    SerializedUnsignedInts,
+    SerializedInts,
+    SerializedUnsignedLongs,
+    SerializedLongs,
+    SerializedFloats,
+    SerializedDoubles,
+    SerializedStringSizes,
+    SerializedStringData,
+    SerializedReferences,
+    SerializedTypes,
+    SerializedProperties,
+    SerializedStructures,
+    SerializedSectionCount
+};
+
+struct SerializedHeader {
+    char magic[7];
+    UnsignedByte version;
+    UnsignedShort byteOrder;
+    UnsignedShort sizeofSize;
+    UnsignedShort sizeofProperty;
+    UnsignedShort sizeofStructure;
+    UnsignedLong identifierHash;
+    char sourceDigest[20];
+    char padding[4];
+    UnsignedLong counts[SerializedSectionCount];
+};
+
+static_assert(sizeof(Utility::Sha1::Digest) == sizeof(SerializedHeader::sourceDigest), "unexpected SHA-1 digest size");
+
+constexpr const char SerializedMagic[]{'O', 'p', 'e', 'n', 'D', 'd', 'l'};
+constexpr UnsignedByte SerializedVersion = 2;
+
+/* Sections are padded to eight bytes */
+constexpr UnsignedLong serializedSectionSize(const UnsignedLong size) {
+    return (size + 7)/8*8;
+}
+
+/* Serialized data are only valid for the same identifier lists, otherwise
+   the identifier IDs stored in the structures and properties would have a
+   different meaning */
+UnsignedLong hashIdentifiers(const Containers::ArrayView<const CharacterLiteral> structureIdentifiers, const Containers::ArrayView<const CharacterLiteral> propertyIdentifiers) {
+    UnsignedLong hash = 14695981039346656037ull;
+    const auto add = [&hash](const Containers::ArrayView<const CharacterLiteral> identifiers) {
+        for(const CharacterLiteral& identifier: identifiers) {
+            for(const char c: identifier) hash = (hash ^ UnsignedByte(c))*1099511628211ull;
+            /* Identifier separator, so {"ab", "c"} and {"a", "bc"} differ */
+            hash *= 1099511628211ull;
+        }
+        /* List separator */
+        hash = (hash ^ 0xff)*1099511628211ull;
+    };
+    add(structureIdentifiers);
+    add(propertyIdentifiers);
+    return hash;
+}
+
+UnsignedLong serializedSize(const SerializedHeader& header, const SerializedSection section) {
+    UnsignedLong itemSize{};
+    switch(section) {
+        case SerializedBools:
+        case SerializedUnsignedBytes:
+        case SerializedBytes:
+        case SerializedStringData:
+            itemSize = 1; break;
+        case SerializedUnsignedShorts:
+        case SerializedShorts:
+            itemSize = 2; break;
+        case SerializedUnsignedInts:
+        case SerializedInts:
+        case SerializedFloats:
+            itemSize = 4; break;
+        case SerializedUnsignedLongs:
+        case SerializedLongs:
+        case SerializedDoubles:
+        case SerializedStringSizes:
+            itemSize = 8; break;
+        case SerializedReferences:
+            itemSize = header.sizeofSize; break;
+        case SerializedTypes:
+            itemSize = sizeof(Type); break;
+        case SerializedProperties:
+            itemSize = header.sizeofProperty; break;
+        case SerializedStructures:
+            itemSize = header.sizeofStructure; break;
+        case SerializedSectionCount: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+
+    return serializedSectionSize(header.counts[section]*itemSize);
+}
+
+UnsignedLong serializedSize(const SerializedHeader& header) {
+    UnsignedLong size = serializedSectionSize(sizeof(SerializedHeader));
+    for(std::size_t i = 0; i != SerializedSectionCount; ++i)
+        size += serializedSize(header, SerializedSection(i));
+    return size;
+}
+
+template<class T> void serializeSection(char*& out, const std::vector<T>& data) {
+    if(!data.empty()) std::memcpy(out, data.data(), data.size()*sizeof(T));
+    out += serializedSectionSize(data.size()*sizeof(T));
+}
+
+template<class T> void deserializeSection(const char*& in, std::vector<T>& data, const std::size_t count) {
+    data.resize(count);
+    if(count) std::memcpy(data.data(), in, count*sizeof(T));
+    in += serializedSectionSize(count*sizeof(T));
+}
+
+}
+
+Containers::Array<char> Document::serialize(const Containers::ArrayView<const char> sourceKey) const {
+    CORRADE_ASSERT(_deferred.empty(),
+        "OpenDdl::Document::serialize(): can't serialize a document with deferred structures", {});
+
+    SerializedHeader header{};
+    std::memcpy(header.magic, SerializedMagic, sizeof(SerializedMagic));
+    header.version = SerializedVersion;
+    header.byteOrder = 0x0102;
+    header.sizeofSize = sizeof(std::size_t);
+    header.sizeofProperty = sizeof(PropertyData);
+    header.sizeofStructure = sizeof(StructureData);
+    header.identifierHash = hashIdentifiers(_structureIdentifiers, _propertyIdentifiers);
+    Utility::Sha1 sha1;
+    sha1 << sourceKey;
+    std::memcpy(header.sourceDigest, sha1.digest().data(), sizeof(header.sourceDigest));
+
+    std::size_t stringDataSize = 0;
+    for(const std::string& string: _strings) stringDataSize += string.size();
+
+    header.counts[SerializedBools] = _bools.size();
+    header.counts[SerializedUnsignedBytes] = _unsignedBytes.size();
+    header.counts[SerializedBytes] = _bytes.size();
+    header.counts[SerializedUnsignedShorts] = _unsignedShorts.size();
+    header.counts[SerializedShorts] = _shorts.size();
+    header.counts[SerializedUnsignedInts] = _unsignedInts.size();
+    header.counts[SerializedInts] = _ints.size();
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    header.counts[SerializedUnsignedLongs] = _unsignedLongs.size();
+    header.counts[SerializedLongs] = _longs.size();
+    #endif
+    header.counts[SerializedFloats] = _floats.size();
+    header.counts[SerializedDoubles] = _doubles.size();
+    header.counts[SerializedStringSizes] = _strings.size();
+    header.counts[SerializedStringData] = stringDataSize;
+    header.counts[SerializedReferences] = _references.size();
+    header.counts[SerializedTypes] = _types.size();
+    header.counts[SerializedProperties] = _properties.size();
+    header.counts[SerializedStructures] = _structures.size();
+
+    Containers::Array<char> out{Containers::ValueInit, std::size_t(serializedSize(header))};
+    char* o = out.data();
+    std::memcpy(o, &header, sizeof(SerializedHeader));
+    o += serializedSectionSize(sizeof(SerializedHeader));
+
+    /* std::vector<bool> has no contiguous storage, one byte per value */
+    for(std::size_t i = 0; i != _bools.size(); ++i) o[i] = _bools[i];
+    o += serializedSectionSize(_bools.size());
+    serializeSection(o, _unsignedBytes);
+    serializeSection(o, _bytes);
+    serializeSection(o, _unsignedShorts);
+    serializeSection(o, _shorts);
+    serializeSection(o, _unsignedInts);
+    serializeSection(o, _ints);
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    serializeSection(o, _unsignedLongs);
+    serializeSection(o, _longs);
+    #endif
+    serializeSection(o, _floats);
+    serializeSection(o, _doubles);
+
+    /* String sizes first, then all string data concatenated */
+    for(std::size_t i = 0; i != _strings.size(); ++i) {
+        const UnsignedLong size = _strings[i].size();
+        std::memcpy(o + i*sizeof(UnsignedLong), &size, sizeof(UnsignedLong));
+    }
+    o += serializedSectionSize(_strings.size()*sizeof(UnsignedLong));
+    char* stringData = o;
+    for(const std::string& string: _strings) {
+        std::memcpy(stringData, string.data(), string.size());
+        stringData += string.size();
+    }
+    o += serializedSectionSize(stringDataSize);
+
+    serializeSection(o, _references);
+    serializeSection(o, _types);
+    serializeSection(o, _properties);
+    serializeSection(o, _structures);
+    CORRADE_INTERNAL_ASSERT(o == out.end());
+
+    return out;
+}
+
+bool Document::deserialize(const Containers::ArrayView<const char> data, const std::initializer_list<CharacterLiteral> structureIdentifiers, const std::initializer_list<CharacterLiteral> propertyIdentifiers, const Containers::ArrayView<const char> sourceKey) {
+    CORRADE_ASSERT(_structures.empty() && _strings.size() == 1,
+        "OpenDdl::Document::deserialize(): the document is not empty", false);
+
+    if(data.size() < sizeof(SerializedHeader)) {
+        Error() << "OpenDdl::Document::deserialize(): expected at least" << sizeof(SerializedHeader) << "bytes but got" << data.size();
+        return false;
+    }
+
+    SerializedHeader header;
+    std::memcpy(&header, data.data(), sizeof(SerializedHeader));
+    if(std::memcmp(header.magic, SerializedMagic, sizeof(SerializedMagic)) != 0 || header.version != SerializedVersion) {
+        Error() << "OpenDdl::Document::deserialize(): invalid signature or version";
+        return false;
+    }
+
+    if(header.byteOrder != 0x0102 || header.sizeofSize != sizeof(std::size_t) || header.sizeofProperty != sizeof(PropertyData) || header.sizeofStructure != sizeof(StructureData)
+        #ifdef CORRADE_TARGET_EMSCRIPTEN
+        || header.counts[SerializedUnsignedLongs] || header.counts[SerializedLongs]
+        #endif
+    ) {
+        Error() << "OpenDdl::Document::deserialize(): data serialized on an incompatible platform";
+        return false;
+    }
+
+    if(header.identifierHash != hashIdentifiers({structureIdentifiers.begin(), structureIdentifiers.size()}, {propertyIdentifiers.begin(), propertyIdentifiers.size()})) {
+        Error() << "OpenDdl::Document::deserialize(): data serialized with different identifiers";
+        return false;
+    }
+
+    {
+        Utility::Sha1 sha1;
+        sha1 << sourceKey;
+        if(std::memcmp(header.sourceDigest, sha1.digest().data(), sizeof(header.sourceDigest)) != 0) {
+            Error() << "OpenDdl::Document::deserialize(): data serialized from a different source";
+            return false;
+        }
+    }
+
+    /* Every item takes at least one byte, so a count larger than the data
+       size is invalid. Checking this first also prevents the size
+       calculation from overflowing. */
+    if(!std::all_of(std::begin(header.counts), std::end(header.counts), [&data](UnsignedLong count) { return count <= data.size(); }) || data.size() != serializedSize(header)) {
+        Error() << "OpenDdl::Document::deserialize(): section sizes don't match data size" << data.size();
+        return false;
+    }
+
+    /* The string sizes are after all numeric sections. Check that they match
+       the string data before filling anything. The first string is the
+       empty name reserved in the constructor. */
+    const char* in = data.data() + serializedSectionSize(sizeof(SerializedHeader));
+    const char* stringSizes = in;
+    for(std::size_t i = SerializedBools; i != SerializedStringSizes; ++i)
+        stringSizes += serializedSize(header, SerializedSection(i));
+    const std::size_t stringCount = header.counts[SerializedStringSizes];
+    const char* const stringDataBegin = stringSizes + serializedSize(header, SerializedStringSizes);
+    {
+        bool valid = stringCount != 0;
+        UnsignedLong stringDataSize = 0;
+        for(std::size_t i = 0; i != stringCount; ++i) {
+            UnsignedLong size;
+            std::memcpy(&size, stringSizes + i*sizeof(UnsignedLong), sizeof(UnsignedLong));
+            if((i == 0 && size) || size > header.counts[SerializedStringData] - stringDataSize) {
+                valid = false;
+                break;
+            }
+            stringDataSize += size;
+        }
+        if(!valid || stringDataSize != header.counts[SerializedStringData]) {
+            Error() << "OpenDdl::Document::deserialize(): invalid string data";
+            return false;
+        }
+    }
+
+    _bools.resize(header.counts[SerializedBools]);
+    for(std::size_t i = 0; i != _bools.size(); ++i) _bools[i] = in[i];
+    in += serializedSize(header, SerializedBools);
+    deserializeSection(in, _unsignedBytes, header.counts[SerializedUnsignedBytes]);
+    deserializeSection(in, _bytes, header.counts[SerializedBytes]);
+    deserializeSection(in, _unsignedShorts, header.counts[SerializedUnsignedShorts]);
+    deserializeSection(in, _shorts, header.counts[SerializedShorts]);
+    deserializeSection(in, _unsignedInts, header.counts[SerializedUnsignedInts]);
+    deserializeSection(in, _ints, header.counts[SerializedInts]);
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    deserializeSection(in, _unsignedLongs, header.counts[SerializedUnsignedLongs]);
+    deserializeSection(in, _longs, header.counts[SerializedLongs]);
+    #endif
+    deserializeSection(in, _floats, header.counts[SerializedFloats]);
+    deserializeSection(in, _doubles, header.counts[SerializedDoubles]);
+    CORRADE_INTERNAL_ASSERT(in == stringSizes);
+
+    _strings.clear();
+    _strings.reserve(stringCount);
+    const char* stringData = stringDataBegin;
+    for(std::size_t i = 0; i != stringCount; ++i) {
+        UnsignedLong size;
+        std::memcpy(&size, stringSizes + i*sizeof(UnsignedLong), sizeof(UnsignedLong));
+        _strings.emplace_back(stringData, size);
+        stringData += size;
+    }
+    in = stringDataBegin + serializedSize(header, SerializedStringData);
+
+    deserializeSection(in, _references, header.counts[SerializedReferences]);
+    deserializeSection(in, _types, header.counts[SerializedTypes]);
+    /* PropertyData has no default constructor, so it can't be resized */
+    _properties.assign(header.counts[SerializedProperties], PropertyData{0, {}, 0});
+    if(!_properties.empty()) std::memcpy(_properties.data(), in, _properties.size()*sizeof(PropertyData));
+    in += serializedSize(header, SerializedProperties);
+    deserializeSection(in, _structures, header.counts[SerializedStructures]);
+    CORRADE_INTERNAL_ASSERT(in == data.end());
+
+    /* Check that all indices are in bounds so a damaged cache can't cause
+       out-of-bounds reads later. Parents are always before and children and
+       next siblings always after given structure, which also makes sure the
+       hierarchy has no cycles. */
+    const auto inRange = [](const std::size_t begin, const std::size_t size, const std::size_t count) {
+        return size <= count && begin <= count - size;
+    };
+    const auto isValidIdentifier = [](const Int identifier, const std::size_t count) {
+        return identifier == UnknownIdentifier || (identifier >= 0 && std::size_t(identifier) < count);
+    };
+    for(const std::size_t reference: _references) {
+        if(reference != NullReference && reference >= _structures.size()) {
+            Error() << "OpenDdl::Document::deserialize(): invalid reference data";
+            return false;
+        }
+    }
+    for(const Type type: _types) {
+        if(UnsignedInt(type) >= UnsignedInt(Type::Custom)) {
+            Error() << "OpenDdl::Document::deserialize(): invalid type data";
+            return false;
+        }
+    }
+    for(const PropertyData& property: _properties) {
+        /* Unknown property types stay at zero and fail the check */
+        std::size_t count = 0;
+        switch(property.type) {
+            case Implementation::InternalPropertyType::Bool:
+                count = _bools.size();
+                break;
+            case Implementation::InternalPropertyType::Binary:
+            case Implementation::InternalPropertyType::Character:
+            case Implementation::InternalPropertyType::Integral:
+                count = _ints.size();
+                break;
+            case Implementation::InternalPropertyType::Float:
+                count = _floats.size();
+                break;
+            case Implementation::InternalPropertyType::String:
+                count = _strings.size();
+                break;
+            case Implementation::InternalPropertyType::Reference:
+                count = _references.size();
+                break;
+            case Implementation::InternalPropertyType::Type:
+                count = _types.size();
+                break;
+        }
+
+        if(property.position >= count || !isValidIdentifier(property.identifier, propertyIdentifiers.size())) {
+            Error() << "OpenDdl::Document::deserialize(): invalid property data";
+            return false;
+        }
+    }
+    for(std::size_t i = 0; i != _structures.size(); ++i) {
+        const StructureData& structure = _structures[i];
+        bool valid = structure.name < _strings.size() &&
+            (structure.parent == NoParent || structure.parent < i) &&
+            (!structure.next || (structure.next > i && structure.next < _structures.size()));
+
+        if(valid && structure.primitive.type >= Type::Custom) {
+            valid = isValidIdentifier(structure.custom.identifier - Int(Type::Custom), structureIdentifiers.size()) &&
+                inRange(structure.custom.propertiesBegin, structure.custom.propertiesSize, _properties.size()) &&
+                (!structure.custom.firstChild || (structure.custom.firstChild > i && structure.custom.firstChild < _structures.size()));
+        } else if(valid) {
+            std::size_t count{};
+            switch(structure.primitive.type) {
+                #define _c(type, T) \
+                case Type::type: \
+                    count = data<T>().size(); \
+                    break;
+                _c(Bool, bool)
+                _c(UnsignedByte, UnsignedByte)
+                _c(Byte, Byte)
+                _c(UnsignedShort, UnsignedShort)
+                _c(Short, Short)
+                _c(UnsignedInt, UnsignedInt)
+                _c(Int, Int)
+                #ifndef CORRADE_TARGET_EMSCRIPTEN
+                _c(UnsignedLong, UnsignedLong)
+                _c(Long, Long)
+                #endif
+                /** @todo Half */
+                _c(Float, Float)
+                _c(Double, Double)
+                _c(String, std::string)
+                _c(Type, Type)
+                #undef _c
+                case Type::Reference:
+                    count = _references.size();
+                    break;
+                case Type::Custom:
+                    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+            }
+
+            valid = inRange(structure.primitive.begin, structure.primitive.size, count) &&
+                (!structure.primitive.subArraySize || structure.primitive.size % structure.primitive.subArraySize == 0);
+        }
+
+        if(!valid) {
+            Error() << "OpenDdl::Document::deserialize(): invalid structure data";
+            return false;
+        }
+    }
+
+    _structureIdentifiers = {structureIdentifiers.begin(), structureIdentifiers.size()};
+    _propertyIdentifiers = {propertyIdentifiers.begin(), propertyIdentifiers.size()};
+    return true;
+}
+
 const char* Document::parseProperty(const Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, const Int identifier, Implementation::ParseError& error) {
     bool boolValue;
     Int integerValue;
@@ -369,7 +1063,18 @@ const char* Document::parseProperty(const Containers::ArrayView<const char> data
 
 namespace Implementation {
 
+template<class T> void reserveDataList(std::vector<T>& data, const std::size_t count) {
+    /* Grow at least geometrically so a long sequence of tiny lists doesn't
+       reallocate on every one of them */
+    const std::size_t size = data.size() + count;
+    if(size > data.capacity()) data.reserve(std::max(size, data.capacity()*2));
+}
+
 template<> struct ExtractDataListItem<Type::Bool> {
+    static void reserve(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&) {
+        reserveDataList(document.data<bool>(), Implementation::dataListSizeHint(data));
+    }
+
     static const char* extract(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&, std::string&, Implementation::ParseError& error) {
         const char* i;
         bool value;
@@ -380,6 +1085,10 @@ template<> struct ExtractDataListItem<Type::Bool> {
 };
 
 template<class T> struct ExtractIntegralDataListItem {
+    static void reserve(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&) {
+        reserveDataList(document.data<T>(), Implementation::dataListSizeHint(data));
+    }
+
     static const char* extract(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&, std::string& buffer, Implementation::ParseError& error) {
         const char* i;
         T value;
@@ -403,6 +1112,10 @@ _c(Long)
 #undef _c
 
 template<class T> struct ExtractFloatingPointDataListItem {
+    static void reserve(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&) {
+        reserveDataList(document.data<T>(), Implementation::dataListSizeHint(data));
+    }
+
     static const char* extract(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&, std::string& buffer, Implementation::ParseError& error) {
         const char* i;
         T value;
@@ -419,6 +1132,10 @@ _c(Double)
 #undef _c
 
 template<> struct ExtractDataListItem<Type::String> {
+    /* Strings can contain separators and braces, so the size hint would be
+       unreliable. Each item is a separate allocation anyway. */
+    static void reserve(Containers::ArrayView<const char>, Document&, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&) {}
+
     static const char* extract(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&, std::string&, Implementation::ParseError& error) {
         const char* i;
         std::string value;
@@ -429,6 +1146,10 @@ template<> struct ExtractDataListItem<Type::String> {
 };
 
 template<> struct ExtractDataListItem<Type::Reference> {
+    static void reserve(const Containers::ArrayView<const char> data, Document&, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references) {
+        reserveDataList(references, Implementation::dataListSizeHint(data));
+    }
+
     static const char* extract(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string&, Implementation::ParseError& error) {
         const char* i;
         Containers::ArrayView<const char> value;
@@ -441,6 +1162,10 @@ template<> struct ExtractDataListItem<Type::Reference> {
 };
 
 template<> struct ExtractDataListItem<Type::Type> {
+    static void reserve(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&) {
+        reserveDataList(document.data<Type>(), Implementation::dataListSizeHint(data));
+    }
+
     static const char* extract(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&, std::string&, Implementation::ParseError& error) {
         const char* i;
         Type value;
@@ -478,6 +1203,10 @@ template<Type type> std::pair<const char*, std::size_t> dataList(const Container
 }
 
 template<Type type> std::pair<const char*, std::size_t> dataArrayList(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, const std::size_t subArraySize, Implementation::ParseError& error) {
+    /* Make room for all items upfront instead of reallocating the storage
+       repeatedly for long lists */
+    Implementation::ExtractDataListItem<type>::reserve(data, document, references);
+
     if(!subArraySize) return dataList<type>(data, document, references, buffer, error);
 
     const char* i = data;
@@ -725,18 +1454,41 @@ std::pair<const char*, std::size_t> Document::parseStructure(const std::size_t p
         const std::size_t position = _structures.size();
         _structures.emplace_back();
 
+        /* Deferred structure, only find where it ends and remember the
+           contents for parseDeferred(). References inside the contents may
+           point outside of them and names inside may be referenced from
+           elsewhere, neither of which could be resolved later, so such
+           structures are parsed right away. */
+        bool deferred = false;
+        if(std::find(_deferredIdentifiers.begin(), _deferredIdentifiers.end(), structureIdentifierId) != _deferredIdentifiers.end()) {
+            bool hasNames;
+            const char* const end = findListEnd(data.suffix(i), hasNames);
+            if(!end) {
+                error = {Implementation::ParseErrorType::ExpectedListEnd, data.end()};
+                return {};
+            }
+
+            if(!hasNames) {
+                _deferred.emplace_back(position, data.slice(i, end));
+                i = end;
+                deferred = true;
+            }
+        }
+
         /* Substructure */
-        i = parseStructureList(position, data.suffix(i), references, buffer, error);
+        if(!deferred) {
+            i = parseStructureList(position, data.suffix(i), references, buffer, error);
 
-        /* Propagate errors */
-        if(!i) return {};
+            /* Propagate errors */
+            if(!i) return {};
 
-        i = Implementation::whitespace(data.suffix(i));
+            i = Implementation::whitespace(data.suffix(i));
 
-        /* Structure end */
-        if(i == data.end() || *i != '}') {
-            error = {Implementation::ParseErrorType::ExpectedListEnd, i};
-            return {};
+            /* Structure end */
+            if(i == data.end() || *i != '}') {
+                error = {Implementation::ParseErrorType::ExpectedListEnd, i};
+                return {};
+            }
         }
 
         /* First child is implicitly the next one, if no substructures were
@@ -769,6 +1521,42 @@ const char* Document::parseStructureList(const std::size_t parent, const Contain
     return i;
 }
 
+Document& Document::setDeferredStructures(const std::initializer_list<Int> identifiers) {
+    _deferredIdentifiers.assign(identifiers.begin(), identifiers.end());
+    return *this;
+}
+
+Containers::ArrayView<const char> Document::deferredData(const Structure structure) const {
+    CORRADE_ASSERT(&structure._document.get() == this,
+        "OpenDdl::Document::deferredData(): the structure is from a different document", {});
+
+    /* Deferred structures are added in order, so the list is sorted */
+    const std::size_t index = &structure._data.get() - _structures.data();
+    const auto found = std::lower_bound(_deferred.begin(), _deferred.end(), index,
+        [](const std::pair<std::size_t, Containers::ArrayView<const char>>& a, const std::size_t b) {
+            return a.first < b;
+        });
+    if(found == _deferred.end() || found->first != index) return nullptr;
+
+    /* Even a view on empty contents is not null, as it points into the
+       source data */
+    return found->second;
+}
+
+bool Document::isDeferred(const Structure structure) const {
+    return deferredData(structure).data();
+}
+
+bool Document::parseDeferred(const Structure structure, Document& out) const {
+    const Containers::ArrayView<const char> data = deferredData(structure);
+    CORRADE_ASSERT(data.data(),
+        "OpenDdl::Document::parseDeferred(): the structure is not deferred", false);
+
+    out._structureIdentifiers = _structureIdentifiers;
+    out._propertyIdentifiers = _propertyIdentifiers;
+    return out.parseInternal(data, 1);
+}
+
 bool Document::validate(const Validation::Structures allowedRootStructures, const std::initializer_list<Validation::Structure> structures) const {
     std::vector<Int> countsBuffer;
     countsBuffer.reserve(structures.size());
@@ -867,6 +1655,10 @@ bool Document::validateStructure(const Structure structure, const Validation::St
         }
     }
 
+    /* Contents of deferred structures are not parsed yet, they can be
+       validated only after parseDeferred() */
+    if(isDeferred(structure)) return true;
+
     /* Check that there are only primitive sub-structures with required type
        and size and in required amount */
     Int remainingPrimitiveCountAllowed = validation.primitiveCount();
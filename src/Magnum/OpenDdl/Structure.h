@@ -71,6 +71,17 @@ class MAGNUM_OPENDDL_EXPORT Structure {
         /** @brief Non-equality operator */
         bool operator!=(const Structure& other) const { return !operator==(other); }
 
+        /**
+         * @brief Index of the structure in the document
+         *
+         * Unique for all structures in the originating @ref Document, so it
+         * can be used as a key for associating external data with structures
+         * instead of comparing them one by one.
+         */
+        std::size_t index() const {
+            return &_data.get() - _document.get()._structures.data();
+        }
+
         /**
          * @brief Whether the structure is custom
          *
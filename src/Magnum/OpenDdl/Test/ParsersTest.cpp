@@ -23,9 +23,12 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <clocale>
+#include <cmath>
 #include <tuple>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/FormatStl.h>
 
 #include "Magnum/OpenDdl/Document.h"
 #include "Magnum/OpenDdl/Property.h"
@@ -67,6 +70,8 @@ struct ParsersTest: TestSuite::Tester {
 
     void floatLiteralInvalid();
     void floatLiteral();
+    void floatLiteralPrecision();
+    void floatLiteralLocale();
     void floatLiteralBinary();
 
     void stringLiteralInvalid();
@@ -95,6 +100,12 @@ struct ParsersTest: TestSuite::Tester {
     void propertyValueReference();
     void propertyValueReferenceNull();
     void propertyValueType();
+
+    void dataListSizeHint();
+
+    void benchmarkIntegerLiteral();
+    void benchmarkFloatLiteral();
+    void benchmarkDoubleLiteral();
 };
 
 ParsersTest::ParsersTest() {
@@ -129,6 +140,8 @@ ParsersTest::ParsersTest() {
 
               &ParsersTest::floatLiteralInvalid,
               &ParsersTest::floatLiteral,
+              &ParsersTest::floatLiteralPrecision,
+              &ParsersTest::floatLiteralLocale,
               &ParsersTest::floatLiteralBinary,
 
               &ParsersTest::stringLiteralInvalid,
@@ -156,7 +169,33 @@ ParsersTest::ParsersTest() {
               &ParsersTest::propertyValueString,
               &ParsersTest::propertyValueReference,
               &ParsersTest::propertyValueReferenceNull,
-              &ParsersTest::propertyValueType});
+              &ParsersTest::propertyValueType,
+
+              &ParsersTest::dataListSizeHint});
+
+    addBenchmarks({&ParsersTest::benchmarkIntegerLiteral,
+                   &ParsersTest::benchmarkFloatLiteral,
+                   &ParsersTest::benchmarkDoubleLiteral}, 10);
+}
+
+/* Used by the benchmarks, a comma-separated list of given count of numbers
+   similar to what exporters put into OpenGEX files */
+constexpr std::size_t BenchmarkLiteralCount = 100000;
+std::string integerLiterals(const std::size_t count) {
+    std::string out;
+    for(std::size_t i = 0; i != count; ++i) {
+        if(i) out += ", ";
+        out += std::to_string(i*7919 % 1000000);
+    }
+    return out;
+}
+std::string floatLiterals(const std::size_t count) {
+    std::string out;
+    for(std::size_t i = 0; i != count; ++i) {
+        if(i) out += ", ";
+        out += Utility::formatString("{}", (Float(i*7919 % 200000) - 100000.0f)*0.000137f);
+    }
+    return out;
 }
 
 #define VERIFY_PARSED(e, data, i, parsed) \
@@ -394,6 +433,10 @@ void ParsersTest::integerLiteralInvalid() {
 
     CORRADE_VERIFY(!std::get<0>(Implementation::integralLiteral<UnsignedShort>(CharacterLiteral{"-1"}, buffer, error)));
     CORRADE_COMPARE(error.error, Implementation::ParseErrorType::LiteralOutOfRange);
+
+    /* Doesn't fit into 64 bits */
+    CORRADE_VERIFY(!std::get<0>(Implementation::integralLiteral<Int>(CharacterLiteral{"18446744073709551616"}, buffer, error)));
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::LiteralOutOfRange);
 }
 
 void ParsersTest::integerLiteral() {
@@ -473,6 +516,66 @@ void ParsersTest::floatLiteral() {
     CORRADE_COMPARE(value, -1.0e+5);
 }
 
+void ParsersTest::floatLiteralPrecision() {
+    Implementation::ParseError error;
+    std::string buffer;
+
+    /* The simple cases are parsed directly, the rest is delegated to the
+       standard library. Either way the results should be exact. */
+    CORRADE_COMPARE(Implementation::floatingPointLiteral<Float>(CharacterLiteral{"0.1"}, buffer, error).second, 0.1f);
+    CORRADE_COMPARE(Implementation::floatingPointLiteral<Double>(CharacterLiteral{"0.1"}, buffer, error).second, 0.1);
+    CORRADE_COMPARE(Implementation::floatingPointLiteral<Float>(CharacterLiteral{"-0.0"}, buffer, error).second, -0.0f);
+    CORRADE_VERIFY(std::signbit(Implementation::floatingPointLiteral<Float>(CharacterLiteral{"-0.0"}, buffer, error).second));
+    CORRADE_COMPARE(Implementation::floatingPointLiteral<Float>(CharacterLiteral{"3.4028234e38"}, buffer, error).second, 3.4028234e38f);
+    CORRADE_COMPARE(Implementation::floatingPointLiteral<Double>(CharacterLiteral{"1.7976931348623157e308"}, buffer, error).second, 1.7976931348623157e308);
+    CORRADE_COMPARE(Implementation::floatingPointLiteral<Double>(CharacterLiteral{"123456789012345678901234"}, buffer, error).second, 123456789012345678901234.0);
+
+    /* Exactly in the middle between 1.0f and the next float, has to round to
+       the even one */
+    const Float middle = Implementation::floatingPointLiteral<Float>(CharacterLiteral{"1.000000059604644775390625"}, buffer, error).second;
+    CORRADE_VERIFY(middle == 1.0f);
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::NoError);
+
+    /* Exactly in the middle between 16777216.0f and the next float, short
+       enough to be calculated as a double first, which then has to be
+       detected as not exactly roundable to a float */
+    const Float middleShort = Implementation::floatingPointLiteral<Float>(CharacterLiteral{"16777217.0"}, buffer, error).second;
+    CORRADE_VERIFY(middleShort == 16777216.0f);
+
+    /* Slightly below and above the middle between two floats, but the double
+       calculation rounds both to exactly the middle. Converting the double
+       to a float would round both to the even one, which is wrong for the
+       first. */
+    const Float belowMiddle = Implementation::floatingPointLiteral<Float>(CharacterLiteral{"72057624102699e3"}, buffer, error).second;
+    CORRADE_VERIFY(belowMiddle == 72057619807731712.0f);
+    const Float aboveMiddle = Implementation::floatingPointLiteral<Float>(CharacterLiteral{"7205762410269901e1"}, buffer, error).second;
+    CORRADE_VERIFY(aboveMiddle == 72057628397666304.0f);
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::NoError);
+}
+
+void ParsersTest::floatLiteralLocale() {
+    /* Try a few names of a locale that uses a decimal comma, as they differ
+       across platforms */
+    const std::string originalLocale = std::setlocale(LC_NUMERIC, nullptr);
+    if(!std::setlocale(LC_NUMERIC, "de_DE.UTF-8") &&
+       !std::setlocale(LC_NUMERIC, "de_DE") &&
+       !std::setlocale(LC_NUMERIC, "German"))
+        CORRADE_SKIP("No locale with a decimal comma available, cannot test");
+
+    Implementation::ParseError error;
+    std::string buffer;
+
+    /* Both of these are handled by the standard library, which shouldn't
+       pick up the decimal comma */
+    const Float a = Implementation::floatingPointLiteral<Float>(CharacterLiteral{"1.000000059604644775390625"}, buffer, error).second;
+    const Double b = Implementation::floatingPointLiteral<Double>(CharacterLiteral{"0.12345678901234567890123"}, buffer, error).second;
+    std::setlocale(LC_NUMERIC, originalLocale.data());
+
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::NoError);
+    CORRADE_VERIFY(a == 1.0f);
+    CORRADE_COMPARE(b, 0.12345678901234567890123);
+}
+
 void ParsersTest::floatLiteralBinary() {
     CharacterLiteral a{"-0xbad_cafe_X"};
 
@@ -815,6 +918,101 @@ void ParsersTest::propertyValueType() {
     CORRADE_COMPARE(typeValue, Type::Float);
 }
 
+void ParsersTest::dataListSizeHint() {
+    CORRADE_COMPARE(Implementation::dataListSizeHint(CharacterLiteral{""}), 0);
+    CORRADE_COMPARE(Implementation::dataListSizeHint(CharacterLiteral{"} float {1, 2}"}), 0);
+    CORRADE_COMPARE(Implementation::dataListSizeHint(CharacterLiteral{"35 }"}), 1);
+    CORRADE_COMPARE(Implementation::dataListSizeHint(CharacterLiteral{"35, 45 }, int16 {1, 2, 3}"}), 2);
+
+    /* Unterminated list counts everything */
+    CORRADE_COMPARE(Implementation::dataListSizeHint(CharacterLiteral{"35, 45,"}), 3);
+
+    /* Subarrays */
+    CORRADE_COMPARE(Implementation::dataListSizeHint(CharacterLiteral{"{0xca, 0xfe}, {0xba, 0xbe} } float {1, 2}"}), 4);
+
+    /* Longer than one SIMD chunk, with the end in the middle of one, right
+       after a subarray end in the same chunk and as the last character of a
+       chunk */
+    CORRADE_COMPARE(Implementation::dataListSizeHint(CharacterLiteral{"1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0} float {1, 2}"}), 9);
+    CORRADE_COMPARE(Implementation::dataListSizeHint(CharacterLiteral{"{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}, {7.0, 8.0, 9.0}} float {1, 2}"}), 9);
+    CORRADE_COMPARE(Implementation::dataListSizeHint(CharacterLiteral{"10, 20, 30, 400} float {1, 2}"}), 4);
+
+    /* Braces and separators in literals and comments are skipped, both in
+       the scalar and the SIMD path */
+    CORRADE_COMPARE(Implementation::dataListSizeHint(CharacterLiteral{"'}', ','}"}), 2);
+    CORRADE_COMPARE(Implementation::dataListSizeHint(CharacterLiteral{"'\\'', 1}"}), 2);
+    CORRADE_COMPARE(Implementation::dataListSizeHint(CharacterLiteral{"1, /* }, */ 2 // },\n, 3}"}), 3);
+    CORRADE_COMPARE(Implementation::dataListSizeHint(CharacterLiteral{"10, 20, 30, 40, 50, '}', 70, 80} float {1, 2}"}), 8);
+
+    /* Unterminated literal or comment counts everything before */
+    CORRADE_COMPARE(Implementation::dataListSizeHint(CharacterLiteral{"35, '}"}), 2);
+    CORRADE_COMPARE(Implementation::dataListSizeHint(CharacterLiteral{"35, /* }"}), 2);
+}
+
+void ParsersTest::benchmarkIntegerLiteral() {
+    const std::string data = integerLiterals(BenchmarkLiteralCount);
+
+    Implementation::ParseError error;
+    std::string buffer;
+    UnsignedLong sum = 0;
+    CORRADE_BENCHMARK(1) {
+        const char* i = data.data();
+        const char* const end = data.data() + data.size();
+        for(std::size_t j = 0; j != BenchmarkLiteralCount; ++j) {
+            UnsignedInt value;
+            Int base;
+            std::tie(i, value, base) = Implementation::integralLiteral<UnsignedInt>({i, std::size_t(end - i)}, buffer, error);
+            sum += value;
+            if(i != end) i += 2;
+        }
+    }
+
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::NoError);
+    CORRADE_VERIFY(sum);
+}
+
+void ParsersTest::benchmarkFloatLiteral() {
+    const std::string data = floatLiterals(BenchmarkLiteralCount);
+
+    Implementation::ParseError error;
+    std::string buffer;
+    Float sum = 0.0f;
+    CORRADE_BENCHMARK(1) {
+        const char* i = data.data();
+        const char* const end = data.data() + data.size();
+        for(std::size_t j = 0; j != BenchmarkLiteralCount; ++j) {
+            Float value;
+            std::tie(i, value) = Implementation::floatingPointLiteral<Float>({i, std::size_t(end - i)}, buffer, error);
+            sum += value;
+            if(i != end) i += 2;
+        }
+    }
+
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::NoError);
+    CORRADE_VERIFY(sum != 0.0f);
+}
+
+void ParsersTest::benchmarkDoubleLiteral() {
+    const std::string data = floatLiterals(BenchmarkLiteralCount);
+
+    Implementation::ParseError error;
+    std::string buffer;
+    Double sum = 0.0;
+    CORRADE_BENCHMARK(1) {
+        const char* i = data.data();
+        const char* const end = data.data() + data.size();
+        for(std::size_t j = 0; j != BenchmarkLiteralCount; ++j) {
+            Double value;
+            std::tie(i, value) = Implementation::floatingPointLiteral<Double>({i, std::size_t(end - i)}, buffer, error);
+            sum += value;
+            if(i != end) i += 2;
+        }
+    }
+
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::NoError);
+    CORRADE_VERIFY(sum != 0.0);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::OpenDdl::Test::ParsersTest)
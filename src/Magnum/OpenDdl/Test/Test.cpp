@@ -23,10 +23,13 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <cstring>
 #include <sstream>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/FormatStl.h>
 
 #include "Magnum/OpenDdl/Document.h"
 #include "Magnum/OpenDdl/Property.h"
@@ -81,6 +84,7 @@ struct Test: TestSuite::Tester {
     void structureProperties();
 
     void structureEquality();
+    void structureIndex();
 
     void validate();
 
@@ -105,6 +109,25 @@ struct Test: TestSuite::Tester {
     void referenceNull();
     void referenceChain();
     void referenceInvalid();
+
+    void parseThreaded();
+    void parseThreadedEmpty();
+    void parseThreadedError();
+
+    void deferred();
+    void deferredThreaded();
+    void deferredUnterminated();
+
+    void serialize();
+    void serializeEmpty();
+    void deserializeInvalid();
+
+    void benchmarkFloatArray();
+    void benchmarkFloatSubArray();
+    void benchmarkManyStructures();
+    void benchmarkManyStructuresThreaded();
+    void benchmarkReferences();
+    void benchmarkDeserialize();
 };
 
 Test::Test() {
@@ -151,6 +174,7 @@ Test::Test() {
               &Test::structureProperties,
 
               &Test::structureEquality,
+              &Test::structureIndex,
 
               &Test::validate,
 
@@ -174,7 +198,52 @@ Test::Test() {
               &Test::referenceInProperty,
               &Test::referenceNull,
               &Test::referenceChain,
-              &Test::referenceInvalid});
+              &Test::referenceInvalid,
+
+              &Test::parseThreaded,
+              &Test::parseThreadedEmpty,
+              &Test::parseThreadedError,
+
+              &Test::deferred,
+              &Test::deferredThreaded,
+              &Test::deferredUnterminated,
+
+              &Test::serialize,
+              &Test::serializeEmpty,
+              &Test::deserializeInvalid});
+
+    addBenchmarks({&Test::benchmarkFloatArray,
+                   &Test::benchmarkFloatSubArray,
+                   &Test::benchmarkManyStructures,
+                   &Test::benchmarkManyStructuresThreaded,
+                   &Test::benchmarkReferences,
+                   &Test::benchmarkDeserialize}, 5);
+}
+
+/* Used by the benchmarks, similar to vertex data in OpenGEX files */
+constexpr std::size_t BenchmarkVectorCount = 100000;
+constexpr std::size_t BenchmarkStructureCount = 100;
+constexpr std::size_t BenchmarkReferenceCount = 10000;
+std::string floatVectors(const bool subArrays, const std::size_t count = BenchmarkVectorCount) {
+    std::string out = subArrays ? "float[3] {\n" : "float {\n";
+    for(std::size_t i = 0; i != count; ++i) {
+        if(i) out += ",\n";
+        out += Utility::formatString(subArrays ? "{{{}, {}, {}}}" : "{}, {}, {}",
+            Float(i % 1000)*0.125f, Float(i % 777)*-0.5f, Float(i % 13)*2.25f);
+    }
+    out += "\n}";
+    return out;
+}
+
+/* Similar to a file with many GeometryObject structures */
+std::string manyStructures() {
+    std::string out;
+    for(std::size_t i = 0; i != BenchmarkStructureCount; ++i) {
+        out += Utility::formatString("Root $structure{} {{\n", i);
+        out += floatVectors(true, BenchmarkVectorCount/BenchmarkStructureCount);
+        out += "\n}\n";
+    }
+    return out;
 }
 
 void Test::primitive() {
@@ -778,6 +847,25 @@ Some {}
     CORRADE_VERIFY(a != b && b != a);
 }
 
+void Test::structureIndex() {
+    Document d;
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = CharacterLiteral{R"oddl(
+Root { Some {} }
+Some {}
+    )oddl"};
+    CORRADE_VERIFY(d.parse(s, structureIdentifiers, propertyIdentifiers));
+
+    /* Same structure gives the same index, different structures different */
+    Structure a = d.firstChildOf(RootStructure);
+    Structure b = a.firstChild();
+    Structure c = d.firstChildOf(SomeStructure);
+    CORRADE_COMPARE(a.index(), d.firstChildOf(RootStructure).index());
+    CORRADE_VERIFY(a.index() != b.index());
+    CORRADE_VERIFY(a.index() != c.index());
+    CORRADE_VERIFY(b.index() != c.index());
+}
+
 void Test::validate() {
     using namespace Validation;
 
@@ -1271,6 +1359,431 @@ Root %root {
         "OpenDdl::Document::parse(): reference %local1%local2 was not found\n");
 }
 
+/* Prints everything that's in a document so documents parsed on a single and
+   multiple threads or deserialized can be compared */
+void dumpStructure(std::ostringstream& out, const Structure s, const std::string& indent) {
+    out << indent << (s.isCustom() ? s.identifier() : Int(s.type())) << " " << s.name();
+
+    if(s.isCustom()) {
+        out << " (";
+        for(const Property p: s.properties()) {
+            out << p.identifier() << "=";
+            if(p.isTypeCompatibleWith(PropertyType::Bool))
+                out << p.as<bool>();
+            else if(p.isTypeCompatibleWith(PropertyType::Int))
+                out << p.as<Int>();
+            else if(p.isTypeCompatibleWith(PropertyType::Float))
+                out << p.as<Float>();
+            else if(p.isTypeCompatibleWith(PropertyType::String))
+                out << p.as<std::string>();
+            else if(p.isTypeCompatibleWith(PropertyType::Reference))
+                out << (p.asReference() ? p.asReference()->name() : "null");
+            else if(p.isTypeCompatibleWith(PropertyType::Type))
+                out << Int(p.as<Type>());
+            out << " ";
+        }
+        out << ")\n";
+
+        for(const Structure child: s.children())
+            dumpStructure(out, child, indent + "  ");
+        return;
+    }
+
+    out << " [" << s.subArraySize() << "] {";
+    switch(s.type()) {
+        case Type::Bool:
+            for(bool v: s.asArray<bool>()) out << v << " ";
+            break;
+        case Type::Int:
+            for(Int v: s.asArray<Int>()) out << v << " ";
+            break;
+        case Type::Float:
+            for(Float v: s.asArray<Float>()) out << v << " ";
+            break;
+        case Type::String:
+            for(const std::string& v: s.asArray<std::string>()) out << v << " ";
+            break;
+        case Type::Reference:
+            if(s.arraySize() == 1)
+                out << (s.asReference() ? s.asReference()->name() : "null");
+            break;
+        default:
+            out << s.arraySize();
+    }
+    out << "}\n";
+}
+
+std::string dump(const Document& d) {
+    std::ostringstream out;
+    for(const Structure s: d.children()) dumpStructure(out, s, {});
+    return out.str();
+}
+
+void Test::parseThreaded() {
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = CharacterLiteral{
+R"oddl(
+ref { $global2 }
+Root %root (some = "a string", boolean = true, reference = $global1) {
+    Root %local1 {
+        int32 %local3 { 1, 2, 3 }
+        string { "hello", "{ braces }" }
+    }
+
+    /* } a comment with a brace */
+    ref { %local1%local3 }
+}
+bool %local4 { true, false }
+Hierarchic (some = '}', reference = %root) {
+    // }
+    float[2] { {1.5, 2.5}, {3.5, -4.5} }
+    type { float }
+}
+Root $global1 {
+    int8 $global2 { 3 }
+    ref { %root%local1 }
+}
+Some (reference = null) {}
+    )oddl"};
+
+    Document expected;
+    CORRADE_VERIFY(expected.parse(s, structureIdentifiers, propertyIdentifiers));
+    const std::string expectedDump = dump(expected);
+
+    for(UnsignedInt threadCount: {2, 3, 4, 7, 16}) {
+        CORRADE_ITERATION(threadCount);
+
+        Document d;
+        CORRADE_VERIFY(d.parse(s, structureIdentifiers, propertyIdentifiers, threadCount));
+        CORRADE_COMPARE(dump(d), expectedDump);
+
+        /* References across chunks point to the same structures */
+        CORRADE_COMPARE(d.firstChildOf(Type::Reference).asReference()->name(), "$global2");
+        CORRADE_COMPARE(d.firstChildOf(RootStructure).propertyOf(ReferenceProperty).asReference()->name(), "$global1");
+    }
+}
+
+void Test::parseThreadedEmpty() {
+    Document d;
+    CORRADE_VERIFY(d.parse(CharacterLiteral{"  // nothing here\n "}, {}, {}, 4));
+    CORRADE_VERIFY(d.isEmpty());
+}
+
+void Test::parseThreadedError() {
+    std::ostringstream out;
+    Error redirectError{&out};
+
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = CharacterLiteral{
+R"oddl(
+Root {}
+Root { float { 1.0 } }
+Root {
+    float { 1.0 2.0 }
+}
+Root { float { 1.0 3.0 } }
+    )oddl"};
+
+    /* The first error in the document is reported, the same as when parsing
+       on a single thread */
+    Document d;
+    CORRADE_VERIFY(!d.parse(s, structureIdentifiers, propertyIdentifiers, 4));
+    CORRADE_COMPARE(out.str(), "OpenDdl::Document::parse(): expected , character on line 5\n");
+}
+
+void Test::deferred() {
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = CharacterLiteral{
+R"oddl(
+Root %a (some = "a") { float { 1.0 } }
+Hierarchic %b (some = "b") {
+    // } a comment with a brace and a $name
+    Root { string { "}{ %c" } }
+}
+Hierarchic %empty {}
+Hierarchic %e { Root { ref { %a } } }
+Root %d (reference = %b) { ref { %a } }
+    )oddl"};
+
+    Document d;
+    d.setDeferredStructures({HierarchicStructure});
+    CORRADE_VERIFY(d.parse(s, structureIdentifiers, propertyIdentifiers));
+    /* Children of deferred structures are not validated, so the empty one
+       passes */
+    {
+        using namespace Validation;
+        CORRADE_VERIFY(d.validate(
+            Structures{{RootStructure, {}},
+                       {HierarchicStructure, {}}},
+            {
+                {RootStructure,
+                     Properties{{SomeProperty, PropertyType::String, OptionalProperty},
+                                {ReferenceProperty, PropertyType::Reference, OptionalProperty}},
+                     Primitives{Type::Float, Type::String, Type::Reference}, 0, 0},
+                {HierarchicStructure,
+                     Properties{{SomeProperty, PropertyType::String, OptionalProperty}},
+                     Structures{{RootStructure, {1, 1}}}}
+            }));
+    }
+
+    /* Deferred structures have their name and properties but no children */
+    const Structure b = d.firstChildOf(HierarchicStructure);
+    CORRADE_VERIFY(d.isDeferred(b));
+    CORRADE_VERIFY(!d.isDeferred(d.firstChildOf(RootStructure)));
+    CORRADE_COMPARE(b.name(), "%b");
+    CORRADE_COMPARE(b.propertyOf(SomeProperty).as<std::string>(), "b");
+    CORRADE_VERIFY(!b.hasChildren());
+
+    /* References to the deferred structure itself work */
+    CORRADE_COMPARE(d.firstChild().findNextOf(RootStructure)->propertyOf(ReferenceProperty).asReference()->name(), "%b");
+
+    Document contents;
+    CORRADE_VERIFY(d.parseDeferred(b, contents));
+    CORRADE_COMPARE(contents.firstChildOf(RootStructure).firstChild().as<std::string>(), "}{ %c");
+
+    /* Empty deferred structure */
+    const Structure empty = *b.findNextOf(HierarchicStructure);
+    CORRADE_VERIFY(d.isDeferred(empty));
+    Document emptyContents;
+    CORRADE_VERIFY(d.parseDeferred(empty, emptyContents));
+    CORRADE_VERIFY(emptyContents.isEmpty());
+
+    /* Structure with a reference inside is parsed right away, as the
+       reference points outside of it */
+    const Structure e = *empty.findNextOf(HierarchicStructure);
+    CORRADE_VERIFY(!d.isDeferred(e));
+    CORRADE_COMPARE(e.firstChildOf(RootStructure).firstChild().asReference()->name(), "%a");
+}
+
+void Test::deferredThreaded() {
+    const std::string data = manyStructures();
+
+    for(UnsignedInt threadCount: {1, 4}) {
+        CORRADE_ITERATION(threadCount);
+
+        Document d;
+        d.setDeferredStructures({RootStructure});
+        CORRADE_VERIFY(d.parse({data.data(), data.size()}, structureIdentifiers, propertyIdentifiers, threadCount));
+
+        std::size_t count = 0;
+        std::size_t size = 0;
+        for(const Structure s: d.children()) {
+            CORRADE_VERIFY(d.isDeferred(s));
+            Document contents;
+            CORRADE_VERIFY(d.parseDeferred(s, contents));
+            size += contents.firstChild().arraySize();
+            ++count;
+        }
+
+        CORRADE_COMPARE(count, BenchmarkStructureCount);
+        CORRADE_COMPARE(size, BenchmarkVectorCount*3);
+    }
+}
+
+void Test::deferredUnterminated() {
+    std::ostringstream out;
+    Error redirectError{&out};
+
+    Document d;
+    d.setDeferredStructures({RootStructure});
+    CORRADE_VERIFY(!d.parse(CharacterLiteral{"Root {\n Root { \"}\" }\n"}, structureIdentifiers, propertyIdentifiers));
+    CORRADE_COMPARE(out.str(), "OpenDdl::Document::parse(): expected } character on line 3\n");
+}
+
+void Test::serialize() {
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = CharacterLiteral{
+R"oddl(
+ref { $global2 }
+Root %root (some = "a string", boolean = true, reference = $global1) {
+    Root %local1 {
+        int32 %local3 { 1, 2, 3 }
+        string { "hello", "", "world" }
+    }
+    ref { %local1%local3 }
+}
+bool %local4 { true, false, true }
+Hierarchic (some = 'a', reference = %root) {
+    float[2] { {1.5, 2.5}, {3.5, -4.5} }
+    type { float }
+    double { 0.25 }
+    unsigned_int8 { 7 }
+}
+Root $global1 {
+    int8 $global2 { 3 }
+    ref { %root%local1 }
+}
+Some (reference = null) {}
+    )oddl"};
+
+    Document expected;
+    CORRADE_VERIFY(expected.parse(s, structureIdentifiers, propertyIdentifiers));
+
+    const Containers::Array<char> data = expected.serialize();
+    CORRADE_VERIFY(!data.empty());
+    CORRADE_COMPARE(data.size() % 8, 0);
+
+    Document d;
+    CORRADE_VERIFY(d.deserialize(data, structureIdentifiers, propertyIdentifiers));
+    CORRADE_COMPARE(dump(d), dump(expected));
+
+    /* References are preserved */
+    CORRADE_COMPARE(d.firstChildOf(Type::Reference).asReference()->name(), "$global2");
+    CORRADE_COMPARE(d.firstChildOf(RootStructure).propertyOf(ReferenceProperty).asReference()->name(), "$global1");
+
+    /* Serializing again gives the same data */
+    CORRADE_COMPARE_AS(d.serialize(), data, TestSuite::Compare::Container);
+
+    /* With a source key, the same key has to be passed to deserialize() */
+    const Containers::Array<char> dataWithSource = expected.serialize(s);
+    Document withSource;
+    CORRADE_VERIFY(withSource.deserialize(dataWithSource, structureIdentifiers, propertyIdentifiers, s));
+    CORRADE_COMPARE(dump(withSource), dump(expected));
+}
+
+void Test::serializeEmpty() {
+    Document expected;
+    const Containers::Array<char> data = expected.serialize();
+
+    Document d;
+    CORRADE_VERIFY(d.deserialize(data, {}, {}));
+    CORRADE_VERIFY(d.isEmpty());
+}
+
+void Test::deserializeInvalid() {
+    Document expected;
+    CORRADE_VERIFY(expected.parse(CharacterLiteral{"Root %a { string { \"hello\" } }"}, structureIdentifiers, propertyIdentifiers));
+    const Containers::Array<char> data = expected.serialize();
+
+    std::ostringstream out;
+    Error redirectError{&out};
+
+    {
+        Document d;
+        CORRADE_VERIFY(!d.deserialize(data.prefix(16), structureIdentifiers, propertyIdentifiers));
+    } {
+        std::string copy{data.data(), data.size()};
+        copy[0] = 'X';
+        Document d;
+        CORRADE_VERIFY(!d.deserialize({copy.data(), copy.size()}, structureIdentifiers, propertyIdentifiers));
+    } {
+        Document d;
+        CORRADE_VERIFY(!d.deserialize(data, {"Root"}, propertyIdentifiers));
+    } {
+        Document d;
+        CORRADE_VERIFY(!d.deserialize(data, structureIdentifiers, propertyIdentifiers, CharacterLiteral{"Root %a {}"}));
+    } {
+        Document d;
+        CORRADE_VERIFY(!d.deserialize(data.prefix(data.size() - 8), structureIdentifiers, propertyIdentifiers));
+    } {
+        /* The last member of the last structure is the index of the next
+           sibling, make it point to itself */
+        std::string copy{data.data(), data.size()};
+        const std::size_t next = 1;
+        std::memcpy(&copy[copy.size() - sizeof(std::size_t)], &next, sizeof(std::size_t));
+        Document d;
+        CORRADE_VERIFY(!d.deserialize({copy.data(), copy.size()}, structureIdentifiers, propertyIdentifiers));
+    }
+
+    CORRADE_COMPARE(out.str(), Utility::formatString(
+        "OpenDdl::Document::deserialize(): expected at least 184 bytes but got 16\n"
+        "OpenDdl::Document::deserialize(): invalid signature or version\n"
+        "OpenDdl::Document::deserialize(): data serialized with different identifiers\n"
+        "OpenDdl::Document::deserialize(): data serialized from a different source\n"
+        "OpenDdl::Document::deserialize(): section sizes don't match data size {}\n"
+        "OpenDdl::Document::deserialize(): invalid structure data\n",
+        data.size() - 8));
+}
+
+void Test::benchmarkFloatArray() {
+    const std::string data = floatVectors(false);
+
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(1) {
+        Document d;
+        d.parse({data.data(), data.size()}, {}, {});
+        size += d.firstChild().arraySize();
+    }
+
+    CORRADE_COMPARE(size, BenchmarkVectorCount*3);
+}
+
+void Test::benchmarkFloatSubArray() {
+    const std::string data = floatVectors(true);
+
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(1) {
+        Document d;
+        d.parse({data.data(), data.size()}, {}, {});
+        size += d.firstChild().arraySize();
+    }
+
+    CORRADE_COMPARE(size, BenchmarkVectorCount*3);
+}
+
+void Test::benchmarkManyStructures() {
+    const std::string data = manyStructures();
+
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(1) {
+        Document d;
+        d.parse({data.data(), data.size()}, structureIdentifiers, propertyIdentifiers);
+        for(const Structure s: d.children()) size += s.firstChild().arraySize();
+    }
+
+    CORRADE_COMPARE(size, BenchmarkVectorCount*3);
+}
+
+void Test::benchmarkManyStructuresThreaded() {
+    const std::string data = manyStructures();
+
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(1) {
+        Document d;
+        d.parse({data.data(), data.size()}, structureIdentifiers, propertyIdentifiers, 0);
+        for(const Structure s: d.children()) size += s.firstChild().arraySize();
+    }
+
+    CORRADE_COMPARE(size, BenchmarkVectorCount*3);
+}
+
+void Test::benchmarkReferences() {
+    /* Named structures, each referencing the previous one, and a list
+       referencing all of them at the end */
+    std::string data;
+    for(std::size_t i = 0; i != BenchmarkReferenceCount; ++i)
+        data += Utility::formatString("Root $structure{} {{ ref {{ {} }} }}\n", i, i ? Utility::formatString("$structure{}", i - 1) : "null");
+    data += "ref {";
+    for(std::size_t i = 0; i != BenchmarkReferenceCount; ++i)
+        data += Utility::formatString("{}$structure{}", i ? ", " : " ", i);
+    data += " }\n";
+
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(1) {
+        Document d;
+        d.parse({data.data(), data.size()}, structureIdentifiers, propertyIdentifiers);
+        size += d.firstChildOf(Type::Reference).arraySize();
+    }
+
+    CORRADE_COMPARE(size, BenchmarkReferenceCount);
+}
+
+void Test::benchmarkDeserialize() {
+    const std::string source = manyStructures();
+    Document parsed;
+    CORRADE_VERIFY(parsed.parse({source.data(), source.size()}, structureIdentifiers, propertyIdentifiers));
+    const Containers::Array<char> data = parsed.serialize();
+
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(1) {
+        Document d;
+        d.deserialize(data, structureIdentifiers, propertyIdentifiers);
+        for(const Structure s: d.children()) size += s.firstChild().arraySize();
+    }
+
+    CORRADE_COMPARE(size, BenchmarkVectorCount*3);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::OpenDdl::Test::Test)
@@ -27,9 +27,10 @@
 */
 
 #include "AssimpImporter.h"
+#include "FlatHierarchy.h"
 
 #include <unordered_map>
-#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
@@ -41,7 +42,6 @@
 #include <Magnum/Math/Vector.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/PixelStorage.h>
-#include <Magnum/Trade/ArrayAllocator.h>
 #include <Magnum/Trade/CameraData.h>
 #include <Magnum/Trade/ImageData.h>
 #include <Magnum/Trade/LightData.h>
@@ -51,6 +51,7 @@
 #include <Magnum/Trade/SceneData.h>
 #include <Magnum/Trade/TextureData.h>
 #include <MagnumPlugins/AnyImageImporter/AnyImageImporter.h>
+#include <MagnumPlugins/Implementation/parallelFor.h>
 
 #include <assimp/postprocess.h>
 #include <assimp/DefaultLogger.hpp>
@@ -60,6 +61,35 @@
 #include <assimp/Logger.hpp>
 #include <assimp/scene.h>
 
+/* Memory-mapping is needed for the mapFiles option */
+#if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+#define MAGNUM_ASSIMPIMPORTER_MAP_FILES
+#endif
+
+/* The postprocess cache additionally needs the Assimp exporter for writing
+   the cached scene */
+#if defined(MAGNUM_ASSIMPIMPORTER_MAP_FILES) && !defined(ASSIMP_BUILD_NO_EXPORT)
+#define MAGNUM_ASSIMPIMPORTER_POSTPROCESS_CACHE
+#include <atomic>
+#include <cstdio>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Sha1.h>
+#include <assimp/Exporter.hpp>
+#include <assimp/version.h>
+#ifdef CORRADE_TARGET_WINDOWS
+#define WIN32_LEAN_AND_MEAN 1
+#define VC_EXTRALEAN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <Corrade/Utility/Unicode.h>
+#else
+#include <unistd.h>
+#endif
+#endif
+
 namespace Magnum { namespace Math { namespace Implementation {
 
 template<> struct VectorConverter<3, Float, aiColor3D> {
@@ -86,6 +116,12 @@ struct AssimpImporter::File {
     std::vector<std::pair<const aiMaterial*, aiTextureType>> images;
 
     std::unordered_map<const aiNode*, UnsignedInt> nodeIndices;
+    /* Index of the first child of each node in `nodes`, the children follow
+       each other */
+    std::vector<std::size_t> nodeChildOffsets;
+    /* Maps node names to the first object of given node, for nodes with the
+       same name the first in breadth-first order wins */
+    std::unordered_map<std::string, UnsignedInt> objectsForName;
     std::unordered_map<const aiNode*, std::pair<Trade::ObjectInstanceType3D, UnsignedInt>> nodeInstances;
     std::unordered_map<std::string, UnsignedInt> materialIndicesForName;
     std::unordered_map<const aiMaterial*, UnsignedInt> textureIndices;
@@ -121,6 +157,9 @@ void fillDefaultConfiguration(Utility::ConfigurationGroup& conf) {
     /** @todo horrible workaround, fix this properly */
 
     conf.setValue("ImportColladaIgnoreUpDirection", false);
+    conf.setValue("mapFiles", false);
+    conf.setValue("postprocessCache", "");
+    conf.setValue("meshThreads", 1);
 
     Utility::ConfigurationGroup& postprocess = *conf.addGroup("postprocess");
     postprocess.setValue("JoinIdenticalVertices", true);
@@ -235,6 +274,48 @@ struct IoSystem: Assimp::IOSystem {
     void* _userData;
 };
 
+#ifdef MAGNUM_ASSIMPIMPORTER_MAP_FILES
+/* Owns the memory-mapped file, the view in the base is pointing to it */
+struct MappedIoStream: IoStream {
+    explicit MappedIoStream(std::string filename, Containers::Array<const char, Utility::Directory::MapDeleter>&& data): IoStream{std::move(filename), data}, _mapped{std::move(data)} {}
+
+    private:
+        Containers::Array<const char, Utility::Directory::MapDeleter> _mapped;
+};
+
+/* Memory-maps the files instead of letting Assimp read them into a newly
+   allocated memory. Assimp loaders sometimes delete the streams directly
+   instead of going through Close(), so the stream has to unmap the file on
+   its own. */
+struct MapIoSystem: Assimp::IOSystem {
+    bool Exists(const char* file) const override {
+        return Utility::Directory::exists(file);
+    }
+
+    char getOsSeparator() const override { return '/'; }
+
+    Assimp::IOStream* Open(const char* file, const char* mode) override {
+        CORRADE_INTERNAL_ASSERT(mode == std::string{"rb"});
+        #ifdef CORRADE_NO_ASSERT
+        static_cast<void>(mode);
+        #endif
+        /* Assimp treats a null stream as not found and prints its own
+           message, so silence the one from mapRead() */
+        Containers::Array<const char, Utility::Directory::MapDeleter> data;
+        {
+            Error redirectError{nullptr};
+            data = Utility::Directory::mapRead(file);
+        }
+        if(!data) return {};
+        return new MappedIoStream{file, std::move(data)};
+    }
+
+    void Close(Assimp::IOStream* file) override {
+        delete file;
+    }
+};
+#endif
+
 }
 
 void AssimpImporter::doSetFlags(const ImporterFlags flags) {
@@ -388,7 +469,9 @@ void AssimpImporter::doOpenData(const Containers::ArrayView<const char> data) {
         for(std::size_t i = 0; i < _f->nodes.size(); ++i) {
             aiNode* node = _f->nodes[i];
             _f->nodeIndices[node] = UnsignedInt(i);
+            _f->objectsForName.emplace(node->mName.C_Str(), _f->objectMap.size());
 
+            _f->nodeChildOffsets.push_back(_f->nodes.size());
             _f->nodes.insert(_f->nodes.end(), node->mChildren, node->mChildren + node->mNumChildren);
 
             _f->objectMap.emplace_back(i, 0);
@@ -428,18 +511,133 @@ void AssimpImporter::doOpenState(const void* state, const std::string& filePath)
     doOpenData({});
 }
 
+namespace {
+
+#ifdef MAGNUM_ASSIMPIMPORTER_POSTPROCESS_CACHE
+/* Cache file name for given file contents and everything else that affects
+   the imported scene. Returns an empty string if the file can't be read. */
+std::string postprocessCacheFilename(const std::string& filename, const std::string& cacheDirectory, const UnsignedInt flags, const bool importColladaIgnoreUpDirection) {
+    Containers::Array<const char, Utility::Directory::MapDeleter> data;
+    {
+        /* Assimp reports a missing file on its own later */
+        Error redirectError{nullptr};
+        data = Utility::Directory::mapRead(filename);
+    }
+    if(!data) return {};
+
+    /* The Assimp version is included as the postprocessing results and the
+       binary format may change between versions */
+    Utility::Sha1 sha1;
+    sha1 << data << Utility::formatString("{}.{}.{}:{}",
+        aiGetVersionMajor(), aiGetVersionMinor(), aiGetVersionRevision(),
+        UnsignedInt(importColladaIgnoreUpDirection));
+    return Utility::Directory::join(cacheDirectory,
+        Utility::formatString("{}-{:.8x}.assbin", sha1.digest().hexString(), flags));
+}
+
+/* Writes the data to a temporary file in the same directory and renames it
+   over the destination. Other processes sharing the cache directory thus see
+   either the previous cache file or the complete new one, never a partially
+   written file. The temporary name is unique across processes and across
+   importer instances in the same process. */
+bool writePostprocessCache(const std::string& cacheFilename, const Containers::ArrayView<const char> data) {
+    static std::atomic<UnsignedInt> counter{0};
+    #ifdef CORRADE_TARGET_WINDOWS
+    const unsigned long processId = GetCurrentProcessId();
+    #else
+    const unsigned long processId = getpid();
+    #endif
+    const std::string temporaryFilename = Utility::formatString("{}.{}-{}.tmp", cacheFilename, processId, counter++);
+
+    /* Directory::write() prints a message on its own */
+    if(!Utility::Directory::write(temporaryFilename, data)) return false;
+
+    #ifdef CORRADE_TARGET_WINDOWS
+    const bool moved = MoveFileExW(Utility::Unicode::widen(temporaryFilename).data(), Utility::Unicode::widen(cacheFilename).data(), MOVEFILE_REPLACE_EXISTING);
+    #else
+    const bool moved = std::rename(temporaryFilename.data(), cacheFilename.data()) == 0;
+    #endif
+    if(!moved) {
+        Error{} << "Trade::AssimpImporter::openFile(): can't move the postprocess cache to" << cacheFilename;
+        Utility::Directory::rm(temporaryFilename);
+        return false;
+    }
+
+    return true;
+}
+#endif
+
+}
+
 void AssimpImporter::doOpenFile(const std::string& filename) {
     if(!_importer) _importer = createImporter(configuration());
 
     _f.reset(new File);
     _f->filePath = Utility::Directory::path(filename);
 
-    /* File callbacks are set up in doSetFileCallback() */
-    if(!(_f->scene = _importer->ReadFile(filename, flagsFromConfiguration(configuration())))) {
+    const UnsignedInt flags = flagsFromConfiguration(configuration());
+
+    /* Use the postprocess cache, if enabled. With file callbacks the file
+       contents can't be hashed upfront, so it's not used there. */
+    #ifdef MAGNUM_ASSIMPIMPORTER_POSTPROCESS_CACHE
+    const std::string cacheDirectory = configuration().value("postprocessCache");
+    std::string cacheFilename;
+    if(!cacheDirectory.empty() && !fileCallback()) {
+        cacheFilename = postprocessCacheFilename(filename, cacheDirectory, flags, configuration().value<bool>("ImportColladaIgnoreUpDirection"));
+        if(!cacheFilename.empty() && Utility::Directory::exists(cacheFilename)) {
+            /* The scene is already postprocessed, so no flags. An invalid
+               cache is not an error, the file gets imported and the cache
+               replaced below. */
+            {
+                Error redirectError{nullptr};
+                const Containers::Array<const char, Utility::Directory::MapDeleter> data = Utility::Directory::mapRead(cacheFilename);
+                if(data) _f->scene = _importer->ReadFileFromMemory(data.data(), data.size(), 0, "assbin");
+            }
+
+            if(_f->scene) {
+                doOpenData({});
+                return;
+            }
+        }
+    }
+    #endif
+
+    /* File callbacks are set up in doSetFileCallback(). If there's none and
+       the files should be memory-mapped, temporarily replace Assimp's
+       default IO handler. */
+    #ifdef MAGNUM_ASSIMPIMPORTER_MAP_FILES
+    Containers::Pointer<MapIoSystem> mapIoSystem;
+    if(configuration().value<bool>("mapFiles") && !fileCallback()) {
+        mapIoSystem.emplace();
+        _importer->SetIOHandler(mapIoSystem.get());
+    }
+    #endif
+
+    _f->scene = _importer->ReadFile(filename, flags);
+
+    /* Passing nullptr to Assimp doesn't delete the previous IOSystem
+       instance, which is what we want here as it's owned by us */
+    #ifdef MAGNUM_ASSIMPIMPORTER_MAP_FILES
+    if(mapIoSystem) _importer->SetIOHandler(nullptr);
+    #endif
+
+    if(!_f->scene) {
         Error{} << "Trade::AssimpImporter::openFile(): failed to open" << filename << Debug::nospace << ":" << _importer->GetErrorString();
         return;
     }
 
+    /* Save the postprocessed scene into the cache. Failing to write it is not
+       fatal, a message is printed but the import continues. */
+    #ifdef MAGNUM_ASSIMPIMPORTER_POSTPROCESS_CACHE
+    if(!cacheFilename.empty()) {
+        Assimp::Exporter exporter;
+        if(const aiExportDataBlob* const blob = exporter.ExportToBlob(_f->scene, "assbin")) {
+            if(Utility::Directory::mkpath(cacheDirectory))
+                writePostprocessCache(cacheFilename, Containers::arrayView(static_cast<const char*>(blob->data), blob->size));
+        } else Warning{} << "Trade::AssimpImporter::openFile(): can't save the postprocess cache:" << exporter.GetErrorString();
+    }
+    #endif
+
     doOpenData({});
 }
 
@@ -484,8 +682,8 @@ UnsignedInt AssimpImporter::doObject3DCount() const {
 }
 
 Int AssimpImporter::doObject3DForName(const std::string& name) {
-    const aiNode* found = _f->scene->mRootNode->FindNode(aiString(name));
-    return found ? _f->nodeMap[_f->nodeIndices[found]] : -1;
+    const auto found = _f->objectsForName.find(name);
+    return found != _f->objectsForName.end() ? found->second : -1;
 }
 
 std::string AssimpImporter::doObject3DName(const UnsignedInt id) {
@@ -510,8 +708,8 @@ Containers::Pointer<ObjectData3D> AssimpImporter::doObject3D(const UnsignedInt i
         for(std::size_t i = 0; i != extraChildrenCount; ++i)
             children.push_back(_f->nodeMap[nodeId] + i + 1);
 
-        for(auto child: Containers::arrayView(node->mChildren, node->mNumChildren))
-            children.push_back(_f->nodeMap[_f->nodeIndices[child]]);
+        for(std::size_t i = 0; i != node->mNumChildren; ++i)
+            children.push_back(_f->nodeMap[_f->nodeChildOffsets[nodeId] + i]);
 
         /* aiMatrix4x4 is always row-major, transpose. Pre-multiply top-level
            nodes (which are direct children of assimp root node) with root node
@@ -553,6 +751,62 @@ Containers::Pointer<ObjectData3D> AssimpImporter::doObject3D(const UnsignedInt i
     }
 }
 
+AssimpImporter::FlatHierarchy AssimpImporter::flatHierarchy() {
+    CORRADE_ASSERT(isOpened(), "Trade::AssimpImporter::flatHierarchy(): no file opened", {});
+
+    const std::size_t count = _f->objectMap.size();
+
+    FlatHierarchy out;
+    out.parents = Containers::Array<Int>{Containers::DirectInit, count, -1};
+    out.transformations = Containers::Array<Matrix4>{Containers::ValueInit, count};
+    out.meshes = Containers::Array<Int>{Containers::DirectInit, count, -1};
+    out.materials = Containers::Array<Int>{Containers::DirectInit, count, -1};
+    out.cameras = Containers::Array<Int>{Containers::DirectInit, count, -1};
+    out.lights = Containers::Array<Int>{Containers::DirectInit, count, -1};
+
+    /* The nodes are in breadth-first order of the hierarchy under
+       mRootNode, so this is a single traversal of it */
+    for(std::size_t i = 0; i != _f->nodes.size(); ++i) {
+        const aiNode* node = _f->nodes[i];
+        const std::size_t id = _f->nodeMap[i];
+
+        /* Same as in doObject3D() */
+        out.transformations[id] = Matrix4::from(reinterpret_cast<const float*>(&node->mTransformation)).transposed();
+        if(node->mParent == _f->scene->mRootNode)
+            out.transformations[id] = _f->rootTransformation*out.transformations[id];
+
+        /* Extra objects added for multi-mesh nodes are children of the node
+           with identity transformation, each referencing one mesh */
+        for(std::size_t j = 0; j != node->mNumMeshes; ++j) {
+            out.meshes[id + j] = node->mMeshes[j];
+            out.materials[id + j] = _f->scene->mMeshes[node->mMeshes[j]]->mMaterialIndex;
+            if(j) out.parents[id + j] = Int(id);
+        }
+
+        for(std::size_t j = 0; j != node->mNumChildren; ++j)
+            out.parents[_f->nodeMap[_f->nodeChildOffsets[i] + j]] = Int(id);
+    }
+
+    /* Cameras and lights are attached to nodes by name in doOpenData(), go
+       through the few that were found */
+    for(const auto& instance: _f->nodeInstances) {
+        const ObjectInstanceType3D type = instance.second.first;
+        if(type == ObjectInstanceType3D::Mesh) continue;
+
+        /* The root node is not among the objects if it has children */
+        const auto found = _f->nodeIndices.find(instance.first);
+        if(found == _f->nodeIndices.end()) continue;
+
+        const std::size_t id = _f->nodeMap[found->second];
+        if(type == ObjectInstanceType3D::Camera)
+            out.cameras[id] = instance.second.second;
+        else if(type == ObjectInstanceType3D::Light)
+            out.lights[id] = instance.second.second;
+    }
+
+    return out;
+}
+
 UnsignedInt AssimpImporter::doLightCount() const {
     return _f->scene->mNumLights;
 }
@@ -582,6 +836,24 @@ UnsignedInt AssimpImporter::doMeshCount() const {
     return _f->scene->mNumMeshes;
 }
 
+namespace {
+
+/* Flattens per-face index arrays of a known constant size into a single
+   array. The size being a compile-time constant lets the inner loop get
+   unrolled. */
+template<UnsignedInt size> void copyFaceIndices(const Containers::ArrayView<const aiFace> faces, const Containers::ArrayView<UnsignedInt> out) {
+    CORRADE_INTERNAL_ASSERT(out.size() == faces.size()*size);
+    UnsignedInt* dst = out.data();
+    for(const aiFace& face: faces) {
+        CORRADE_ASSERT(face.mNumIndices == size, "Trade::AssimpImporter::mesh(): expected" << size << "indices per face but got" << face.mNumIndices, );
+        const unsigned int* src = face.mIndices;
+        for(UnsignedInt i = 0; i != size; ++i) dst[i] = src[i];
+        dst += size;
+    }
+}
+
+}
+
 Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, UnsignedInt) {
     const aiMesh* mesh = _f->scene->mMeshes[id];
 
@@ -713,24 +985,47 @@ Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, Unsi
     CORRADE_INTERNAL_ASSERT(attributeIndex == attributeCount);
 
     /* Import indices. There doesn't seem to be any shortcut to just copy all
-       index data in a single go, so having to iterate over faces. Ugh. */
-    Containers::Array<UnsignedInt> indexData;
-    Containers::arrayReserve<ArrayAllocator>(indexData, mesh->mNumFaces*3);
-    for(std::size_t faceIndex = 0; faceIndex < mesh->mNumFaces; ++faceIndex) {
-        const aiFace& face = mesh->mFaces[faceIndex];
-        CORRADE_ASSERT(face.mNumIndices <= 3, "Trade::AssimpImporter::mesh(): triangulation while loading should have ensured <= 3 vertices per primitive", {});
-
-        Containers::arrayAppend<ArrayAllocator>(indexData, {face.mIndices, face.mNumIndices});
-    }
-
-    MeshIndexData indices{indexData};
+       index data in a single go, as each face has its own index array.
+       However, because the mesh contains just a single primitive type, all
+       faces have the same size, so the output can be allocated upfront and
+       filled with fixed-size copies. */
+    const Containers::ArrayView<const aiFace> faces{mesh->mFaces, mesh->mNumFaces};
+    const UnsignedInt faceSize =
+        primitive == MeshPrimitive::Triangles ? 3 :
+        primitive == MeshPrimitive::Lines ? 2 : 1;
+    Containers::Array<char> indexData{Containers::NoInit, faces.size()*faceSize*sizeof(UnsignedInt)};
+    const Containers::ArrayView<UnsignedInt> indexView = Containers::arrayCast<UnsignedInt>(indexData);
+    if(faceSize == 3) copyFaceIndices<3>(faces, indexView);
+    else if(faceSize == 2) copyFaceIndices<2>(faces, indexView);
+    else copyFaceIndices<1>(faces, indexView);
+
+    MeshIndexData indices{indexView};
     return MeshData{primitive,
-        Containers::arrayAllocatorCast<char, ArrayAllocator>(std::move(indexData)),
-        indices,
+        std::move(indexData), indices,
         std::move(vertexData), std::move(attributeData),
         MeshData::ImplicitVertexCount, mesh};
 }
 
+Containers::Array<Containers::Optional<MeshData>> AssimpImporter::meshBatch(const Containers::ArrayView<const UnsignedInt> ids) {
+    CORRADE_ASSERT(isOpened(), "Trade::AssimpImporter::meshBatch(): no file opened", {});
+    #ifndef CORRADE_NO_ASSERT
+    for(const UnsignedInt id: ids)
+        CORRADE_ASSERT(id < _f->scene->mNumMeshes,
+            "Trade::AssimpImporter::meshBatch(): index" << id << "out of range for" << _f->scene->mNumMeshes << "entries", {});
+    #endif
+
+    /* The scene is not modified after opening and doMesh() only reads from
+       it, so the meshes can be converted in parallel without any
+       synchronization */
+    Containers::Array<Containers::Optional<MeshData>> out{Containers::ValueInit, ids.size()};
+    Magnum::Implementation::parallelFor(configuration().value<UnsignedInt>("meshThreads"), ids.size(), [&](std::size_t i) {
+        out[i] = doMesh(ids[i], 0);
+    });
+
+
+    return out;
+}
+
 UnsignedInt AssimpImporter::doMaterialCount() const { return _f->scene->mNumMaterials; }
 
 Int AssimpImporter::doMaterialForName(const std::string& name) {
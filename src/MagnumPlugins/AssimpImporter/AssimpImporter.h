@@ -197,6 +197,13 @@ with @ref InputFileCallbackPolicy::LoadTemporary and
 @ref InputFileCallbackPolicy::Close is emitted right after the file is fully
 read.
 
+Setting the @cb{.ini} mapFiles @ce
+@ref Trade-AssimpImporter-configuration "configuration option" to
+@cpp true @ce makes @ref openFile() memory-map the opened file and all files
+referenced from it using @ref Utility::Directory::mapRead() instead of letting
+Assimp read them into newly allocated memory. The option is ignored if a file
+callback is set and on platforms without memory-mapping support.
+
 Import of animation data is not supported at the moment.
 
 The importer recognizes @ref ImporterFlag::Verbose, enabling verbose logging
@@ -204,6 +211,23 @@ in Assimp when the flag is enabled. However please note that since Assimp
 handles logging through a global singleton, it's not possible to have different
 verbosity levels in each instance.
 
+@subsection Trade-AssimpImporter-behavior-cache Postprocess cache
+
+Setting the @cb{.ini} postprocessCache @ce
+@ref Trade-AssimpImporter-configuration "configuration option" to a directory
+makes @ref openFile() save the imported and postprocessed scene into that
+directory in the Assimp binary format (`*.assbin`). The cache file name is
+derived from a SHA-1 hash of the file contents, the Assimp version and the
+@cb{.ini} ImportColladaIgnoreUpDirection @ce option, together with the
+@cb{.ini} [postprocess] @ce flags. On subsequent opens of a file with the same
+contents and options, the cache file is memory-mapped and loaded directly,
+skipping the original file parsing and all postprocessing steps. An invalid
+cache is silently replaced. Note that only the opened file is hashed, changes
+in files referenced from it (such as OBJ material libraries) are not detected.
+
+The cache requires Assimp to be built with exporters enabled and is not
+used if a file callback is set or on platforms without memory-mapping support.
+
 @subsection Trade-AssimpImporter-behavior-materials Material import
 
 -   Only materials with shading mode `aiShadingMode_Phong` are supported
@@ -274,6 +298,36 @@ verbosity levels in each instance.
 The mesh is always indexed; positions are always present, normals, colors and
 texture coordinates are optional.
 
+@subsubsection Trade-AssimpImporter-behavior-meshes-parallel Parallel mesh import
+
+The imported `aiScene` is not modified after the file is opened, so
+@ref mesh() can be called from multiple threads at once. Opening and closing
+the file, changing the configuration and @ref image2D(), which reuses a single
+image importer instance, are not safe to be called in parallel with any other
+function.
+
+If you use this class directly (and not through a plugin manager), it's
+possible to import multiple meshes at once using @ref meshBatch(). The meshes
+are converted on @cb{.ini} meshThreads @ce threads. Setting the
+@ref Trade-AssimpImporter-configuration "configuration option" to
+@cpp 0 @ce uses the value of @ref std::thread::hardware_concurrency(),
+@cpp 1 @ce, which is the default, converts everything on the calling thread.
+On @ref CORRADE_TARGET_EMSCRIPTEN "Emscripten" the import is always done on
+the calling thread. The call blocks until all meshes are converted. If set to
+a value other than @cpp 1 @ce, on Linux the *application* has to be linked to
+`pthread` for the threads to be created successfully:
+
+@code{.cmake}
+find_package(Threads REQUIRED)
+target_link_libraries(your-application PRIVATE Threads::Threads)
+@endcode
+
+Assimp itself applies the @cb{.ini} [postprocess] @ce steps to the whole scene
+on the calling thread during @ref openFile() / @ref openData() and doesn't
+provide any public interface for running them on individual meshes, so these
+are not parallelized. Use the @cb{.ini} postprocessCache @ce option described
+in @ref Trade-AssimpImporter-behavior-cache to avoid running them repeatedly.
+
 @subsection Trade-AssimpImporter-behavior-textures Texture import
 
 -   Textures with mapping mode/wrapping `aiTextureMapMode_Decal` are loaded
@@ -292,6 +346,15 @@ texture coordinates are optional.
     such as `PreTransformVertices`, there's sometimes just a single root node.
     In that case the single node is imported as a single @ref object3D()
     instead of being ignored.
+-   @ref object3DForName() uses a name lookup table built when opening the
+    file. If multiple nodes have the same name, the one closest to the root
+    is returned.
+-   If you use this class directly (and not through a plugin manager), the
+    whole object hierarchy can be imported at once using
+    @ref flatHierarchy(), which avoids allocating an @ref ObjectData3D
+    instance for every node. The object IDs are the same as with
+    @ref object3D(). The returned @ref FlatHierarchy structure is defined in
+    a separate `MagnumPlugins/AssimpImporter/FlatHierarchy.h` header.
 
 @section Trade-AssimpImporter-configuration Plugin-specific configuration
 
@@ -334,6 +397,10 @@ importer state methods:
 */
 class MAGNUM_ASSIMPIMPORTER_EXPORT AssimpImporter: public AbstractImporter {
     public:
+        /* Defined in FlatHierarchy.h to not force the Array and Matrix4
+           includes on all users of this header */
+        struct FlatHierarchy;
+
         /**
          * @brief Default constructor
          *
@@ -355,6 +422,37 @@ class MAGNUM_ASSIMPIMPORTER_EXPORT AssimpImporter: public AbstractImporter {
 
         ~AssimpImporter();
 
+        /**
+         * @brief Import multiple meshes in parallel
+         * @param ids       Mesh IDs, each expected to be less than
+         *      @ref meshCount()
+         *
+         * Equivalent to calling @ref mesh() for each ID in @p ids, but with
+         * the meshes converted in parallel. The items are in the same order
+         * as @p ids, failed imports are set to @ref Containers::NullOpt. See
+         * @ref Trade-AssimpImporter-behavior-meshes-parallel for more
+         * information.
+         */
+        Containers::Array<Containers::Optional<MeshData>> meshBatch(Containers::ArrayView<const UnsignedInt> ids);
+
+        /**
+         * @brief Import the whole object hierarchy
+         *
+         * Returns data for all @ref object3DCount() objects in a
+         * structure-of-arrays form, with each array indexed by the object ID,
+         * in a single pass over the node hierarchy. Compared to calling
+         * @ref object3D() for each object, there are no per-object
+         * allocations. Unlike with @ref object3D(), a node referencing both a
+         * mesh and a camera or a light has all of them filled in. Expects
+         * that a file is opened. See
+         * @ref Trade-AssimpImporter-behavior-scene for more information.
+         *
+         * The @ref FlatHierarchy structure is defined in
+         * @ref MagnumPlugins/AssimpImporter/FlatHierarchy.h, include it in
+         * order to use this function.
+         */
+        FlatHierarchy flatHierarchy();
+
     private:
         struct File;
 
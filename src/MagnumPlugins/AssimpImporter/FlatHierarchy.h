@@ -0,0 +1,93 @@
+#ifndef Magnum_Trade_AssimpImporter_FlatHierarchy_h
+#define Magnum_Trade_AssimpImporter_FlatHierarchy_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+    Copyright © 2017 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Struct @ref Magnum::Trade::AssimpImporter::FlatHierarchy
+ */
+
+#include <Corrade/Containers/Array.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "MagnumPlugins/AssimpImporter/AssimpImporter.h"
+
+namespace Magnum { namespace Trade {
+
+/**
+ * @brief Flat object hierarchy
+ *
+ * @see @ref AssimpImporter::flatHierarchy()
+ */
+struct AssimpImporter::FlatHierarchy {
+    /**
+     * @brief Parent object IDs
+     *
+     * Set to @cpp -1 @ce for objects that don't have a parent.
+     */
+    Containers::Array<Int> parents;
+
+    /**
+     * @brief Object transformations
+     *
+     * Relative to the parent. Top-level objects have the root node
+     * transformation applied, same as with
+     * @ref AssimpImporter::object3D().
+     */
+    Containers::Array<Matrix4> transformations;
+
+    /**
+     * @brief Mesh IDs
+     *
+     * Set to @cpp -1 @ce for objects that don't reference a mesh.
+     */
+    Containers::Array<Int> meshes;
+
+    /**
+     * @brief Material IDs
+     *
+     * Set to @cpp -1 @ce for objects that don't reference a mesh.
+     */
+    Containers::Array<Int> materials;
+
+    /**
+     * @brief Camera IDs
+     *
+     * Set to @cpp -1 @ce for objects that don't reference a camera.
+     */
+    Containers::Array<Int> cameras;
+
+    /**
+     * @brief Light IDs
+     *
+     * Set to @cpp -1 @ce for objects that don't reference a light.
+     */
+    Containers::Array<Int> lights;
+};
+
+}}
+
+#endif
@@ -26,6 +26,7 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <algorithm>
 #include <sstream>
 #include <unordered_map>
 #include <Corrade/Containers/Array.h>
@@ -62,6 +63,11 @@
 
 #include "configure.h"
 
+#ifndef ASSIMPIMPORTER_PLUGIN_FILENAME
+#include "MagnumPlugins/AssimpImporter/AssimpImporter.h"
+#include "MagnumPlugins/AssimpImporter/FlatHierarchy.h"
+#endif
+
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
 using namespace Math::Literals;
@@ -71,6 +77,9 @@ struct AssimpImporterTest: TestSuite::Tester {
 
     void openFile();
     void openFileFailed();
+    void openFileMapFiles();
+    void openFileMapFilesFailed();
+    void openFilePostprocessCache();
     void openData();
     void openDataFailed();
 
@@ -90,11 +99,13 @@ struct AssimpImporterTest: TestSuite::Tester {
     void pointMesh();
     void lineMesh();
     void meshMultiplePrimitives();
+    void meshBatch();
 
     void emptyCollada();
     void emptyGltf();
     void scene();
     void sceneCollapsedNode();
+    void flatHierarchy();
     void upDirectionPatching();
     void upDirectionPatchingPreTransformVertices();
 
@@ -119,6 +130,9 @@ struct AssimpImporterTest: TestSuite::Tester {
     void fileCallbackImage();
     void fileCallbackImageNotFound();
 
+    void benchmarkMeshBatch();
+    void benchmarkHierarchy();
+
     /* Needs to load AnyImageImporter from system-wide location */
     PluginManager::Manager<AbstractImporter> _manager;
 };
@@ -152,11 +166,93 @@ constexpr struct {
     {"Z up, ignored", "z-up.dae", true, true}
 };
 
+constexpr struct {
+    const char* name;
+    UnsignedInt threads;
+} MeshBatchData[]{
+    {"single-threaded", 1},
+    {"hardware concurrency", 0},
+    {"three threads", 3}
+};
+
+/* Converting many meshes should scale with the thread count */
+constexpr struct {
+    const char* name;
+    UnsignedInt threads;
+} BenchmarkMeshBatchData[]{
+    {"1 thread", 1},
+    {"2 threads", 2},
+    {"4 threads", 4},
+    {"8 threads", 8}
+};
+
+constexpr struct {
+    const char* name;
+    bool flat;
+} HierarchyData[]{
+    {"object3D()", false},
+    {"flatHierarchy()", true}
+};
+
+constexpr UnsignedInt BenchmarkNodeCount = 10000;
+
+/* A scene with given count of meshes for benchmarks, each having positions,
+   normals and given count of triangles, and a single root node */
+Containers::Pointer<aiScene> meshBatchScene(const UnsignedInt meshCount, const UnsignedInt triangleCount) {
+    Containers::Pointer<aiScene> scene{Containers::InPlaceInit};
+    scene->mRootNode = new aiNode;
+    scene->mNumMeshes = meshCount;
+    scene->mMeshes = new aiMesh*[meshCount];
+    for(UnsignedInt i = 0; i != meshCount; ++i) {
+        aiMesh* mesh = scene->mMeshes[i] = new aiMesh;
+        mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+        mesh->mNumVertices = triangleCount*3;
+        mesh->mVertices = new aiVector3D[triangleCount*3];
+        mesh->mNormals = new aiVector3D[triangleCount*3];
+        for(UnsignedInt j = 0; j != triangleCount*3; ++j) {
+            mesh->mVertices[j] = aiVector3D(Float(i), Float(j), Float(j%3));
+            mesh->mNormals[j] = aiVector3D(0.0f, 0.0f, 1.0f);
+        }
+        mesh->mNumFaces = triangleCount;
+        mesh->mFaces = new aiFace[triangleCount];
+        for(UnsignedInt j = 0; j != triangleCount; ++j) {
+            aiFace& face = mesh->mFaces[j];
+            face.mNumIndices = 3;
+            face.mIndices = new unsigned int[3]{j*3 + 2, j*3 + 1, j*3};
+        }
+    }
+
+    return scene;
+}
+
+/* A scene with given count of nodes, each referencing a single shared mesh
+   and having one child without a mesh */
+Containers::Pointer<aiScene> manyNodesScene(const UnsignedInt nodeCount) {
+    Containers::Pointer<aiScene> scene = meshBatchScene(1, 1);
+    aiNode* root = scene->mRootNode;
+    root->mNumChildren = nodeCount;
+    root->mChildren = new aiNode*[nodeCount];
+    for(UnsignedInt i = 0; i != nodeCount; ++i) {
+        aiNode* node = root->mChildren[i] = new aiNode;
+        node->mParent = root;
+        node->mNumMeshes = 1;
+        node->mMeshes = new unsigned int[1]{0};
+        node->mNumChildren = 1;
+        node->mChildren = new aiNode*[1]{new aiNode};
+        node->mChildren[0]->mParent = node;
+    }
+
+    return scene;
+}
+
 AssimpImporterTest::AssimpImporterTest() {
     addInstancedTests({&AssimpImporterTest::openFile},
         Containers::arraySize(VerboseData));
 
     addTests({&AssimpImporterTest::openFileFailed,
+              &AssimpImporterTest::openFileMapFiles,
+              &AssimpImporterTest::openFileMapFilesFailed,
+              &AssimpImporterTest::openFilePostprocessCache,
               &AssimpImporterTest::openData,
               &AssimpImporterTest::openDataFailed,
 
@@ -178,12 +274,16 @@ AssimpImporterTest::AssimpImporterTest() {
               &AssimpImporterTest::mesh,
               &AssimpImporterTest::pointMesh,
               &AssimpImporterTest::lineMesh,
-              &AssimpImporterTest::meshMultiplePrimitives,
+              &AssimpImporterTest::meshMultiplePrimitives});
+
+    addInstancedTests({&AssimpImporterTest::meshBatch},
+        Containers::arraySize(MeshBatchData));
 
-              &AssimpImporterTest::emptyCollada,
+    addTests({&AssimpImporterTest::emptyCollada,
               &AssimpImporterTest::emptyGltf,
               &AssimpImporterTest::scene,
-              &AssimpImporterTest::sceneCollapsedNode});
+              &AssimpImporterTest::sceneCollapsedNode,
+              &AssimpImporterTest::flatHierarchy});
 
     addInstancedTests({&AssimpImporterTest::upDirectionPatching,
                        &AssimpImporterTest::upDirectionPatchingPreTransformVertices},
@@ -210,6 +310,12 @@ AssimpImporterTest::AssimpImporterTest() {
               &AssimpImporterTest::fileCallbackImage,
               &AssimpImporterTest::fileCallbackImageNotFound});
 
+    addInstancedBenchmarks({&AssimpImporterTest::benchmarkMeshBatch}, 5,
+        Containers::arraySize(BenchmarkMeshBatchData));
+
+    addInstancedBenchmarks({&AssimpImporterTest::benchmarkHierarchy}, 5,
+        Containers::arraySize(HierarchyData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. It also pulls in the AnyImageImporter dependency. Reset
        the plugin dir after so it doesn't load anything else from the
@@ -269,6 +375,152 @@ void AssimpImporterTest::openFileFailed() {
     CORRADE_COMPARE(out.str(), "Trade::AssimpImporter::openFile(): failed to open i-do-not-exist.foo: Unable to open file \"i-do-not-exist.foo\".\n");
 }
 
+void AssimpImporterTest::openFileMapFiles() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().setValue("mapFiles", true);
+
+    /* The material file referenced from the OBJ should get mapped as well */
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "material-color-texture.obj")));
+    CORRADE_COMPARE(importer->materialCount(), 2);
+    Containers::Pointer<AbstractMaterialData> material = importer->material(1);
+    CORRADE_VERIFY(material);
+    CORRADE_COMPARE(static_cast<PhongMaterialData&>(*material).diffuseColor(), (Color4{0.08f, 0.16f, 0.24f, 1.0f}));
+
+    CORRADE_COMPARE(importer->meshCount(), 1);
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedInt>(),
+        Containers::arrayView<UnsignedInt>({0, 1, 2}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {-1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+
+    /* The mapped files are not needed after opening */
+    importer->close();
+    CORRADE_VERIFY(!importer->isOpened());
+
+    /* Disabling the option again goes back to the default IO handler */
+    importer->configuration().setValue("mapFiles", false);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "material-color-texture.obj")));
+    CORRADE_COMPARE(importer->meshCount(), 1);
+}
+
+void AssimpImporterTest::openFileMapFilesFailed() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().setValue("mapFiles", true);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+
+    CORRADE_VERIFY(!importer->openFile("i-do-not-exist.foo"));
+    CORRADE_COMPARE(out.str(), "Trade::AssimpImporter::openFile(): failed to open i-do-not-exist.foo: Unable to open file \"i-do-not-exist.foo\".\n");
+}
+
+void AssimpImporterTest::openFilePostprocessCache() {
+    #if !defined(CORRADE_TARGET_UNIX) && !(defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    CORRADE_SKIP("The postprocess cache is not available on this platform.");
+    #elif defined(ASSIMP_BUILD_NO_EXPORT)
+    CORRADE_SKIP("The postprocess cache needs Assimp built with exporters.");
+    #else
+    const std::string cacheDirectory = Utility::Directory::join(ASSIMPIMPORTER_WRITE_TEST_DIR, "postprocess-cache");
+    CORRADE_VERIFY(Utility::Directory::mkpath(cacheDirectory));
+    for(const std::string& file: Utility::Directory::list(cacheDirectory, Utility::Directory::Flag::SkipDotAndDotDot))
+        CORRADE_VERIFY(Utility::Directory::rm(Utility::Directory::join(cacheDirectory, file)));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().setValue("postprocessCache", cacheDirectory);
+
+    /* The first open imports the file and saves the cache */
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae")));
+    CORRADE_COMPARE(importer->meshCount(), 1);
+    std::vector<std::string> files = Utility::Directory::list(cacheDirectory, Utility::Directory::Flag::SkipDotAndDotDot);
+    CORRADE_COMPARE(files.size(), 1);
+    const std::string cacheFilename = Utility::Directory::join(cacheDirectory, files[0]);
+
+    /* Opening again loads the same scene from the cache */
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae")));
+    CORRADE_COMPARE(importer->meshCount(), 1);
+    CORRADE_COMPARE(importer->object3DCount(), 1);
+    {
+        Containers::Optional<MeshData> mesh = importer->mesh(0);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+        CORRADE_COMPARE_AS(mesh->indices<UnsignedInt>(),
+            Containers::arrayView<UnsignedInt>({0, 1, 2}),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView<Vector3>({
+                {-1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, 1.0f}, {1.0f, -1.0f, 1.0f}
+            }), TestSuite::Compare::Container);
+    }
+    CORRADE_COMPARE(Utility::Directory::list(cacheDirectory, Utility::Directory::Flag::SkipDotAndDotDot).size(), 1);
+
+    /* Different postprocess flags result in a different cache file */
+    importer->configuration().group("postprocess")->setValue("FlipUVs", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae")));
+    CORRADE_COMPARE(Utility::Directory::list(cacheDirectory, Utility::Directory::Flag::SkipDotAndDotDot).size(), 2);
+    importer->configuration().group("postprocess")->setValue("FlipUVs", false);
+
+    /* Replace the cache with a cache of a different file to verify it's used
+       instead of importing the file */
+    files = Utility::Directory::list(cacheDirectory, Utility::Directory::Flag::SkipDotAndDotDot);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "points.obj")));
+    std::string otherCacheFilename;
+    for(const std::string& file: Utility::Directory::list(cacheDirectory, Utility::Directory::Flag::SkipDotAndDotDot))
+        if(std::find(files.begin(), files.end(), file) == files.end())
+            otherCacheFilename = Utility::Directory::join(cacheDirectory, file);
+    CORRADE_VERIFY(!otherCacheFilename.empty());
+    CORRADE_VERIFY(Utility::Directory::copy(otherCacheFilename, cacheFilename));
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae")));
+    {
+        Containers::Optional<MeshData> mesh = importer->mesh(0);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Points);
+    }
+
+    /* An invalid cache is silently replaced */
+    CORRADE_VERIFY(Utility::Directory::writeString(cacheFilename, "invalid"));
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae")));
+        CORRADE_COMPARE(out.str(), "");
+    }
+    {
+        Containers::Optional<MeshData> mesh = importer->mesh(0);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    }
+    const Containers::Array<char> cacheData = Utility::Directory::read(cacheFilename);
+    CORRADE_COMPARE_AS(cacheData.size(), std::size_t{7},
+        TestSuite::Compare::Greater);
+
+    /* A truncated cache, such as one left behind by a killed process, is
+       rejected and replaced with a complete one as well */
+    CORRADE_VERIFY(Utility::Directory::write(cacheFilename, cacheData.prefix(cacheData.size()/2)));
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae")));
+        CORRADE_COMPARE(out.str(), "");
+    }
+    {
+        Containers::Optional<MeshData> mesh = importer->mesh(0);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    }
+    /* The assbin header contains the export time, so compare just the size */
+    CORRADE_COMPARE(Utility::Directory::read(cacheFilename).size(), cacheData.size());
+
+    /* The cache is written through a temporary file that's renamed into
+       place, so nothing else is left in the directory */
+    CORRADE_COMPARE(Utility::Directory::list(cacheDirectory, Utility::Directory::Flag::SkipDotAndDotDot).size(), files.size() + 1);
+    #endif
+}
+
 void AssimpImporterTest::openData() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
 
@@ -890,6 +1142,64 @@ void AssimpImporterTest::meshMultiplePrimitives() {
     }
 }
 
+void AssimpImporterTest::meshBatch() {
+    auto&& data = MeshBatchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifdef ASSIMPIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only if the plugin is built as static.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().setValue("meshThreads", data.threads);
+    /* Without triangulation the quad is imported as a polygon, which should
+       fail to import */
+    importer->configuration().group("postprocess")->setValue("Triangulate", false);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "mesh-batch.obj")));
+    CORRADE_COMPARE(importer->meshCount(), 4);
+    const aiScene* scene = static_cast<const aiScene*>(importer->importerState());
+    CORRADE_VERIFY(scene);
+
+    /* Repeated IDs are fine */
+    const UnsignedInt ids[]{3, 2, 0, 1, 3};
+    Containers::Array<Containers::Optional<MeshData>> meshes;
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        meshes = static_cast<AssimpImporter&>(*importer).meshBatch(ids);
+        CORRADE_COMPARE(out.str(), "Trade::AssimpImporter::mesh(): unsupported aiPrimitiveType 8\n");
+    }
+    CORRADE_COMPARE(meshes.size(), Containers::arraySize(ids));
+    CORRADE_VERIFY(!meshes[1]);
+
+    /* The result should be the same as when importing sequentially */
+    for(std::size_t i: {0, 2, 3, 4}) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(meshes[i]);
+        CORRADE_VERIFY(meshes[i]->importerState() == scene->mMeshes[ids[i]]);
+
+        Containers::Optional<MeshData> expected = importer->mesh(ids[i]);
+        CORRADE_VERIFY(expected);
+        CORRADE_COMPARE(meshes[i]->primitive(), MeshPrimitive::Triangles);
+        CORRADE_COMPARE_AS(meshes[i]->indices<UnsignedInt>(),
+            expected->indices<UnsignedInt>(),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(meshes[i]->attribute<Vector3>(MeshAttribute::Position),
+            expected->attribute<Vector3>(MeshAttribute::Position),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(meshes[i]->attribute<Vector3>(MeshAttribute::Normal),
+            expected->attribute<Vector3>(MeshAttribute::Normal),
+            TestSuite::Compare::Container);
+    }
+
+    /* Verify the meshes are the ones from the file and not something
+       accidentally equal */
+    CORRADE_COMPARE(meshes[2]->indexCount(), 3);
+    CORRADE_COMPARE(meshes[3]->indexCount(), 6);
+    CORRADE_COMPARE(meshes[0]->indexCount(), 6);
+    CORRADE_COMPARE(meshes[0]->attribute<Vector3>(MeshAttribute::Normal)[0], Vector3::yAxis());
+    #endif
+}
+
 void AssimpImporterTest::emptyCollada() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
 
@@ -984,6 +1294,64 @@ void AssimpImporterTest::sceneCollapsedNode() {
     }
 }
 
+void AssimpImporterTest::flatHierarchy() {
+    #ifdef ASSIMPIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only if the plugin is built as static.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+
+    {
+        CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "scene.dae")));
+
+        AssimpImporter::FlatHierarchy hierarchy = static_cast<AssimpImporter&>(*importer).flatHierarchy();
+        CORRADE_COMPARE_AS(hierarchy.parents, Containers::arrayView<Int>({
+            -1, 0
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE(hierarchy.transformations[0], Matrix4::scaling({1.0f, 2.0f, 3.0f}));
+        CORRADE_COMPARE(hierarchy.transformations[1], importer->object3D(1)->transformation());
+        CORRADE_COMPARE_AS(hierarchy.meshes, Containers::arrayView<Int>({
+            -1, -1
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(hierarchy.cameras, Containers::arrayView<Int>({
+            -1, -1
+        }), TestSuite::Compare::Container);
+    }
+
+    /* For other files the result should be consistent with object3D() */
+    for(const char* file: {"mesh-multiple-primitives.dae", "camera.dae", "light.dae", "z-up.dae"}) {
+        CORRADE_ITERATION(file);
+        CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, file)));
+
+        AssimpImporter::FlatHierarchy hierarchy = static_cast<AssimpImporter&>(*importer).flatHierarchy();
+        CORRADE_COMPARE(hierarchy.parents.size(), importer->object3DCount());
+        CORRADE_COMPARE(hierarchy.transformations.size(), importer->object3DCount());
+
+        Containers::Optional<SceneData> scene = importer->scene(0);
+        CORRADE_VERIFY(scene);
+        for(const UnsignedInt child: scene->children3D())
+            CORRADE_COMPARE(hierarchy.parents[child], -1);
+
+        for(UnsignedInt i = 0; i != importer->object3DCount(); ++i) {
+            CORRADE_ITERATION(i);
+            Containers::Pointer<ObjectData3D> object = importer->object3D(i);
+            CORRADE_VERIFY(object);
+            CORRADE_COMPARE(hierarchy.transformations[i], object->transformation());
+            for(const UnsignedInt child: object->children())
+                CORRADE_COMPARE(hierarchy.parents[child], Int(i));
+
+            if(object->instanceType() == ObjectInstanceType3D::Mesh) {
+                CORRADE_COMPARE(hierarchy.meshes[i], object->instance());
+                CORRADE_COMPARE(hierarchy.materials[i], static_cast<MeshObjectData3D&>(*object).material());
+            } else if(object->instanceType() == ObjectInstanceType3D::Camera) {
+                CORRADE_COMPARE(hierarchy.cameras[i], object->instance());
+            } else if(object->instanceType() == ObjectInstanceType3D::Light) {
+                CORRADE_COMPARE(hierarchy.lights[i], object->instance());
+            }
+        }
+    }
+    #endif
+}
+
 void AssimpImporterTest::upDirectionPatching() {
     auto&& data = UpDirectionPatchingData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -1536,6 +1904,65 @@ void AssimpImporterTest::fileCallbackImageNotFound() {
     CORRADE_COMPARE(out.str(), "Trade::AbstractImporter::openFile(): cannot open file diffuse_texture.png\n");
 }
 
+void AssimpImporterTest::benchmarkMeshBatch() {
+    auto&& data = BenchmarkMeshBatchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifdef ASSIMPIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only if the plugin is built as static.");
+    #else
+    Containers::Pointer<aiScene> scene = meshBatchScene(256, 2048);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().setValue("meshThreads", data.threads);
+    CORRADE_VERIFY(importer->openState(scene.get()));
+
+    Containers::Array<UnsignedInt> ids{Containers::NoInit, importer->meshCount()};
+    for(UnsignedInt i = 0; i != ids.size(); ++i) ids[i] = i;
+
+    Containers::Array<Containers::Optional<MeshData>> meshes;
+    CORRADE_BENCHMARK(1)
+        meshes = static_cast<AssimpImporter&>(*importer).meshBatch(ids);
+
+    CORRADE_COMPARE(meshes.size(), 256);
+    for(const Containers::Optional<MeshData>& mesh: meshes) {
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->vertexCount(), 2048*3);
+    }
+    #endif
+}
+
+void AssimpImporterTest::benchmarkHierarchy() {
+    auto&& data = HierarchyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifdef ASSIMPIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only if the plugin is built as static.");
+    #else
+    Containers::Pointer<aiScene> scene = manyNodesScene(BenchmarkNodeCount);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    CORRADE_VERIFY(importer->openState(scene.get()));
+    CORRADE_COMPARE(importer->object3DCount(), BenchmarkNodeCount*2);
+
+    std::size_t meshCount = 0;
+    if(data.flat) {
+        CORRADE_BENCHMARK(1) {
+            AssimpImporter::FlatHierarchy hierarchy = static_cast<AssimpImporter&>(*importer).flatHierarchy();
+            for(const Int mesh: hierarchy.meshes)
+                if(mesh != -1) ++meshCount;
+        }
+    } else {
+        CORRADE_BENCHMARK(1) {
+            for(UnsignedInt i = 0; i != importer->object3DCount(); ++i)
+                if(importer->object3D(i)->instanceType() == ObjectInstanceType3D::Mesh) ++meshCount;
+        }
+    }
+
+    CORRADE_COMPARE(meshCount, BenchmarkNodeCount);
+    #endif
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::AssimpImporterTest)
@@ -27,4 +27,5 @@
 #cmakedefine DDSIMPORTER_PLUGIN_FILENAME "${DDSIMPORTER_PLUGIN_FILENAME}"
 #cmakedefine STBIMAGEIMPORTER_PLUGIN_FILENAME "${STBIMAGEIMPORTER_PLUGIN_FILENAME}"
 #define ASSIMPIMPORTER_TEST_DIR "${ASSIMPIMPORTER_TEST_DIR}"
+#define ASSIMPIMPORTER_WRITE_TEST_DIR "${ASSIMPIMPORTER_WRITE_TEST_DIR}"
 #cmakedefine01 ASSIMP_IS_VERSION_5
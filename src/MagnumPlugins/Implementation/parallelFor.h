@@ -0,0 +1,80 @@
+#ifndef MagnumPlugins_Implementation_parallelFor_h
+#define MagnumPlugins_Implementation_parallelFor_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <Magnum/Magnum.h>
+
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+#include <system_error>
+#include <thread>
+#include <vector>
+#endif
+
+namespace Magnum { namespace Implementation {
+
+/* Calls f(i) for all i < count, distributed over threadCount threads
+   including the calling one, with 0 meaning std::thread::hardware_concurrency().
+   Blocks until all are done. The indices are handed out one by one from an
+   atomic counter, so if spawning a thread fails, the work is picked up by the
+   threads that were already started and the calling thread. On Emscripten
+   everything is done on the calling thread. */
+template<class F> void parallelFor(UnsignedInt threadCount, const std::size_t count, F&& f) {
+    std::atomic<std::size_t> next{0};
+    auto work = [&]() {
+        for(std::size_t i; (i = next++) < count; ) f(i);
+    };
+
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    if(threadCount == 0) threadCount = std::thread::hardware_concurrency();
+
+    /* The calling thread is doing work as well, so spawn one less. Reserve
+       upfront so a failed allocation can't happen with threads already
+       running. */
+    std::vector<std::thread> threads;
+    const std::size_t threadsToSpawn = threadCount > 1 && count > 1 ?
+        (threadCount < count ? threadCount : count) - 1 : 0;
+    threads.reserve(threadsToSpawn);
+    try {
+        for(std::size_t i = 0; i != threadsToSpawn; ++i)
+            threads.emplace_back(work);
+    } catch(const std::system_error&) {
+        /* Out of threads or other resources, continue with what we have.
+           Letting the exception propagate would destroy joinable threads,
+           which calls std::terminate(). */
+    }
+    work();
+    for(std::thread& thread: threads) thread.join();
+    #else
+    static_cast<void>(threadCount);
+    work();
+    #endif
+}
+
+}}
+
+#endif
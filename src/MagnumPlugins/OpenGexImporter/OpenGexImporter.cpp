@@ -29,12 +29,14 @@
 #include <algorithm>
 #include <limits>
 #include <unordered_map>
-#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Directory.h>
 #include <Magnum/Mesh.h>
 #include <Magnum/Math/Quaternion.h>
+#include <Magnum/Trade/AnimationData.h>
 #include <Magnum/Trade/CameraData.h>
 #include <Magnum/Trade/ImageData.h>
 #include <Magnum/Trade/LightData.h>
@@ -48,9 +50,31 @@
 #include "Magnum/OpenDdl/Property.h"
 #include "Magnum/OpenDdl/Structure.h"
 #include "MagnumPlugins/AnyImageImporter/AnyImageImporter.h"
+#include "MagnumPlugins/Implementation/parallelFor.h"
 
 #include "openGexSpec.hpp"
 
+#ifdef CORRADE_TARGET_SSE2
+#include <emmintrin.h>
+#endif
+
+/* Memory-mapping and file size and modification time is needed for the
+   binary cache */
+#if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+#define MAGNUM_OPENGEXIMPORTER_BINARY_CACHE
+#ifdef CORRADE_TARGET_WINDOWS
+#define WIN32_LEAN_AND_MEAN 1
+#define VC_EXTRALEAN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <Corrade/Utility/Unicode.h>
+#else
+#include <sys/stat.h>
+#endif
+#endif
+
 namespace Magnum { namespace Trade {
 
 using namespace Magnum::Math::Literals;
@@ -67,6 +91,11 @@ struct OpenGexImporter::Document {
 
     Containers::Optional<std::string> filePath;
 
+    /* Copy of the file data if GeometryObject contents are parsed lazily,
+       and the lazily parsed contents for each mesh */
+    Containers::Array<char> data;
+    std::vector<Containers::Pointer<OpenDdl::Document>> meshContents;
+
     std::vector<OpenDdl::Structure> nodes,
         cameras,
         lights,
@@ -75,33 +104,58 @@ struct OpenGexImporter::Document {
         textures;
 
     std::unordered_map<std::string, Int> nodesForName,
-        materialsForName;
+        materialsForName,
+        animationsForName;
+
+    /* Sorted unique clip indices of all Animation structures, each is one
+       animation */
+    std::vector<UnsignedInt> animationClips;
+
+    /* Maps OpenDdl::Structure::index() to the position in one of the
+       vectors above, so references can be resolved without a linear search.
+       Each structure is in at most one of them. */
+    std::unordered_map<std::size_t, UnsignedInt> structureIds;
 
     std::unordered_map<std::string, UnsignedInt> imagesForName;
     std::vector<std::string> images;
 
     UnsignedInt imageImporterId = ~UnsignedInt{};
     Containers::Optional<AnyImageImporter> imageImporter;
+
+    Int findStructureId(const std::vector<OpenDdl::Structure>& structures, const OpenDdl::Structure structure) const {
+        const auto found = structureIds.find(structure.index());
+        return found != structureIds.end() && found->second < structures.size() && structures[found->second] == structure ? Int(found->second) : -1;
+    }
+
+    UnsignedInt structureId(const std::vector<OpenDdl::Structure>& structures, const OpenDdl::Structure structure) const {
+        const Int id = findStructureId(structures, structure);
+        CORRADE_INTERNAL_ASSERT(id != -1);
+        return id;
+    }
 };
 
 namespace {
 
-inline Int findStructureId(const std::vector<OpenDdl::Structure>& structures, OpenDdl::Structure structure) {
-    auto found = std::find(structures.begin(), structures.end(), structure);
-    return found == structures.end() ? -1 : found - structures.begin();
+void fillDefaultConfiguration(Utility::ConfigurationGroup& conf) {
+    /** @todo horrible workaround, fix this properly */
+    conf.setValue("parseThreads", 1);
+    conf.setValue("binaryCache", false);
+    conf.setValue("binaryCacheHashContents", false);
+    conf.setValue("lazyMeshes", false);
+    conf.setValue("meshThreads", 1);
 }
 
-UnsignedInt structureId(const std::vector<OpenDdl::Structure>& structures, OpenDdl::Structure structure) {
-    const Int id = findStructureId(structures, structure);
-    CORRADE_INTERNAL_ASSERT(id != -1);
-    return id;
 }
 
+OpenGexImporter::OpenGexImporter() {
+    /** @todo horrible workaround, fix this properly */
+    fillDefaultConfiguration(configuration());
 }
 
-OpenGexImporter::OpenGexImporter() = default;
-
-OpenGexImporter::OpenGexImporter(PluginManager::Manager<AbstractImporter>& manager): AbstractImporter(manager) {}
+OpenGexImporter::OpenGexImporter(PluginManager::Manager<AbstractImporter>& manager): AbstractImporter(manager) {
+    /** @todo horrible workaround, fix this properly */
+    fillDefaultConfiguration(configuration());
+}
 
 OpenGexImporter::OpenGexImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter(manager, plugin) {}
 
@@ -126,11 +180,29 @@ void gatherNodes(OpenDdl::Structure node, std::vector<OpenDdl::Structure>& nodes
 }
 
 void OpenGexImporter::doOpenData(const Containers::ArrayView<const char> data) {
+    parseDocument(data, configuration().value<bool>("lazyMeshes"));
+}
+
+void OpenGexImporter::parseDocument(const Containers::ArrayView<const char> data, const bool lazyMeshes) {
     Containers::Pointer<Document> d{Containers::InPlaceInit};
 
+    /* If mesh data are parsed lazily, the data need to stay around until all
+       meshes are parsed */
+    Containers::ArrayView<const char> parseData = data;
+    if(lazyMeshes) {
+        d->data = Containers::Array<char>{Containers::NoInit, data.size()};
+        Utility::copy(data, d->data);
+        parseData = d->data;
+        d->document.setDeferredStructures({OpenGex::GeometryObject});
+    }
+
     /* Parse the document */
-    if(!d->document.parse(data, OpenGex::structures, OpenGex::properties)) return;
+    if(!d->document.parse(parseData, OpenGex::structures, OpenGex::properties, configuration().value<UnsignedInt>("parseThreads"))) return;
 
+    openDocument(std::move(d));
+}
+
+void OpenGexImporter::openDocument(Containers::Pointer<Document>&& d) {
     /* Validate the document */
     if(!d->document.validate(OpenGex::rootStructures, OpenGex::structureInfo)) return;
 
@@ -195,6 +267,7 @@ void OpenGexImporter::doOpenData(const Containers::ArrayView<const char> data) {
     /** @todo Support for LOD */
     for(const OpenDdl::Structure geometry: d->document.childrenOf(OpenGex::GeometryObject))
         d->meshes.push_back(geometry);
+    d->meshContents.resize(d->meshes.size());
 
     /* Gather all lights and light textures */
     for(const OpenDdl::Structure light: d->document.childrenOf(OpenGex::LightObject)) {
@@ -221,11 +294,143 @@ void OpenGexImporter::doOpenData(const Containers::ArrayView<const char> data) {
     for(const OpenDdl::Structure node: d->document.childrenOf(OpenGex::Node, OpenGex::BoneNode, OpenGex::GeometryNode, OpenGex::CameraNode, OpenGex::LightNode))
         gatherNodes(node, d->nodes, d->nodesForName);
 
+    /* Index all gathered structures for reference resolution */
+    {
+        const std::vector<OpenDdl::Structure>* const all[]{&d->nodes, &d->cameras, &d->lights, &d->meshes, &d->materials, &d->textures};
+        std::size_t count = 0;
+        for(const std::vector<OpenDdl::Structure>* structures: all)
+            count += structures->size();
+        d->structureIds.reserve(count);
+        for(const std::vector<OpenDdl::Structure>* structures: all)
+            for(std::size_t i = 0; i != structures->size(); ++i)
+                d->structureIds.emplace((*structures)[i].index(), i);
+    }
+
+    /* Gather animation clips. All Animation structures with the same clip
+       index form one animation. */
+    for(const OpenDdl::Structure node: d->nodes) {
+        for(const OpenDdl::Structure animation: node.childrenOf(OpenGex::Animation)) {
+            const Containers::Optional<OpenDdl::Property> clip = animation.findPropertyOf(OpenGex::clip);
+            d->animationClips.push_back(clip ? clip->as<Int>() : 0);
+        }
+    }
+    std::sort(d->animationClips.begin(), d->animationClips.end());
+    d->animationClips.erase(std::unique(d->animationClips.begin(), d->animationClips.end()), d->animationClips.end());
+
+    /* Animation names from Clip structures matching them */
+    for(const OpenDdl::Structure clip: d->document.childrenOf(OpenGex::Clip)) {
+        const Containers::Optional<OpenDdl::Structure> name = clip.findFirstChildOf(OpenGex::Name);
+        if(!name) continue;
+
+        const Containers::Optional<OpenDdl::Property> index = clip.findPropertyOf(OpenGex::index);
+        const UnsignedInt clipIndex = index ? index->as<Int>() : 0;
+        const auto found = std::lower_bound(d->animationClips.begin(), d->animationClips.end(), clipIndex);
+        if(found != d->animationClips.end() && *found == clipIndex)
+            d->animationsForName.emplace(name->firstChild().as<std::string>(), found - d->animationClips.begin());
+    }
+
     /* Everything okay, save the instance */
     _d = std::move(d);
 }
 
+#ifdef MAGNUM_OPENGEXIMPORTER_BINARY_CACHE
+namespace {
+
+/* Identifies file contents for the binary cache without having to read the
+   file. The modification time is with the best precision the platform
+   provides, nanoseconds on Unix and 100-nanosecond ticks on Windows. */
+struct FileFingerprint {
+    UnsignedLong size;
+    UnsignedLong modificationTime[2];
+};
+
+bool fileFingerprint(const std::string& filename, FileFingerprint& out) {
+    out = {};
+    #ifdef CORRADE_TARGET_WINDOWS
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if(!GetFileAttributesExW(Utility::Unicode::widen(filename).data(), GetFileExInfoStandard, &attributes))
+        return false;
+    out.size = UnsignedLong(attributes.nFileSizeHigh) << 32 | attributes.nFileSizeLow;
+    out.modificationTime[0] = UnsignedLong(attributes.ftLastWriteTime.dwHighDateTime) << 32 | attributes.ftLastWriteTime.dwLowDateTime;
+    #else
+    struct stat st;
+    if(stat(filename.data(), &st) != 0) return false;
+    out.size = st.st_size;
+    #ifdef CORRADE_TARGET_APPLE
+    out.modificationTime[0] = st.st_mtimespec.tv_sec;
+    out.modificationTime[1] = st.st_mtimespec.tv_nsec;
+    #else
+    out.modificationTime[0] = st.st_mtim.tv_sec;
+    out.modificationTime[1] = st.st_mtim.tv_nsec;
+    #endif
+    #endif
+    return true;
+}
+
+}
+#endif
+
 void OpenGexImporter::doOpenFile(const std::string& filename) {
+    #ifdef MAGNUM_OPENGEXIMPORTER_BINARY_CACHE
+    /* Use the binary cache, if enabled. With file callbacks there's no place
+       to save the cache to, so it's not used there. */
+    if(configuration().value<bool>("binaryCache") && !fileCallback()) {
+        /* Query the fingerprint before reading the file, so if the file gets
+           modified in between, the cache is made with an outdated fingerprint
+           and the file is parsed again next time */
+        FileFingerprint fingerprint;
+        if(!fileFingerprint(filename, fingerprint)) {
+            Error() << "Trade::OpenGexImporter::openFile(): cannot open file" << filename;
+            return;
+        }
+
+        /* By default the cache is used if it was made from a file of the same
+           size and modification time, so a cache hit doesn't need to touch
+           the file at all. Hashing the contents catches also changes that
+           preserve the modification time, but the whole file has to be read
+           on every open. */
+        const bool hashContents = configuration().value<bool>("binaryCacheHashContents");
+        Containers::Array<char> data;
+        if(hashContents) data = Utility::Directory::read(filename);
+        const Containers::ArrayView<const char> sourceKey = hashContents ?
+            Containers::ArrayView<const char>{data} :
+            Containers::ArrayView<const char>{reinterpret_cast<const char*>(&fingerprint), sizeof(FileFingerprint)};
+        const std::string cacheFilename = filename + ".oddlcache";
+
+        if(Utility::Directory::exists(cacheFilename)) {
+            Containers::Pointer<Document> d{Containers::InPlaceInit};
+            bool deserialized;
+            {
+                /* An invalid or outdated cache is not an error, the file gets
+                   parsed and the cache replaced below */
+                Error redirectError{nullptr};
+                const Containers::Array<const char, Utility::Directory::MapDeleter> cache = Utility::Directory::mapRead(cacheFilename);
+                deserialized = cache && d->document.deserialize(cache, OpenGex::structures, OpenGex::properties, sourceKey);
+            }
+
+            if(deserialized) {
+                openDocument(std::move(d));
+                if(_d) {
+                    _d->filePath = Utility::Directory::path(filename);
+                    return;
+                }
+            }
+        }
+
+        /* Serialization needs everything parsed, so lazy meshes can't be
+           used here */
+        if(!hashContents) data = Utility::Directory::read(filename);
+        parseDocument(data, false);
+        if(!_d) return;
+
+        /* Failing to write the cache is not fatal, Directory::write() prints
+           a message on its own */
+        Utility::Directory::write(cacheFilename, _d->document.serialize(sourceKey));
+        _d->filePath = Utility::Directory::path(filename);
+        return;
+    }
+    #endif
+
     /* Make doOpenData() do the thing */
     AbstractImporter::doOpenFile(filename);
 
@@ -316,6 +521,196 @@ namespace {
         m[3].xyz() *= distanceMultiplier;
         return m;
     }
+
+    /* Copies tightly packed three-component vectors into a strided
+       destination, scaling them and converting from Z up at the same time.
+       Equivalent to Utility::copy() followed by a multiplication and
+       fixVectorZUp(), but in a single pass over the data, which matters for
+       meshes with millions of vertices. Double input is converted to floats
+       in the same pass. */
+    template<class T> void copyVectors(const Containers::ArrayView<const T> src, const Containers::StridedArrayView1D<Vector3>& dst, const Float scale, const bool zUp) {
+        const std::size_t count = dst.size();
+        const std::ptrdiff_t stride = dst.stride();
+        CORRADE_INTERNAL_ASSERT(src.size() == count*3);
+
+        const T* in = src.data();
+        char* out = static_cast<char*>(dst.data());
+
+        /* Separate loops so the branch isn't evaluated for every vertex */
+        if(zUp) for(std::size_t i = 0; i != count; ++i, in += 3, out += stride) {
+            Float* const o = reinterpret_cast<Float*>(out);
+            const Float x = Float(in[0]), y = Float(in[1]), z = Float(in[2]);
+            o[0] = x*scale;
+            o[1] = z*scale;
+            o[2] = -(y*scale);
+        } else for(std::size_t i = 0; i != count; ++i, in += 3, out += stride) {
+            Float* const o = reinterpret_cast<Float*>(out);
+            const Float x = Float(in[0]), y = Float(in[1]), z = Float(in[2]);
+            o[0] = x*scale;
+            o[1] = y*scale;
+            o[2] = z*scale;
+        }
+    }
+
+    /* Two-component variant of the above, used for texture coordinates */
+    void copyVectors(const Containers::ArrayView<const Float> src, const Containers::StridedArrayView1D<Vector2>& dst) {
+        Utility::copy(Containers::arrayCast<const Vector2>(src), dst);
+    }
+
+    void copyVectors(const Containers::ArrayView<const Double> src, const Containers::StridedArrayView1D<Vector2>& dst) {
+        const std::size_t count = dst.size();
+        const std::ptrdiff_t stride = dst.stride();
+        CORRADE_INTERNAL_ASSERT(src.size() == count*2);
+
+        const Double* in = src.data();
+        char* out = static_cast<char*>(dst.data());
+        for(std::size_t i = 0; i != count; ++i, in += 2, out += stride) {
+            Float* const o = reinterpret_cast<Float*>(out);
+            o[0] = Float(in[0]);
+            o[1] = Float(in[1]);
+        }
+    }
+
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    /* Bitwise OR of all indices. Its highest set bit is the highest set bit of
+       the largest index, which is all that's needed to pick the smallest type
+       that fits. Unlike a maximum it's trivially vectorizable for 64-bit
+       integers even with just SSE2. */
+    UnsignedLong orIndices(const Containers::ArrayView<const UnsignedLong> indices) {
+        UnsignedLong out = 0;
+        std::size_t i = 0;
+        #ifdef CORRADE_TARGET_SSE2
+        __m128i acc = _mm_setzero_si128();
+        for(; i + 2 <= indices.size(); i += 2)
+            acc = _mm_or_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices.data() + i)));
+        alignas(16) UnsignedLong lanes[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+        out = lanes[0]|lanes[1];
+        #endif
+        for(; i != indices.size(); ++i) out |= indices[i];
+        return out;
+    }
+    #endif
+
+    /* Copies indices, converting them to the destination type and splitting
+       each quad (a, b, c, d) into triangles (a, b, c) and (a, c, d) if
+       requested */
+    template<class T, class U> void copyIndices(const Containers::ArrayView<const U> src, const Containers::ArrayView<T> dst, const bool quads) {
+        if(!quads) {
+            CORRADE_INTERNAL_ASSERT(src.size() == dst.size());
+            for(std::size_t i = 0; i != src.size(); ++i)
+                dst[i] = T(src[i]);
+            return;
+        }
+
+        CORRADE_INTERNAL_ASSERT(src.size()/4*6 == dst.size());
+        for(std::size_t i = 0, j = 0; i != src.size(); i += 4, j += 6) {
+            dst[j + 0] = T(src[i + 0]);
+            dst[j + 1] = T(src[i + 1]);
+            dst[j + 2] = T(src[i + 2]);
+            dst[j + 3] = T(src[i + 0]);
+            dst[j + 4] = T(src[i + 2]);
+            dst[j + 5] = T(src[i + 3]);
+        }
+    }
+
+    template<class U> void copyIndices(const Containers::ArrayView<const U> src, const Containers::ArrayView<char> dst, const MeshIndexType type, const bool quads) {
+        switch(type) {
+            case MeshIndexType::UnsignedByte:
+                copyIndices(src, Containers::arrayCast<UnsignedByte>(dst), quads);
+                return;
+            case MeshIndexType::UnsignedShort:
+                copyIndices(src, Containers::arrayCast<UnsignedShort>(dst), quads);
+                return;
+            case MeshIndexType::UnsignedInt:
+                copyIndices(src, Containers::arrayCast<UnsignedInt>(dst), quads);
+                return;
+        }
+
+        CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+
+    /* Triangle indices for non-indexed quads, i.e. vertices taken four at a
+       time */
+    template<class T> void quadIndices(const Containers::ArrayView<T> dst) {
+        for(std::size_t i = 0, j = 0; j != dst.size(); i += 4, j += 6) {
+            dst[j + 0] = T(i + 0);
+            dst[j + 1] = T(i + 1);
+            dst[j + 2] = T(i + 2);
+            dst[j + 3] = T(i + 0);
+            dst[j + 4] = T(i + 2);
+            dst[j + 5] = T(i + 3);
+        }
+    }
+
+    MeshIndexType indexTypeFor(const UnsignedLong maxBits) {
+        if(maxBits > 0xffff) return MeshIndexType::UnsignedInt;
+        if(maxBits > 0xff) return MeshIndexType::UnsignedShort;
+        return MeshIndexType::UnsignedByte;
+    }
+
+    /* Converts an unsigned integer array of any type to 32-bit integers */
+    Containers::Array<UnsignedInt> unsignedIntegers(const OpenDdl::Structure data) {
+        Containers::Array<UnsignedInt> out{Containers::NoInit, data.arraySize()};
+        switch(data.type()) {
+            case OpenDdl::Type::UnsignedByte:
+                copyIndices(data.asArray<UnsignedByte>(), Containers::arrayView(out), false);
+                break;
+            case OpenDdl::Type::UnsignedShort:
+                copyIndices(data.asArray<UnsignedShort>(), Containers::arrayView(out), false);
+                break;
+            case OpenDdl::Type::UnsignedInt:
+                copyIndices(data.asArray<UnsignedInt>(), Containers::arrayView(out), false);
+                break;
+            #ifndef CORRADE_TARGET_EMSCRIPTEN
+            case OpenDdl::Type::UnsignedLong:
+                copyIndices(data.asArray<UnsignedLong>(), Containers::arrayView(out), false);
+                break;
+            #endif
+
+            default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        }
+
+        return out;
+    }
+
+    /* Skin joint and weight attributes. Not among builtin attributes yet. */
+    constexpr MeshAttribute JointIdsAttribute = meshAttributeCustom(0);
+    constexpr MeshAttribute WeightsAttribute = meshAttributeCustom(1);
+
+    /* Takes up to four bone influences with the largest weights for each
+       vertex, renormalizing the weights if some influences were dropped */
+    void copySkin(const Containers::ArrayView<const UnsignedInt> counts, const Containers::ArrayView<const UnsignedInt> indices, const Containers::ArrayView<const Float> weights, const Containers::StridedArrayView1D<Vector4ui>& jointIds, const Containers::StridedArrayView1D<Vector4>& jointWeights) {
+        std::size_t offset = 0;
+        for(std::size_t i = 0; i != counts.size(); ++i) {
+            Vector4ui vertexIds;
+            Vector4 vertexWeights;
+
+            /* Insert into the four slots sorted by weight */
+            const UnsignedInt count = counts[i];
+            for(std::size_t j = offset; j != offset + count; ++j) {
+                std::size_t slot = 0;
+                while(slot != 4 && weights[j] <= vertexWeights[slot]) ++slot;
+                if(slot == 4) continue;
+
+                for(std::size_t k = 3; k != slot; --k) {
+                    vertexIds[k] = vertexIds[k - 1];
+                    vertexWeights[k] = vertexWeights[k - 1];
+                }
+                vertexIds[slot] = indices[j];
+                vertexWeights[slot] = weights[j];
+            }
+
+            if(count > 4) {
+                const Float sum = vertexWeights.sum();
+                if(sum != 0.0f) vertexWeights /= sum;
+            }
+
+            jointIds[i] = vertexIds;
+            jointWeights[i] = vertexWeights;
+            offset += count;
+        }
+    }
 }
 
 Containers::Pointer<ObjectData3D> OpenGexImporter::doObject3D(const UnsignedInt id) {
@@ -426,7 +821,7 @@ Containers::Pointer<ObjectData3D> OpenGexImporter::doObject3D(const UnsignedInt
     /* Child node IDs */
     std::vector<UnsignedInt> children;
     for(const OpenDdl::Structure childNode: node.childrenOf(OpenGex::Node, OpenGex::BoneNode, OpenGex::GeometryNode, OpenGex::CameraNode, OpenGex::LightNode))
-        children.push_back(structureId(_d->nodes, childNode));
+        children.push_back(_d->structureId(_d->nodes, childNode));
 
     /* Mesh object */
     if(node.identifier() == OpenGex::GeometryNode) {
@@ -436,14 +831,14 @@ Containers::Pointer<ObjectData3D> OpenGexImporter::doObject3D(const UnsignedInt
             Error() << "Trade::OpenGexImporter::object3D(): null geometry reference";
             return nullptr;
         }
-        const UnsignedInt meshId = structureId(_d->meshes, *mesh);
+        const UnsignedInt meshId = _d->structureId(_d->meshes, *mesh);
 
         /* Material ID, if present */
         /** @todo support more materials per mesh */
         Int materialId = -1;
         if(const auto materialRef = node.findFirstChildOf(OpenGex::MaterialRef))
             if(const auto material = materialRef->firstChildOf(OpenDdl::Type::Reference).asReference())
-                materialId = structureId(_d->materials, *material);
+                materialId = _d->structureId(_d->materials, *material);
 
         return Containers::pointer(new MeshObjectData3D{children, transformation, meshId, materialId, &node});
 
@@ -455,7 +850,7 @@ Containers::Pointer<ObjectData3D> OpenGexImporter::doObject3D(const UnsignedInt
             Error() << "Trade::OpenGexImporter::object3D(): null camera reference";
             return nullptr;
         }
-        const UnsignedInt cameraId = structureId(_d->cameras, *camera);
+        const UnsignedInt cameraId = _d->structureId(_d->cameras, *camera);
 
         return Containers::pointer(new ObjectData3D{children, transformation, ObjectInstanceType3D::Camera, cameraId, &node});
 
@@ -467,7 +862,7 @@ Containers::Pointer<ObjectData3D> OpenGexImporter::doObject3D(const UnsignedInt
             Error() << "Trade::OpenGexImporter::object3D(): null light reference";
             return nullptr;
         }
-        const UnsignedInt lightId = structureId(_d->lights, *light);
+        const UnsignedInt lightId = _d->structureId(_d->lights, *light);
 
         return Containers::pointer(new ObjectData3D{children, transformation, ObjectInstanceType3D::Light, lightId, &node});
     }
@@ -494,6 +889,218 @@ template<class Result> Result extractColorData(const OpenDdl::Structure floatArr
 
 }
 
+UnsignedInt OpenGexImporter::doAnimationCount() const {
+    return _d->animationClips.size();
+}
+
+Int OpenGexImporter::doAnimationForName(const std::string& name) {
+    const auto found = _d->animationsForName.find(name);
+    return found == _d->animationsForName.end() ? -1 : found->second;
+}
+
+std::string OpenGexImporter::doAnimationName(const UnsignedInt id) {
+    for(const OpenDdl::Structure clip: _d->document.childrenOf(OpenGex::Clip)) {
+        const Containers::Optional<OpenDdl::Property> index = clip.findPropertyOf(OpenGex::index);
+        if(UnsignedInt(index ? index->as<Int>() : 0) != _d->animationClips[id])
+            continue;
+
+        if(const auto name = clip.findFirstChildOf(OpenGex::Name))
+            return name->firstChild().as<std::string>();
+    }
+
+    return {};
+}
+
+namespace {
+
+/* Key structure with the actual values, skipping Bézier control points */
+Containers::Optional<OpenDdl::Structure> findValueKey(const OpenDdl::Structure structure) {
+    for(const OpenDdl::Structure key: structure.childrenOf(OpenGex::Key)) {
+        const Containers::Optional<OpenDdl::Property> kind = key.findPropertyOf(OpenGex::kind);
+        if(!kind || kind->as<std::string>() == "value") return key;
+    }
+
+    return Containers::NullOpt;
+}
+
+}
+
+Containers::Optional<AnimationData> OpenGexImporter::doAnimation(const UnsignedInt id) {
+    const UnsignedInt clip = _d->animationClips[id];
+
+    /* First pass, gather and check all tracks belonging to this clip */
+    struct Track {
+        Containers::ArrayView<const Float> keys, values;
+        AnimationTrackTargetType targetType;
+        UnsignedInt target;
+        Animation::Interpolation interpolation;
+    };
+    std::vector<Track> tracks;
+    for(const OpenDdl::Structure node: _d->nodes) {
+        for(const OpenDdl::Structure animation: node.childrenOf(OpenGex::Animation)) {
+            const Containers::Optional<OpenDdl::Property> clipProperty = animation.findPropertyOf(OpenGex::clip);
+            if(UnsignedInt(clipProperty ? clipProperty->as<Int>() : 0) != clip)
+                continue;
+
+            for(const OpenDdl::Structure track: animation.childrenOf(OpenGex::Track)) {
+                /* Target transformation and the node it belongs to */
+                const Containers::Optional<OpenDdl::Structure> target = track.propertyOf(OpenGex::target).asReference();
+                if(!target) {
+                    Error() << "Trade::OpenGexImporter::animation(): null track target";
+                    return Containers::NullOpt;
+                }
+
+                const Containers::Optional<OpenDdl::Structure> targetNode = target->parent();
+                const Int targetId = targetNode ? _d->findStructureId(_d->nodes, *targetNode) : -1;
+                const Containers::Optional<OpenDdl::Property> kind = target->findPropertyOf(OpenGex::kind);
+                AnimationTrackTargetType targetType;
+                std::size_t valueSize;
+                if(targetId != -1 && target->identifier() == OpenGex::Translation && (!kind || kind->as<std::string>() == "xyz")) {
+                    targetType = AnimationTrackTargetType::Translation3D;
+                    valueSize = 3;
+                } else if(targetId != -1 && target->identifier() == OpenGex::Rotation && kind && kind->as<std::string>() == "quaternion") {
+                    targetType = AnimationTrackTargetType::Rotation3D;
+                    valueSize = 4;
+                } else if(targetId != -1 && target->identifier() == OpenGex::Scale && (!kind || kind->as<std::string>() == "xyz")) {
+                    targetType = AnimationTrackTargetType::Scaling3D;
+                    valueSize = 3;
+                } else {
+                    Error() << "Trade::OpenGexImporter::animation(): unsupported track target";
+                    return Containers::NullOpt;
+                }
+
+                /* Time keys */
+                const OpenDdl::Structure time = track.firstChildOf(OpenGex::Time);
+                if(const Containers::Optional<OpenDdl::Property> curve = time.findPropertyOf(OpenGex::curve)) if(curve->as<std::string>() != "linear") {
+                    Error() << "Trade::OpenGexImporter::animation(): unsupported time curve" << curve->as<std::string>();
+                    return Containers::NullOpt;
+                }
+                const Containers::Optional<OpenDdl::Structure> timeKey = findValueKey(time);
+                if(!timeKey || timeKey->firstChild().subArraySize() != 0) {
+                    Error() << "Trade::OpenGexImporter::animation(): invalid time key";
+                    return Containers::NullOpt;
+                }
+
+                /* Values, linear interpolation by default */
+                const OpenDdl::Structure value = track.firstChildOf(OpenGex::Value);
+                Animation::Interpolation interpolation = Animation::Interpolation::Linear;
+                if(const Containers::Optional<OpenDdl::Property> curve = value.findPropertyOf(OpenGex::curve)) {
+                    if(curve->as<std::string>() == "constant")
+                        interpolation = Animation::Interpolation::Constant;
+                    else if(curve->as<std::string>() != "linear") {
+                        Error() << "Trade::OpenGexImporter::animation(): unsupported value curve" << curve->as<std::string>();
+                        return Containers::NullOpt;
+                    }
+                }
+                const Containers::Optional<OpenDdl::Structure> valueKey = findValueKey(value);
+                if(!valueKey || valueKey->firstChild().subArraySize() != valueSize) {
+                    Error() << "Trade::OpenGexImporter::animation(): invalid value key";
+                    return Containers::NullOpt;
+                }
+
+                const Containers::ArrayView<const Float> keys = timeKey->firstChild().asArray<Float>();
+                const Containers::ArrayView<const Float> values = valueKey->firstChild().asArray<Float>();
+                if(values.size() != keys.size()*valueSize) {
+                    Error() << "Trade::OpenGexImporter::animation(): expected" << keys.size() << "values but got" << values.size()/valueSize;
+                    return Containers::NullOpt;
+                }
+
+                tracks.push_back({keys, values, targetType, UnsignedInt(targetId), interpolation});
+            }
+        }
+    }
+
+    /* If the file is Y up and uses the default metrics, the tracks can
+       reference the parsed data directly. Otherwise calculate how much needs
+       to be converted. */
+    const bool convertKeys = _d->timeMultiplier != 1.0f;
+    const bool convertTranslations = !_d->yUp || _d->distanceMultiplier != 1.0f;
+    const bool convertRotationsScalings = !_d->yUp;
+    std::size_t dataSize = 0;
+    for(const Track& track: tracks) {
+        if(convertKeys)
+            dataSize += track.keys.size()*sizeof(Float);
+        if(track.targetType == AnimationTrackTargetType::Translation3D ? convertTranslations : convertRotationsScalings)
+            dataSize += track.values.size()*sizeof(Float);
+    }
+
+    /* Second pass, convert what's needed and create the track views */
+    Containers::Array<char> data{Containers::NoInit, dataSize};
+    Containers::ArrayView<Float> out = Containers::arrayCast<Float>(data);
+    Containers::Array<AnimationTrackData> trackData{tracks.size()};
+    for(std::size_t i = 0; i != tracks.size(); ++i) {
+        const Track& track = tracks[i];
+
+        Containers::ArrayView<const Float> keys = track.keys;
+        if(convertKeys) {
+            const Containers::ArrayView<Float> converted = out.prefix(keys.size());
+            out = out.suffix(keys.size());
+            for(std::size_t j = 0; j != keys.size(); ++j)
+                converted[j] = keys[j]*_d->timeMultiplier;
+            keys = converted;
+        }
+
+        Containers::ArrayView<const Float> values = track.values;
+        if(track.targetType == AnimationTrackTargetType::Translation3D) {
+            if(convertTranslations) {
+                const Containers::ArrayView<Vector3> converted = Containers::arrayCast<Vector3>(out.prefix(values.size()));
+                out = out.suffix(values.size());
+                copyVectors(values, converted, _d->distanceMultiplier, !_d->yUp);
+                values = Containers::arrayCast<const Float>(converted);
+            }
+
+            trackData[i] = AnimationTrackData{AnimationTrackType::Vector3,
+                AnimationTrackType::Vector3, track.targetType, track.target,
+                Animation::TrackView<const Float, const Vector3>{keys,
+                    Containers::arrayCast<const Vector3>(values),
+                    track.interpolation,
+                    animationInterpolatorFor<Vector3>(track.interpolation),
+                    Animation::Extrapolation::Constant}};
+
+        } else if(track.targetType == AnimationTrackTargetType::Rotation3D) {
+            /* Quaternion vector part gets converted the same way as vectors */
+            if(convertRotationsScalings) {
+                const Containers::ArrayView<Quaternion> converted = Containers::arrayCast<Quaternion>(out.prefix(values.size()));
+                out = out.suffix(values.size());
+                for(std::size_t j = 0; j != converted.size(); ++j)
+                    converted[j] = Quaternion{fixVectorZUp(Vector3::from(values + j*4)), values[j*4 + 3]};
+                values = Containers::arrayCast<const Float>(converted);
+            }
+
+            trackData[i] = AnimationTrackData{AnimationTrackType::Quaternion,
+                AnimationTrackType::Quaternion, track.targetType, track.target,
+                Animation::TrackView<const Float, const Quaternion>{keys,
+                    Containers::arrayCast<const Quaternion>(values),
+                    track.interpolation,
+                    animationInterpolatorFor<Quaternion>(track.interpolation),
+                    Animation::Extrapolation::Constant}};
+
+        } else if(track.targetType == AnimationTrackTargetType::Scaling3D) {
+            if(convertRotationsScalings) {
+                const Containers::ArrayView<Vector3> converted = Containers::arrayCast<Vector3>(out.prefix(values.size()));
+                out = out.suffix(values.size());
+                for(std::size_t j = 0; j != converted.size(); ++j)
+                    converted[j] = fixScalingZUp(Vector3::from(values + j*3));
+                values = Containers::arrayCast<const Float>(converted);
+            }
+
+            trackData[i] = AnimationTrackData{AnimationTrackType::Vector3,
+                AnimationTrackType::Vector3, track.targetType, track.target,
+                Animation::TrackView<const Float, const Vector3>{keys,
+                    Containers::arrayCast<const Vector3>(values),
+                    track.interpolation,
+                    animationInterpolatorFor<Vector3>(track.interpolation),
+                    Animation::Extrapolation::Constant}};
+
+        } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+
+    /* Check we pre-calculated well */
+    CORRADE_INTERNAL_ASSERT(out.empty());
+
+    return AnimationData{std::move(data), std::move(trackData)};
+}
+
 UnsignedInt OpenGexImporter::doLightCount() const {
     return _d->lights.size();
 }
@@ -553,12 +1160,29 @@ UnsignedInt OpenGexImporter::doMeshCount() const {
     return _d->meshes.size();
 }
 
+bool OpenGexImporter::parseMeshContents(const UnsignedInt id) {
+    Containers::Pointer<OpenDdl::Document> contents{Containers::InPlaceInit};
+    if(!_d->document.parseDeferred(_d->meshes[id], *contents) || !contents->validate(OpenGex::geometryObjectStructures, OpenGex::structureInfo))
+        return false;
+    _d->meshContents[id] = std::move(contents);
+    return true;
+}
+
 Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, UnsignedInt) {
-    const OpenDdl::Structure& mesh = _d->meshes[id].firstChildOf(OpenGex::Mesh);
+    /* Parse the GeometryObject contents on first access if they were
+       deferred */
+    const OpenDdl::Structure geometry = _d->meshes[id];
+    if(!_d->meshContents[id] && _d->document.isDeferred(geometry) && !parseMeshContents(id))
+        return Containers::NullOpt;
 
-    /* Primitive type, triangles by default */
+    const OpenDdl::Structure mesh = _d->meshContents[id] ?
+        _d->meshContents[id]->firstChildOf(OpenGex::Mesh) :
+        geometry.firstChildOf(OpenGex::Mesh);
+
+    /* Primitive type, triangles by default. Quads are triangulated. */
     std::size_t indexArraySubArraySize = 3;
     MeshPrimitive primitive = MeshPrimitive::Triangles;
+    bool quads = false;
     if(const Containers::Optional<OpenDdl::Property> primitiveProperty = mesh.findPropertyOf(OpenGex::primitive)) {
         auto&& primitiveString = primitiveProperty->as<std::string>();
         if(primitiveString == "points") {
@@ -573,8 +1197,10 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
         } else if(primitiveString == "triangle_strip") {
             primitive = MeshPrimitive::TriangleStrip;
             indexArraySubArraySize = 1;
+        } else if(primitiveString == "quads") {
+            indexArraySubArraySize = 4;
+            quads = true;
         } else if(primitiveString != "triangles") {
-            /** @todo quads */
             Error() << "Trade::OpenGexImporter::mesh(): unsupported primitive" << primitiveString;
             return Containers::NullOpt;
         }
@@ -590,18 +1216,15 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
         if(attrib != "position" && attrib != "normal" && attrib != "texcoord")
             continue;
 
-        /* Doubles were supported before (and converted to floats), I could do
-           a cast now as well but I don't bother as nobody uses this format
-           anymore anyway */
+        /* Doubles are converted to floats */
         const OpenDdl::Structure vertexArrayData = vertexArray.firstChild();
-        if(vertexArrayData.type() != OpenDdl::Type::Float) {
+        if(vertexArrayData.type() != OpenDdl::Type::Float && vertexArrayData.type() != OpenDdl::Type::Double) {
             Error() << "Trade::OpenGexImporter::mesh(): unsupported vertex array type" << vertexArrayData.type();
             return Containers::NullOpt;
         }
 
         if(attrib == "position") {
-            /* 2D positions could be supported too but I don't bother due to
-               the same reason as above */
+            /** @todo 2D positions */
             if(vertexArrayData.subArraySize() != 3) {
                 Error{} << "Trade::OpenGexImporter::mesh(): unsupported position vector size" << vertexArrayData.subArraySize();
                 return Containers::NullOpt;
@@ -639,6 +1262,38 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
         ++attributeCount;
     }
 
+    /* Skin joints and weights, if present */
+    Containers::Array<UnsignedInt> boneCounts, boneIndices;
+    Containers::ArrayView<const Float> boneWeights;
+    const Containers::Optional<OpenDdl::Structure> skin = mesh.findFirstChildOf(OpenGex::Skin);
+    if(skin) {
+        boneCounts = unsignedIntegers(skin->firstChildOf(OpenGex::BoneCountArray).firstChild());
+        boneIndices = unsignedIntegers(skin->firstChildOf(OpenGex::BoneIndexArray).firstChild());
+        boneWeights = skin->firstChildOf(OpenGex::BoneWeightArray).firstChild().asArray<Float>();
+        const std::size_t boneCount = skin->firstChildOf(OpenGex::Skeleton).firstChildOf(OpenGex::BoneRefArray).firstChild().arraySize();
+
+        if(!attributeCount) vertexCount = boneCounts.size();
+        else if(vertexCount != boneCounts.size()) {
+            Error{} << "Trade::OpenGexImporter::mesh(): mismatched vertex count for skin, expected" << vertexCount << "but got" << boneCounts.size();
+            return Containers::NullOpt;
+        }
+
+        std::size_t influenceCount = 0;
+        for(const UnsignedInt count: boneCounts) influenceCount += count;
+        if(boneIndices.size() != influenceCount || boneWeights.size() != influenceCount) {
+            Error{} << "Trade::OpenGexImporter::mesh(): expected" << influenceCount << "skin bone indices and weights but got" << boneIndices.size() << "and" << boneWeights.size();
+            return Containers::NullOpt;
+        }
+
+        for(const UnsignedInt index: boneIndices) if(index >= boneCount) {
+            Error{} << "Trade::OpenGexImporter::mesh(): skin bone index" << index << "out of bounds for" << boneCount << "bones";
+            return Containers::NullOpt;
+        }
+
+        stride += sizeof(Vector4ui) + sizeof(Vector4);
+        attributeCount += 2;
+    }
+
     /* Allocate vertex data, fill attributes */
     Containers::Array<char> vertexData{Containers::NoInit, std::size_t(stride)*vertexCount};
     Containers::Array<MeshAttributeData> attributeData{attributeCount};
@@ -655,9 +1310,10 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
             Containers::StridedArrayView1D<Vector3> positions{vertexData,
                 reinterpret_cast<Vector3*>(vertexData + attributeOffset),
                 vertexCount, stride};
-            Utility::copy(Containers::arrayCast<const Vector3>(vertexArrayData.asArray<Float>()), positions);
-            for(auto& i: positions) i *= _d->distanceMultiplier;
-            if(!_d->yUp) for(auto& i: positions) i = fixVectorZUp(i);
+            if(vertexArrayData.type() == OpenDdl::Type::Float)
+                copyVectors(vertexArrayData.asArray<Float>(), positions, _d->distanceMultiplier, !_d->yUp);
+            else
+                copyVectors(vertexArrayData.asArray<Double>(), positions, _d->distanceMultiplier, !_d->yUp);
 
             attributeData[attributeIndex++] = MeshAttributeData{
                 MeshAttribute::Position, positions};
@@ -668,8 +1324,10 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
             Containers::StridedArrayView1D<Vector3> normals{vertexData,
                 reinterpret_cast<Vector3*>(vertexData + attributeOffset),
                 vertexCount, stride};
-            Utility::copy(Containers::arrayCast<const Vector3>(vertexArrayData.asArray<Float>()), normals);
-            if(!_d->yUp) for(auto& i: normals) i = fixVectorZUp(i);
+            if(vertexArrayData.type() == OpenDdl::Type::Float)
+                copyVectors(vertexArrayData.asArray<Float>(), normals, 1.0f, !_d->yUp);
+            else
+                copyVectors(vertexArrayData.asArray<Double>(), normals, 1.0f, !_d->yUp);
 
             attributeData[attributeIndex++] = MeshAttributeData{
                 MeshAttribute::Normal, normals};
@@ -680,7 +1338,10 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
             Containers::StridedArrayView1D<Vector2> textureCoordinates{vertexData,
                 reinterpret_cast<Vector2*>(vertexData + attributeOffset),
                 vertexCount, stride};
-            Utility::copy(Containers::arrayCast<const Vector2>(vertexArrayData.asArray<Float>()), textureCoordinates);
+            if(vertexArrayData.type() == OpenDdl::Type::Float)
+                copyVectors(vertexArrayData.asArray<Float>(), textureCoordinates);
+            else
+                copyVectors(vertexArrayData.asArray<Double>(), textureCoordinates);
 
             attributeData[attributeIndex++] = MeshAttributeData{
                 MeshAttribute::TextureCoordinates, textureCoordinates};
@@ -690,6 +1351,22 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
         }
     }
 
+    if(skin) {
+        Containers::StridedArrayView1D<Vector4ui> jointIds{vertexData,
+            reinterpret_cast<Vector4ui*>(vertexData + attributeOffset),
+            vertexCount, stride};
+        Containers::StridedArrayView1D<Vector4> weights{vertexData,
+            reinterpret_cast<Vector4*>(vertexData + attributeOffset + sizeof(Vector4ui)),
+            vertexCount, stride};
+        copySkin(boneCounts, boneIndices, boneWeights, jointIds, weights);
+
+        attributeData[attributeIndex++] = MeshAttributeData{
+            JointIdsAttribute, jointIds};
+        attributeData[attributeIndex++] = MeshAttributeData{
+            WeightsAttribute, weights};
+        attributeOffset += sizeof(Vector4ui) + sizeof(Vector4);
+    }
+
     /* Check we pre-calculated well */
     CORRADE_INTERNAL_ASSERT(attributeOffset == std::size_t(stride));
     CORRADE_INTERNAL_ASSERT(attributeIndex == attributeCount);
@@ -705,39 +1382,78 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
             return Containers::NullOpt;
         }
 
+        /* 8-, 16- and 32-bit indices keep their type, 64-bit indices are
+           narrowed to the smallest type that fits them */
+        MeshIndexType indexType;
         switch(indexArrayData.type()) {
-            case OpenDdl::Type::UnsignedByte: {
-                Containers::ArrayView<const UnsignedByte> src =
-                    indexArrayData.asArray<UnsignedByte>();
-                indexData = Containers::Array<char>{src.size()};
-                auto indexData8 = Containers::arrayCast<UnsignedByte>(indexData);
-                Utility::copy(src, indexData8);
-                indices = MeshIndexData{indexData8};
-            } break;
-            case OpenDdl::Type::UnsignedShort: {
-                Containers::ArrayView<const UnsignedShort> src =
-                    indexArrayData.asArray<UnsignedShort>();
-                indexData = Containers::Array<char>{src.size()*2};
-                auto indexData16 = Containers::arrayCast<UnsignedShort>(indexData);
-                Utility::copy(src, indexData16);
-                indices = MeshIndexData{indexData16};
-            } break;
-            case OpenDdl::Type::UnsignedInt: {
-                Containers::ArrayView<const UnsignedInt> src =
-                    indexArrayData.asArray<UnsignedInt>();
-                indexData = Containers::Array<char>{src.size()*4};
-                auto indexData32 = Containers::arrayCast<UnsignedInt>(indexData);
-                Utility::copy(src, indexData32);
-                indices = MeshIndexData{indexData32};
+            case OpenDdl::Type::UnsignedByte:
+                indexType = MeshIndexType::UnsignedByte;
+                break;
+            case OpenDdl::Type::UnsignedShort:
+                indexType = MeshIndexType::UnsignedShort;
+                break;
+            case OpenDdl::Type::UnsignedInt:
+                indexType = MeshIndexType::UnsignedInt;
+                break;
+            #ifndef CORRADE_TARGET_EMSCRIPTEN
+            case OpenDdl::Type::UnsignedLong: {
+                const UnsignedLong maxBits = orIndices(indexArrayData.asArray<UnsignedLong>());
+                if(maxBits > 0xffffffffull) {
+                    Error() << "Trade::OpenGexImporter::mesh(): 64bit indices larger than 32 bits are not supported";
+                    return Containers::NullOpt;
+                }
+                indexType = indexTypeFor(maxBits);
             } break;
+            #endif
+
+            default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        }
+
+        const std::size_t indexCount = quads ? indexArrayData.arraySize()/4*6 : indexArrayData.arraySize();
+        indexData = Containers::Array<char>{Containers::NoInit, indexCount*meshIndexTypeSize(indexType)};
+        switch(indexArrayData.type()) {
+            case OpenDdl::Type::UnsignedByte:
+                copyIndices(indexArrayData.asArray<UnsignedByte>(), indexData, indexType, quads);
+                break;
+            case OpenDdl::Type::UnsignedShort:
+                copyIndices(indexArrayData.asArray<UnsignedShort>(), indexData, indexType, quads);
+                break;
+            case OpenDdl::Type::UnsignedInt:
+                copyIndices(indexArrayData.asArray<UnsignedInt>(), indexData, indexType, quads);
+                break;
             #ifndef CORRADE_TARGET_EMSCRIPTEN
             case OpenDdl::Type::UnsignedLong:
-                Error() << "Trade::OpenGexImporter::mesh(): 64bit indices are not supported";
-                return Containers::NullOpt;
+                copyIndices(indexArrayData.asArray<UnsignedLong>(), indexData, indexType, quads);
+                break;
             #endif
 
             default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
         }
+
+        indices = MeshIndexData{indexType, indexData};
+
+    /* Non-indexed quads need indices generated in order to be triangulated */
+    } else if(quads) {
+        if(vertexCount % 4) {
+            Error() << "Trade::OpenGexImporter::mesh(): quad vertex count" << vertexCount << "is not divisible by 4";
+            return Containers::NullOpt;
+        }
+
+        const MeshIndexType indexType = indexTypeFor(vertexCount ? vertexCount - 1 : 0);
+        indexData = Containers::Array<char>{Containers::NoInit, vertexCount/4*6*meshIndexTypeSize(indexType)};
+        switch(indexType) {
+            case MeshIndexType::UnsignedByte:
+                quadIndices(Containers::arrayCast<UnsignedByte>(indexData));
+                break;
+            case MeshIndexType::UnsignedShort:
+                quadIndices(Containers::arrayCast<UnsignedShort>(indexData));
+                break;
+            case MeshIndexType::UnsignedInt:
+                quadIndices(Containers::arrayCast<UnsignedInt>(indexData));
+                break;
+        }
+
+        indices = MeshIndexData{indexType, indexData};
     }
 
     return MeshData{primitive,
@@ -745,6 +1461,52 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
         std::move(vertexData), std::move(attributeData)};
 }
 
+Containers::Array<Containers::Optional<MeshData>> OpenGexImporter::meshBatch(const Containers::ArrayView<const UnsignedInt> ids) {
+    CORRADE_ASSERT(isOpened(), "Trade::OpenGexImporter::meshBatch(): no file opened", {});
+
+    /* The document is not modified after opening, the only mutable state
+       touched by doMesh() are the lazily parsed GeometryObject contents. Parse
+       those first, each mesh exactly once, so the actual import only reads
+       and repeated IDs can be imported on different threads. */
+    Containers::Array<bool> parse{Containers::ValueInit, _d->meshes.size()};
+    Containers::Array<UnsignedInt> parseIds{Containers::NoInit, ids.size()};
+    std::size_t parseCount = 0;
+    for(const UnsignedInt id: ids) {
+        CORRADE_ASSERT(id < _d->meshes.size(),
+            "Trade::OpenGexImporter::meshBatch(): index" << id << "out of range for" << _d->meshes.size() << "entries", {});
+        if(parse[id] || _d->meshContents[id] || !_d->document.isDeferred(_d->meshes[id])) continue;
+        parse[id] = true;
+        parseIds[parseCount++] = id;
+    }
+
+    const UnsignedInt threadCount = configuration().value<UnsignedInt>("meshThreads");
+
+    /* Meshes that failed to parse stay marked in parse[] and are skipped by
+       the import */
+    Magnum::Implementation::parallelFor(threadCount, parseCount, [&](std::size_t i) {
+        if(parseMeshContents(parseIds[i])) parse[parseIds[i]] = false;
+    });
+
+    Containers::Array<Containers::Optional<MeshData>> out{Containers::ValueInit, ids.size()};
+    Magnum::Implementation::parallelFor(threadCount, ids.size(), [&](std::size_t i) {
+        if(!parse[ids[i]]) out[i] = doMesh(ids[i], 0);
+    });
+
+    return out;
+}
+
+MeshAttribute OpenGexImporter::doMeshAttributeForName(const std::string& name) {
+    if(name == "JointIds") return JointIdsAttribute;
+    if(name == "Weights") return WeightsAttribute;
+    return {};
+}
+
+std::string OpenGexImporter::doMeshAttributeName(const UnsignedShort name) {
+    if(meshAttributeCustom(name) == JointIdsAttribute) return "JointIds";
+    if(meshAttributeCustom(name) == WeightsAttribute) return "Weights";
+    return {};
+}
+
 UnsignedInt OpenGexImporter::doMaterialCount() const { return _d->materials.size(); }
 
 Int OpenGexImporter::doMaterialForName(const std::string& name) {
@@ -766,10 +1528,10 @@ Containers::Pointer<AbstractMaterialData> OpenGexImporter::doMaterial(const Unsi
     for(const OpenDdl::Structure texture: material.childrenOf(OpenGex::Texture)) {
         const auto& attrib = texture.propertyOf(OpenGex::attrib).as<std::string>();
         if(attrib == "diffuse") {
-            diffuseTexture = structureId(_d->textures, texture);
+            diffuseTexture = _d->structureId(_d->textures, texture);
             flags |= PhongMaterialData::Flag::DiffuseTexture;
         } else if(attrib == "specular") {
-            specularTexture = structureId(_d->textures, texture);
+            specularTexture = _d->structureId(_d->textures, texture);
             flags |= PhongMaterialData::Flag::SpecularTexture;
         }
     }
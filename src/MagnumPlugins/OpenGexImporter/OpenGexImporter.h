@@ -59,7 +59,8 @@ namespace Magnum { namespace Trade {
 Imports the [OpenDDL](http://openddl.org)-based [OpenGEX](http://opengex.org)
 format.
 
-Supports importing of scene, object, camera, mesh, texture and image data.
+Supports importing of scene, object, animation, camera, mesh, texture and
+image data.
 
 @section Trade-OpenGexImporter-usage Usage
 
@@ -112,10 +113,42 @@ are loaded on-demand inside @ref image2D() calls with
 @ref InputFileCallbackPolicy::Close is emitted right after the file is fully
 read.
 
--   Import of animation data is not supported at the moment.
+-   The file is parsed on the calling thread by default. Setting the
+    @cb{.ini} parseThreads @ce
+    @ref Trade-OpenGexImporter-configuration "configuration option" to a
+    value other than @cpp 1 @ce parses top-level structures on multiple
+    threads, see @ref OpenDdl::Document::parse(Containers::ArrayView<const char>, std::initializer_list<CharacterLiteral>, std::initializer_list<CharacterLiteral>, UnsignedInt)
+    for details. In that case the *application* has to be linked to
+    `pthread`.
+-   Setting the @cb{.ini} binaryCache @ce
+    @ref Trade-OpenGexImporter-configuration "configuration option" to
+    @cpp true @ce makes @ref openFile() save the parsed document into a
+    `*.oddlcache` file next to the opened file using
+    @ref OpenDdl::Document::serialize(), together with the file size and
+    modification time. On subsequent opens, if both match, the cache file is
+    memory-mapped and loaded with @ref OpenDdl::Document::deserialize()
+    instead of parsing the file again, without reading the file itself. On
+    filesystems with coarse modification time resolution, a change that
+    doesn't alter the file size could go unnoticed. Enabling the
+    @cb{.ini} binaryCacheHashContents @ce option makes the cache keyed by a
+    SHA-1 digest of the file contents instead, at the cost of reading the
+    whole file on every open. An invalid or outdated cache is silently
+    replaced. The cache is not used with @ref openData(), if a file callback
+    is set or on platforms without memory-mapping support.
+-   Setting the @cb{.ini} lazyMeshes @ce
+    @ref Trade-OpenGexImporter-configuration "configuration option" to
+    @cpp true @ce makes the importer skip contents of all `GeometryObject`
+    structures during opening and parse them only on the first @ref mesh()
+    call for given mesh, using @ref OpenDdl::Document::setDeferredStructures().
+    A copy of the file data is kept in memory for that. Errors in the mesh
+    data are then reported only from @ref mesh(), with line numbers relative
+    to the `GeometryObject` contents. A `GeometryObject` that contains
+    references, such as a `Skin` referencing bone nodes, is always parsed
+    during opening, as the references point outside of its contents. If
+    the file is opened through the binary cache described above, the option
+    is ignored, as the serialized document needs to have everything parsed.
 -   `half` data type results in parsing error.
--   On OpenGL ES, usage of double type and on WebGL additionally also usage of
-    64bit integer types results in parsing error.
+-   On WebGL, usage of 64bit integer types results in parsing error.
 
 @subsection Trade-OpenGexImporter-behavior-scenes Scene hierarchy import
 
@@ -124,6 +157,27 @@ read.
     are ignored.
 -   Geometry node visibility, shadow and motion blur properties are ignored.
 
+@subsection Trade-OpenGexImporter-behavior-animations Animation import
+
+-   All `Animation` structures with the same `clip` index form one
+    animation, ordered by the clip index. Names are taken from the `Name`
+    of a `Clip` structure with a matching `index`.
+-   Only tracks targeting `Translation` and `Scale` of the `xyz` kind and
+    `Rotation` of the `quaternion` kind are supported, imported as
+    @ref AnimationTrackTargetType::Translation3D,
+    @ref AnimationTrackTargetType::Scaling3D and
+    @ref AnimationTrackTargetType::Rotation3D of the node containing the
+    target structure.
+-   Only the `linear` time curve and `constant` and `linear` value curves are
+    supported, Bézier and TCB curves are not.
+-   The `begin` and `end` properties are ignored, animation duration is
+    calculated from the track keys.
+-   If the file is Y up and has default distance and time metrics, the
+    track keys and values reference the parsed document directly without
+    making any copy and the returned @ref AnimationData are valid only until
+    the file is closed. Otherwise the data are converted into a newly
+    allocated array.
+
 @subsection Trade-OpenGexImporter-behavior-camera Camera import
 
 -   Camera type is always @ref CameraType::Perspective3D
@@ -139,21 +193,63 @@ read.
 
 @subsection Trade-OpenGexImporter-behavior-meshes Mesh import
 
--   Quads are not supported.
+-   Quads are triangulated, each quad @f$ (a, b, c, d) @f$ is split into
+    triangles @f$ (a, b, c) @f$ and @f$ (a, c, d) @f$. If a quad mesh is not
+    indexed, indices are generated for it.
 -   Additional mesh LoDs after the first one are ignored.
 -   `w` coordinate for vertex positions and normals is ignored if present.
 -   Positions and normals are always imported as @ref VertexFormat::Vector3,
     texture coordinates as @ref VertexFormat::Vector2. Positions and normals of
     a different component count than 3 and texture coordinates of a different
-    component count than 2 are not supported. Only floats are supported,
-    doubles not.
+    component count than 2 are not supported. Doubles are converted to
+    floats.
 -   Indices are imported as either @ref MeshIndexType::UnsignedByte,
     @ref MeshIndexType::UnsignedShort or @ref MeshIndexType::UnsignedInt.
-    64-bit indices are not supported.
+    64-bit indices are narrowed to the smallest of these types that can hold
+    all index values, indices not fitting into 32 bits are not supported.
+
+-   If the mesh has a `Skin`, up to four bone influences per vertex are
+    imported as a custom @cpp "JointIds" @ce attribute of
+    @ref VertexFormat::Vector4ui and a custom @cpp "Weights" @ce attribute of
+    @ref VertexFormat::Vector4, see @ref AbstractImporter::meshAttributeForName().
+    The joint IDs index the `BoneRefArray` of the mesh `Skeleton`, which is
+    accessible through the @ref OpenDdl::Document. If a vertex has more than
+    four influences, the four with the largest weights are taken and
+    renormalized. Unused influences have both the ID and the weight zero.
 
 The imported mesh always has at least one vertex attribute, but positions are
 not required to be present. Indices are optional as well.
 
+@subsubsection Trade-OpenGexImporter-behavior-meshes-parallel Parallel mesh import
+
+The parsed @ref OpenDdl::Document is not modified after the file is opened,
+so @ref mesh() can be called for different mesh IDs from multiple threads at
+once, also with the @cb{.ini} lazyMeshes @ce option enabled, as the lazily
+parsed contents are stored separately for each mesh. With
+@cb{.ini} lazyMeshes @ce enabled, importing the same mesh ID from multiple
+threads at once is not safe unless it was already imported before. Opening
+and closing the file, changing the configuration and all other data accessors,
+in particular @ref image2D() which reuses a single image importer instance,
+are not safe to be called in parallel with any other function.
+
+If you use this class directly (and not through a plugin manager), it's
+possible to import multiple meshes at once using @ref meshBatch(), which
+handles repeated mesh IDs and lazily parsed meshes on its own. The meshes are
+imported on @cb{.ini} meshThreads @ce threads. Setting the
+@ref Trade-OpenGexImporter-configuration "configuration option" to
+@cpp 0 @ce uses the value of @ref std::thread::hardware_concurrency(),
+@cpp 1 @ce, which is the default, imports everything on the calling thread.
+On @ref CORRADE_TARGET_EMSCRIPTEN "Emscripten" the import is always done on
+the calling thread. The call blocks until all meshes are imported. Similarly
+to the @cb{.ini} parseThreads @ce option, if set to a value other than
+@cpp 1 @ce, on Linux the *application* has to be linked to `pthread` for the
+threads to be created successfully:
+
+@code{.cmake}
+find_package(Threads REQUIRED)
+target_link_libraries(your-application PRIVATE Threads::Threads)
+@endcode
+
 @subsection Trade-OpenGexImporter-behavior-materials Material import
 
 -   Alpha mode is always @ref MaterialAlphaMode::Opaque and alpha mask always
@@ -176,7 +272,14 @@ not required to be present. Indices are optional as well.
     present in the image list only once. Note that only a simple string
     comparison is used without any path normalization.
 
-@subsection Trade-OpenGexImporter-state Access to internal importer state
+@section Trade-OpenGexImporter-configuration Plugin-specific config
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values.
+
+@snippet MagnumPlugins/OpenGexImporter/OpenGexImporter.conf config
+
+@section Trade-OpenGexImporter-state Access to internal importer state
 
 Generic importer for OpenDDL files is implemented in the @ref OpenDdl::Document
 class available as part of this plugin and access to it is provided through
@@ -230,6 +333,19 @@ class MAGNUM_OPENGEXIMPORTER_EXPORT OpenGexImporter: public AbstractImporter {
             return static_cast<const OpenDdl::Document*>(AbstractImporter::importerState());
         }
 
+        /**
+         * @brief Import multiple meshes in parallel
+         * @param ids       Mesh IDs, each expected to be less than
+         *      @ref meshCount()
+         *
+         * Equivalent to calling @ref mesh() for each ID in @p ids, but with
+         * the meshes imported in parallel. The items are in the same order as
+         * @p ids, failed imports are set to @ref Containers::NullOpt. See
+         * @ref Trade-OpenGexImporter-behavior-meshes-parallel for more
+         * information.
+         */
+        Containers::Array<Containers::Optional<MeshData>> meshBatch(Containers::ArrayView<const UnsignedInt> ids);
+
     private:
         struct Document;
 
@@ -240,10 +356,18 @@ class MAGNUM_OPENGEXIMPORTER_EXPORT OpenGexImporter: public AbstractImporter {
         MAGNUM_OPENGEXIMPORTER_LOCAL void doOpenFile(const std::string& filename) override;
         MAGNUM_OPENGEXIMPORTER_LOCAL void doClose() override;
 
+        MAGNUM_OPENGEXIMPORTER_LOCAL void parseDocument(Containers::ArrayView<const char> data, bool lazyMeshes);
+        MAGNUM_OPENGEXIMPORTER_LOCAL void openDocument(Containers::Pointer<Document>&& d);
+
         MAGNUM_OPENGEXIMPORTER_LOCAL Int doDefaultScene() override;
         MAGNUM_OPENGEXIMPORTER_LOCAL UnsignedInt doSceneCount() const override;
         MAGNUM_OPENGEXIMPORTER_LOCAL Containers::Optional<SceneData> doScene(UnsignedInt id) override;
 
+        MAGNUM_OPENGEXIMPORTER_LOCAL UnsignedInt doAnimationCount() const override;
+        MAGNUM_OPENGEXIMPORTER_LOCAL Int doAnimationForName(const std::string& name) override;
+        MAGNUM_OPENGEXIMPORTER_LOCAL std::string doAnimationName(UnsignedInt id) override;
+        MAGNUM_OPENGEXIMPORTER_LOCAL Containers::Optional<AnimationData> doAnimation(UnsignedInt id) override;
+
         MAGNUM_OPENGEXIMPORTER_LOCAL UnsignedInt doCameraCount() const override;
         MAGNUM_OPENGEXIMPORTER_LOCAL Containers::Optional<CameraData> doCamera(UnsignedInt id) override;
 
@@ -256,7 +380,10 @@ class MAGNUM_OPENGEXIMPORTER_EXPORT OpenGexImporter: public AbstractImporter {
         MAGNUM_OPENGEXIMPORTER_LOCAL Containers::Optional<LightData> doLight(UnsignedInt id) override;
 
         MAGNUM_OPENGEXIMPORTER_LOCAL UnsignedInt doMeshCount() const override;
+        MAGNUM_OPENGEXIMPORTER_LOCAL bool parseMeshContents(UnsignedInt id);
         MAGNUM_OPENGEXIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
+        MAGNUM_OPENGEXIMPORTER_LOCAL MeshAttribute doMeshAttributeForName(const std::string& name) override;
+        MAGNUM_OPENGEXIMPORTER_LOCAL std::string doMeshAttributeName(UnsignedShort name) override;
 
         MAGNUM_OPENGEXIMPORTER_LOCAL UnsignedInt doMaterialCount() const override;
         MAGNUM_OPENGEXIMPORTER_LOCAL Int doMaterialForName(const std::string& name) override;
@@ -26,19 +26,25 @@
 
 #include <sstream>
 #include <unordered_map>
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+#include <thread>
+#endif
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/FormatStl.h>
 #include <Corrade/Utility/String.h>
 #include <Magnum/FileCallback.h>
 #include <Magnum/Mesh.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/VertexFormat.h>
 #include <Magnum/Math/Quaternion.h>
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/AnimationData.h>
 #include <Magnum/Trade/ImageData.h>
 #include <Magnum/Trade/MeshData.h>
 #include <Magnum/Trade/MeshObjectData3D.h>
@@ -53,13 +59,60 @@
 #include "Magnum/OpenDdl/Property.h"
 #include "Magnum/OpenDdl/Structure.h"
 #include "MagnumPlugins/OpenGexImporter/OpenGex.h"
+#include "MagnumPlugins/OpenGexImporter/openGexSpec.hpp"
 
 #include "configure.h"
 
+#if defined(CORRADE_TARGET_UNIX) && !defined(CORRADE_TARGET_EMSCRIPTEN)
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+#ifndef OPENGEXIMPORTER_PLUGIN_FILENAME
+#include "MagnumPlugins/OpenGexImporter/OpenGexImporter.h"
+#endif
+
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
 using namespace Magnum::Math::Literals;
 
+constexpr struct {
+    const char* name;
+    bool lazyMeshes;
+} MeshSkinData[]{
+    {"", false},
+    {"lazy meshes", true}
+};
+
+constexpr struct {
+    const char* name;
+    UnsignedInt threads;
+    bool lazyMeshes;
+} MeshBatchData[]{
+    {"single-threaded", 1, false},
+    {"hardware concurrency", 0, false},
+    {"three threads", 3, false},
+    {"three threads, lazy meshes", 3, true}
+};
+
+constexpr struct {
+    const char* name;
+    bool lazyMeshes;
+} MeshThreadsData[]{
+    {"", false},
+    {"lazy meshes", true}
+};
+
+/* Importing all objects should take time linear in their count */
+constexpr struct {
+    const char* name;
+    UnsignedInt count;
+} BenchmarkObject3DData[]{
+    {"1k nodes", 1000},
+    {"10k nodes", 10000},
+    {"100k nodes", 100000}
+};
+
 struct OpenGexImporterTest: public TestSuite::Tester {
     explicit OpenGexImporterTest();
 
@@ -67,6 +120,9 @@ struct OpenGexImporterTest: public TestSuite::Tester {
     void openParseError();
     void openValidationError();
     void openInvalidMetric();
+    void openParseThreads();
+    void openBinaryCache();
+    void openBinaryCacheHashContents();
 
     void camera();
     void cameraMetrics();
@@ -83,17 +139,37 @@ struct OpenGexImporterTest: public TestSuite::Tester {
     void objectTransformationConcatentation();
     void objectTransformationMetrics();
 
+    void animation();
+    void animationMetrics();
+    void animationInvalid();
+
     void light();
     void lightInvalid();
 
     void mesh();
     void meshIndexed();
+    void meshQuads();
+    void meshQuadsNotIndexed();
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    void meshIndices64();
+    #endif
+    void meshDouble();
+    void meshSkin();
     void meshMetrics();
+    void meshLazy();
+    void meshLazyInvalid();
+    void meshBatch();
+    void meshBatchInvalid();
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    void meshThreads();
+    #endif
 
     void meshInvalidPrimitive();
     void meshUnsupportedSize();
     void meshMismatchedSizes();
     void meshInvalidIndexArraySubArraySize();
+    void meshInvalidQuadVertexCount();
+    void meshInvalidSkin();
     #ifndef CORRADE_TARGET_EMSCRIPTEN
     void meshUnsupportedIndexType();
     #endif
@@ -117,6 +193,9 @@ struct OpenGexImporterTest: public TestSuite::Tester {
     void fileCallbackImage();
     void fileCallbackImageNotFound();
 
+    void benchmarkMesh();
+    void benchmarkObject3D();
+
     /* Needs to load AnyImageImporter from system-wide location */
     PluginManager::Manager<AbstractImporter> _manager;
 };
@@ -126,6 +205,9 @@ OpenGexImporterTest::OpenGexImporterTest() {
               &OpenGexImporterTest::openParseError,
               &OpenGexImporterTest::openValidationError,
               &OpenGexImporterTest::openInvalidMetric,
+              &OpenGexImporterTest::openParseThreads,
+              &OpenGexImporterTest::openBinaryCache,
+              &OpenGexImporterTest::openBinaryCacheHashContents,
 
               &OpenGexImporterTest::camera,
               &OpenGexImporterTest::cameraMetrics,
@@ -142,17 +224,45 @@ OpenGexImporterTest::OpenGexImporterTest() {
               &OpenGexImporterTest::objectTransformationConcatentation,
               &OpenGexImporterTest::objectTransformationMetrics,
 
+              &OpenGexImporterTest::animation,
+              &OpenGexImporterTest::animationMetrics,
+              &OpenGexImporterTest::animationInvalid,
+
               &OpenGexImporterTest::light,
               &OpenGexImporterTest::lightInvalid,
 
               &OpenGexImporterTest::mesh,
               &OpenGexImporterTest::meshIndexed,
-              &OpenGexImporterTest::meshMetrics,
+              &OpenGexImporterTest::meshQuads,
+              &OpenGexImporterTest::meshQuadsNotIndexed,
+              #ifndef CORRADE_TARGET_EMSCRIPTEN
+              &OpenGexImporterTest::meshIndices64,
+              #endif
+              &OpenGexImporterTest::meshDouble});
+
+    addInstancedTests({&OpenGexImporterTest::meshSkin},
+        Containers::arraySize(MeshSkinData));
+
+    addTests({&OpenGexImporterTest::meshMetrics,
+              &OpenGexImporterTest::meshLazy,
+              &OpenGexImporterTest::meshLazyInvalid});
 
-              &OpenGexImporterTest::meshInvalidPrimitive,
+    addInstancedTests({&OpenGexImporterTest::meshBatch},
+        Containers::arraySize(MeshBatchData));
+
+    addTests({&OpenGexImporterTest::meshBatchInvalid});
+
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    addInstancedTests({&OpenGexImporterTest::meshThreads},
+        Containers::arraySize(MeshThreadsData));
+    #endif
+
+    addTests({&OpenGexImporterTest::meshInvalidPrimitive,
               &OpenGexImporterTest::meshUnsupportedSize,
               &OpenGexImporterTest::meshMismatchedSizes,
               &OpenGexImporterTest::meshInvalidIndexArraySubArraySize,
+              &OpenGexImporterTest::meshInvalidQuadVertexCount,
+              &OpenGexImporterTest::meshInvalidSkin,
               #ifndef CORRADE_TARGET_EMSCRIPTEN
               &OpenGexImporterTest::meshUnsupportedIndexType,
               #endif
@@ -176,6 +286,11 @@ OpenGexImporterTest::OpenGexImporterTest() {
               &OpenGexImporterTest::fileCallbackImage,
               &OpenGexImporterTest::fileCallbackImageNotFound});
 
+    addBenchmarks({&OpenGexImporterTest::benchmarkMesh}, 5);
+
+    addInstancedBenchmarks({&OpenGexImporterTest::benchmarkObject3D}, 5,
+        Containers::arraySize(BenchmarkObject3DData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. It also pulls in the AnyImageImporter dependency. Reset
        the plugin dir after so it doesn't load anything else from the
@@ -246,6 +361,151 @@ Metric (key = "distance") { string { "0.5" } }
     CORRADE_COMPARE(out.str(), "Trade::OpenGexImporter::openData(): invalid value for distance metric\n");
 }
 
+void OpenGexImporterTest::openParseThreads() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("parseThreads", 4);
+
+    /* The nodes reference geometry objects and materials that end up being
+       parsed on other threads */
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "object-geometry.ogex")));
+    CORRADE_COMPARE(importer->object3DCount(), 4);
+
+    Containers::Pointer<ObjectData3D> object = importer->object3D(0);
+    CORRADE_VERIFY(object);
+    CORRADE_COMPARE(object->instanceType(), ObjectInstanceType3D::Mesh);
+
+    auto&& meshObject = static_cast<MeshObjectData3D&>(*object);
+    CORRADE_COMPARE(meshObject.instance(), 1);
+    CORRADE_COMPARE(meshObject.material(), 2);
+}
+
+void OpenGexImporterTest::openBinaryCache() {
+    #if !defined(CORRADE_TARGET_UNIX) && !(defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    CORRADE_SKIP("The binary cache is not available on this platform.");
+    #else
+    const std::string filename = Utility::Directory::join(OPENGEXIMPORTER_WRITE_TEST_DIR, "binary-cache.ogex");
+    const std::string cacheFilename = filename + ".oddlcache";
+    const std::string otherFilename = Utility::Directory::join(OPENGEXIMPORTER_WRITE_TEST_DIR, "binary-cache-other.ogex");
+    const std::string otherCacheFilename = otherFilename + ".oddlcache";
+    CORRADE_VERIFY(Utility::Directory::mkpath(OPENGEXIMPORTER_WRITE_TEST_DIR));
+    for(const std::string& file: {cacheFilename, otherCacheFilename})
+        if(Utility::Directory::exists(file)) CORRADE_VERIFY(Utility::Directory::rm(file));
+    CORRADE_VERIFY(Utility::Directory::copy(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "object-geometry.ogex"), filename));
+    CORRADE_VERIFY(Utility::Directory::copy(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "camera.ogex"), otherFilename));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("binaryCache", true);
+
+    /* The first open parses the file and saves the cache */
+    CORRADE_VERIFY(importer->openFile(filename));
+    CORRADE_COMPARE(importer->object3DCount(), 4);
+    CORRADE_COMPARE(importer->cameraCount(), 0);
+    CORRADE_VERIFY(Utility::Directory::exists(cacheFilename));
+    CORRADE_VERIFY(importer->openFile(otherFilename));
+    CORRADE_VERIFY(Utility::Directory::exists(otherCacheFilename));
+
+    #if defined(CORRADE_TARGET_UNIX) && !defined(CORRADE_TARGET_EMSCRIPTEN)
+    /* Overwrite the file with the same amount of garbage and restore its
+       modification time. The cache then gets used without reading the file
+       at all. */
+    struct stat st;
+    CORRADE_VERIFY(stat(filename.data(), &st) == 0);
+    const std::string garbage(st.st_size, '{');
+    CORRADE_VERIFY(Utility::Directory::writeString(filename, garbage));
+    #ifdef CORRADE_TARGET_APPLE
+    const timespec times[]{st.st_atimespec, st.st_mtimespec};
+    #else
+    const timespec times[]{st.st_atim, st.st_mtim};
+    #endif
+    CORRADE_VERIFY(utimensat(AT_FDCWD, filename.data(), times, 0) == 0);
+    CORRADE_VERIFY(importer->openFile(filename));
+    CORRADE_COMPARE(importer->object3DCount(), 4);
+    CORRADE_COMPARE(importer->cameraCount(), 0);
+
+    /* Writing the file again without restoring the modification time makes
+       the cache outdated even though the size is the same, so the garbage is
+       now parsed */
+    CORRADE_VERIFY(Utility::Directory::writeString(filename, garbage));
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->openFile(filename));
+    }
+    CORRADE_VERIFY(Utility::Directory::copy(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "object-geometry.ogex"), filename));
+    #endif
+
+    /* A cache made from a different file is not used */
+    CORRADE_VERIFY(Utility::Directory::copy(otherCacheFilename, cacheFilename));
+    CORRADE_VERIFY(importer->openFile(filename));
+    CORRADE_COMPARE(importer->object3DCount(), 4);
+    CORRADE_COMPARE(importer->cameraCount(), 0);
+
+    /* An invalid cache is silently replaced */
+    CORRADE_VERIFY(Utility::Directory::writeString(cacheFilename, "invalid"));
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(importer->openFile(filename));
+        CORRADE_COMPARE(out.str(), "");
+    }
+    CORRADE_COMPARE(importer->object3DCount(), 4);
+    CORRADE_COMPARE(importer->cameraCount(), 0);
+    CORRADE_COMPARE_AS(Utility::Directory::read(cacheFilename).size(), std::size_t{7},
+        TestSuite::Compare::Greater);
+    #endif
+}
+
+void OpenGexImporterTest::openBinaryCacheHashContents() {
+    #if !defined(CORRADE_TARGET_UNIX) && !(defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    CORRADE_SKIP("The binary cache is not available on this platform.");
+    #else
+    const std::string filename = Utility::Directory::join(OPENGEXIMPORTER_WRITE_TEST_DIR, "binary-cache-hash.ogex");
+    const std::string cacheFilename = filename + ".oddlcache";
+    const std::string otherFilename = Utility::Directory::join(OPENGEXIMPORTER_WRITE_TEST_DIR, "binary-cache-hash-other.ogex");
+    const std::string otherCacheFilename = otherFilename + ".oddlcache";
+    CORRADE_VERIFY(Utility::Directory::mkpath(OPENGEXIMPORTER_WRITE_TEST_DIR));
+    for(const std::string& file: {cacheFilename, otherCacheFilename})
+        if(Utility::Directory::exists(file)) CORRADE_VERIFY(Utility::Directory::rm(file));
+    CORRADE_VERIFY(Utility::Directory::copy(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "object-geometry.ogex"), filename));
+    CORRADE_VERIFY(Utility::Directory::copy(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "camera.ogex"), otherFilename));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("binaryCache", true);
+    importer->configuration().setValue("binaryCacheHashContents", true);
+
+    CORRADE_VERIFY(importer->openFile(filename));
+    CORRADE_VERIFY(Utility::Directory::exists(cacheFilename));
+    CORRADE_VERIFY(importer->openFile(otherFilename));
+    CORRADE_VERIFY(Utility::Directory::exists(otherCacheFilename));
+
+    /* Replace the cache with a different document made for the same file
+       contents to verify it's used instead of parsing the file */
+    {
+        OpenDdl::Document other;
+        const Containers::Array<char> otherData = Utility::Directory::read(otherFilename);
+        CORRADE_VERIFY(other.parse(otherData, OpenGex::structures, OpenGex::properties));
+        CORRADE_VERIFY(Utility::Directory::write(cacheFilename, other.serialize(Utility::Directory::read(filename))));
+    }
+    CORRADE_VERIFY(importer->openFile(filename));
+    CORRADE_COMPARE(importer->object3DCount(), 0);
+    CORRADE_COMPARE(importer->cameraCount(), 2);
+
+    /* Writing the same contents again changes the modification time, but the
+       cache is still used */
+    CORRADE_VERIFY(Utility::Directory::copy(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "object-geometry.ogex"), filename));
+    CORRADE_VERIFY(importer->openFile(filename));
+    CORRADE_COMPARE(importer->object3DCount(), 0);
+    CORRADE_COMPARE(importer->cameraCount(), 2);
+
+    /* A cache made from different file contents is not used, regardless of
+       the modification time */
+    CORRADE_VERIFY(Utility::Directory::copy(otherCacheFilename, cacheFilename));
+    CORRADE_VERIFY(importer->openFile(filename));
+    CORRADE_COMPARE(importer->object3DCount(), 4);
+    CORRADE_COMPARE(importer->cameraCount(), 0);
+    #endif
+}
+
 void OpenGexImporterTest::camera() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "camera.ogex")));
@@ -632,6 +892,127 @@ void OpenGexImporterTest::objectTransformationMetrics() {
     }
 }
 
+void OpenGexImporterTest::animation() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "animation.ogex")));
+
+    /* One animation for each clip index, ordered by it */
+    CORRADE_COMPARE(importer->animationCount(), 2);
+    CORRADE_COMPARE(importer->animationName(0), "");
+    CORRADE_COMPARE(importer->animationName(1), "scaling");
+    CORRADE_COMPARE(importer->animationForName("scaling"), 1);
+    CORRADE_COMPARE(importer->animationForName("nonexistent"), -1);
+
+    {
+        Containers::Optional<AnimationData> animation = importer->animation(0);
+        CORRADE_VERIFY(animation);
+
+        /* Y up and default metrics, so the data are referenced directly */
+        CORRADE_VERIFY(animation->data().empty());
+        CORRADE_COMPARE(animation->trackCount(), 2);
+        CORRADE_COMPARE(animation->duration(), (Range1D{0.0f, 2.0f}));
+
+        CORRADE_COMPARE(animation->trackType(0), AnimationTrackType::Vector3);
+        CORRADE_COMPARE(animation->trackResultType(0), AnimationTrackType::Vector3);
+        CORRADE_COMPARE(animation->trackTargetType(0), AnimationTrackTargetType::Translation3D);
+        CORRADE_COMPARE(animation->trackTarget(0), 0);
+        Animation::TrackView<const Float, const Vector3> translation = animation->track<Vector3>(0);
+        CORRADE_COMPARE(translation.interpolation(), Animation::Interpolation::Linear);
+        const Float translationKeys[]{0.0f, 1.0f, 2.0f};
+        const Vector3 translationValues[]{
+            {1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}, {7.0f, 8.0f, 9.0f}
+        };
+        CORRADE_COMPARE_AS(translation.keys(), (Containers::StridedArrayView1D<const Float>{translationKeys}), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(translation.values(), (Containers::StridedArrayView1D<const Vector3>{translationValues}), TestSuite::Compare::Container);
+        CORRADE_COMPARE(translation.at(0.5f), (Vector3{2.5f, 3.5f, 4.5f}));
+
+        CORRADE_COMPARE(animation->trackType(1), AnimationTrackType::Quaternion);
+        CORRADE_COMPARE(animation->trackResultType(1), AnimationTrackType::Quaternion);
+        CORRADE_COMPARE(animation->trackTargetType(1), AnimationTrackTargetType::Rotation3D);
+        CORRADE_COMPARE(animation->trackTarget(1), 0);
+        Animation::TrackView<const Float, const Quaternion> rotation = animation->track<Quaternion>(1);
+        CORRADE_COMPARE(rotation.interpolation(), Animation::Interpolation::Constant);
+        const Float rotationKeys[]{0.5f, 1.5f};
+        const Quaternion rotationValues[]{
+            {}, {{1.0f, 0.0f, 0.0f}, 0.0f}
+        };
+        CORRADE_COMPARE_AS(rotation.keys(), (Containers::StridedArrayView1D<const Float>{rotationKeys}), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(rotation.values(), (Containers::StridedArrayView1D<const Quaternion>{rotationValues}), TestSuite::Compare::Container);
+    } {
+        Containers::Optional<AnimationData> animation = importer->animation(1);
+        CORRADE_VERIFY(animation);
+        CORRADE_COMPARE(animation->trackCount(), 1);
+
+        CORRADE_COMPARE(animation->trackTargetType(0), AnimationTrackTargetType::Scaling3D);
+        CORRADE_COMPARE(animation->trackTarget(0), 0);
+        Animation::TrackView<const Float, const Vector3> scaling = animation->track<Vector3>(0);
+        const Float scalingKeys[]{0.0f, 3.0f};
+        const Vector3 scalingValues[]{
+            {1.0f, 1.0f, 1.0f}, {2.0f, 3.0f, 4.0f}
+        };
+        CORRADE_COMPARE_AS(scaling.keys(), (Containers::StridedArrayView1D<const Float>{scalingKeys}), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(scaling.values(), (Containers::StridedArrayView1D<const Vector3>{scalingValues}), TestSuite::Compare::Container);
+    }
+}
+
+void OpenGexImporterTest::animationMetrics() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "animation-metrics.ogex")));
+    CORRADE_COMPARE(importer->animationCount(), 1);
+
+    Containers::Optional<AnimationData> animation = importer->animation(0);
+    CORRADE_VERIFY(animation);
+    CORRADE_COMPARE(animation->trackCount(), 3);
+
+    /* Keys multiplied by the time metric */
+    const Float keys[]{0.0f, 1.0f};
+    CORRADE_COMPARE(animation->duration(), (Range1D{0.0f, 1.0f}));
+
+    /* Swapped for Y up, multiplied */
+    Animation::TrackView<const Float, const Vector3> translation = animation->track<Vector3>(0);
+    const Vector3 translationValues[]{
+        {2.0f, 6.0f, -4.0f}, {8.0f, 12.0f, -10.0f}
+    };
+    CORRADE_COMPARE_AS(translation.keys(), (Containers::StridedArrayView1D<const Float>{keys}), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(translation.values(), (Containers::StridedArrayView1D<const Vector3>{translationValues}), TestSuite::Compare::Container);
+
+    /* Swapped for Y up */
+    Animation::TrackView<const Float, const Quaternion> rotation = animation->track<Quaternion>(1);
+    const Quaternion rotationValues[]{
+        {}, {{0.0f, 0.0f, -1.0f}, 0.0f}
+    };
+    CORRADE_COMPARE_AS(rotation.keys(), (Containers::StridedArrayView1D<const Float>{keys}), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(rotation.values(), (Containers::StridedArrayView1D<const Quaternion>{rotationValues}), TestSuite::Compare::Container);
+
+    /* Swapped for Y up, not multiplied */
+    Animation::TrackView<const Float, const Vector3> scaling = animation->track<Vector3>(2);
+    const Vector3 scalingValues[]{
+        {1.0f, 1.0f, 1.0f}, {2.0f, 4.0f, 3.0f}
+    };
+    CORRADE_COMPARE_AS(scaling.keys(), (Containers::StridedArrayView1D<const Float>{keys}), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(scaling.values(), (Containers::StridedArrayView1D<const Vector3>{scalingValues}), TestSuite::Compare::Container);
+}
+
+void OpenGexImporterTest::animationInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "animation-invalid.ogex")));
+    CORRADE_COMPARE(importer->animationCount(), 6);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    for(UnsignedInt i = 0; i != importer->animationCount(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(!importer->animation(i));
+    }
+    CORRADE_COMPARE(out.str(),
+        "Trade::OpenGexImporter::animation(): unsupported track target\n"
+        "Trade::OpenGexImporter::animation(): unsupported track target\n"
+        "Trade::OpenGexImporter::animation(): unsupported time curve bezier\n"
+        "Trade::OpenGexImporter::animation(): unsupported value curve tcb\n"
+        "Trade::OpenGexImporter::animation(): invalid value key\n"
+        "Trade::OpenGexImporter::animation(): expected 2 values but got 1\n");
+}
+
 void OpenGexImporterTest::light() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "light.ogex")));
@@ -746,6 +1127,138 @@ void OpenGexImporterTest::meshIndexed() {
         }), TestSuite::Compare::Container);
 }
 
+void OpenGexImporterTest::meshQuads() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex")));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(3);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+
+    /* Each quad is split into two triangles */
+    CORRADE_VERIFY(mesh->isIndexed());
+    CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedByte);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedByte>(),
+        Containers::arrayView<UnsignedByte>({
+            0, 1, 2, 0, 2, 3,
+            4, 3, 2, 4, 2, 1
+        }), TestSuite::Compare::Container);
+
+    CORRADE_COMPARE(mesh->attributeCount(), 1);
+    CORRADE_COMPARE(mesh->vertexCount(), 5);
+}
+
+void OpenGexImporterTest::meshQuadsNotIndexed() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex")));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(4);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+
+    /* Indices are generated for the triangulation */
+    CORRADE_VERIFY(mesh->isIndexed());
+    CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedByte);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedByte>(),
+        Containers::arrayView<UnsignedByte>({
+            0, 1, 2, 0, 2, 3,
+            4, 5, 6, 4, 6, 7
+        }), TestSuite::Compare::Container);
+
+    CORRADE_COMPARE(mesh->attributeCount(), 1);
+    CORRADE_COMPARE(mesh->vertexCount(), 8);
+}
+
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+void OpenGexImporterTest::meshIndices64() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh-int64.ogex")));
+    CORRADE_COMPARE(importer->meshCount(), 2);
+
+    /* Narrowed to the smallest type that fits */
+    Containers::Optional<MeshData> mesh8 = importer->mesh(0);
+    CORRADE_VERIFY(mesh8);
+    CORRADE_VERIFY(mesh8->isIndexed());
+    CORRADE_COMPARE(mesh8->indexType(), MeshIndexType::UnsignedByte);
+    CORRADE_COMPARE_AS(mesh8->indices<UnsignedByte>(),
+        Containers::arrayView<UnsignedByte>({
+            2, 0, 1, 1, 2, 0
+        }), TestSuite::Compare::Container);
+
+    Containers::Optional<MeshData> mesh16 = importer->mesh(1);
+    CORRADE_VERIFY(mesh16);
+    CORRADE_VERIFY(mesh16->isIndexed());
+    CORRADE_COMPARE(mesh16->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE_AS(mesh16->indices<UnsignedShort>(),
+        Containers::arrayView<UnsignedShort>({
+            2, 0, 1, 1, 2, 300
+        }), TestSuite::Compare::Container);
+}
+#endif
+
+void OpenGexImporterTest::meshDouble() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex")));
+
+    /* Same as mesh(), but converted from doubles */
+    Containers::Optional<MeshData> mesh = importer->mesh(5);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->attributeCount(), 3);
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {0.0f, 1.0f, 3.0f}, {-1.0f, 2.0f, 2.0f}, {3.0f, 3.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3>({
+            {0.0f, 1.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+        Containers::arrayView<Vector2>({
+            {0.5f, 0.5f}, {0.5f, 1.0f}, {1.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+}
+
+void OpenGexImporterTest::meshSkin() {
+    auto&& data = MeshSkinData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("lazyMeshes", data.lazyMeshes);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh-skin.ogex")));
+
+    /* Skins reference bone nodes outside of the geometry, so they're never
+       parsed lazily */
+    auto&& document = *static_cast<const OpenDdl::Document*>(importer->importerState());
+    CORRADE_VERIFY(!document.isDeferred(document.firstChildOf(OpenGex::GeometryObject)));
+
+    const MeshAttribute jointIdsAttribute = importer->meshAttributeForName("JointIds");
+    const MeshAttribute weightsAttribute = importer->meshAttributeForName("Weights");
+    CORRADE_VERIFY(isMeshAttributeCustom(jointIdsAttribute));
+    CORRADE_VERIFY(isMeshAttributeCustom(weightsAttribute));
+    CORRADE_COMPARE(importer->meshAttributeName(jointIdsAttribute), "JointIds");
+    CORRADE_COMPARE(importer->meshAttributeName(weightsAttribute), "Weights");
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->attributeCount(), 3);
+    CORRADE_COMPARE(mesh->attributeFormat(jointIdsAttribute), VertexFormat::Vector4ui);
+    CORRADE_COMPARE(mesh->attributeFormat(weightsAttribute), VertexFormat::Vector4);
+
+    /* Sorted by weight, the last vertex has the smallest influence dropped
+       and the rest renormalized */
+    CORRADE_COMPARE_AS(mesh->attribute<Vector4ui>(jointIdsAttribute),
+        Containers::arrayView<Vector4ui>({
+            {0, 0, 0, 0}, {2, 1, 0, 0}, {2, 4, 1, 3}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector4>(weightsAttribute),
+        Containers::arrayView<Vector4>({
+            {1.0f, 0.0f, 0.0f, 0.0f},
+            {0.75f, 0.25f, 0.0f, 0.0f},
+            {0.3f/0.9f, 0.25f/0.9f, 0.2f/0.9f, 0.15f/0.9f}
+        }), TestSuite::Compare::Container);
+}
+
 void OpenGexImporterTest::meshMetrics() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
 
@@ -779,21 +1292,181 @@ void OpenGexImporterTest::meshMetrics() {
         }), TestSuite::Compare::Container);
 }
 
+void OpenGexImporterTest::meshLazy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("lazyMeshes", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex")));
+
+    /* The contents are not parsed yet */
+    auto&& document = *static_cast<const OpenDdl::Document*>(importer->importerState());
+    CORRADE_VERIFY(document.isDeferred(document.firstChildOf(OpenGex::GeometryObject)));
+
+    /* Importing twice gives the same result */
+    for(std::size_t i: {0, 1}) {
+        CORRADE_ITERATION(i);
+
+        Containers::Optional<MeshData> mesh = importer->mesh(1);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+        CORRADE_VERIFY(mesh->isIndexed());
+        CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedShort);
+        CORRADE_COMPARE_AS(mesh->indices<UnsignedShort>(),
+            Containers::arrayView<UnsignedShort>({
+                2, 0, 1, 1, 2, 3
+            }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView<Vector3>({
+                {0.0f, 1.0f, 3.0f}, {-1.0f, 2.0f, 2.0f}, {3.0f, 3.0f, 1.0f}, {5.0f, 7.0f, 0.5f}
+            }), TestSuite::Compare::Container);
+    }
+
+    /* The binary cache is used only by openFile(), so it doesn't affect lazy
+       parsing in openData() */
+    importer->configuration().setValue("binaryCache", true);
+    CORRADE_VERIFY(importer->openData(Utility::Directory::read(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex"))));
+    auto&& dataDocument = *static_cast<const OpenDdl::Document*>(importer->importerState());
+    CORRADE_VERIFY(dataDocument.isDeferred(dataDocument.firstChildOf(OpenGex::GeometryObject)));
+    CORRADE_VERIFY(importer->mesh(1));
+}
+
+void OpenGexImporterTest::meshLazyInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("lazyMeshes", true);
+
+    /* The errors are discovered only when importing the mesh */
+    auto s = OpenDdl::CharacterLiteral{R"oddl(
+GeometryObject { Mesh { VertexArray (attrib = "position") { float[3] { {1.0, 2.0 3.0} } } } }
+GeometryObject { }
+    )oddl"};
+    CORRADE_VERIFY(importer->openData(s));
+    CORRADE_COMPARE(importer->meshCount(), 2);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(0));
+    CORRADE_VERIFY(!importer->mesh(1));
+    CORRADE_COMPARE(out.str(),
+        "OpenDdl::Document::parse(): expected , character on line 1\n"
+        "OpenDdl::Document::validate(): too little Mesh structures, got 0 but expected min 1\n");
+}
+
+void OpenGexImporterTest::meshBatch() {
+    auto&& data = MeshBatchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifdef OPENGEXIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only if the plugin is built as static.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("meshThreads", data.threads);
+    importer->configuration().setValue("lazyMeshes", data.lazyMeshes);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex")));
+    CORRADE_COMPARE(importer->meshCount(), 6);
+
+    /* Repeated IDs should be imported just fine, even if lazily parsed */
+    const UnsignedInt ids[]{1, 0, 5, 1, 3, 1, 4, 2, 0};
+    Containers::Array<Containers::Optional<MeshData>> meshes = static_cast<OpenGexImporter&>(*importer).meshBatch(ids);
+    CORRADE_COMPARE(meshes.size(), Containers::arraySize(ids));
+
+    /* The result should be the same as when importing sequentially */
+    for(std::size_t i = 0; i != meshes.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(meshes[i]);
+
+        Containers::Optional<MeshData> expected = importer->mesh(ids[i]);
+        CORRADE_VERIFY(expected);
+        CORRADE_COMPARE(meshes[i]->primitive(), expected->primitive());
+        CORRADE_COMPARE(meshes[i]->isIndexed(), expected->isIndexed());
+        CORRADE_COMPARE_AS(meshes[i]->indexData(), expected->indexData(),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE(meshes[i]->attributeCount(), expected->attributeCount());
+        CORRADE_COMPARE_AS(meshes[i]->vertexData(), expected->vertexData(),
+            TestSuite::Compare::Container);
+    }
+    #endif
+}
+
+void OpenGexImporterTest::meshBatchInvalid() {
+    #ifdef OPENGEXIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only if the plugin is built as static.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("meshThreads", 3);
+    importer->configuration().setValue("lazyMeshes", true);
+
+    auto s = OpenDdl::CharacterLiteral{R"oddl(
+GeometryObject { Mesh { VertexArray (attrib = "position") { float[3] { {1.0, 2.0 3.0} } } } }
+GeometryObject { Mesh { VertexArray (attrib = "position") { float[3] { {1.0, 2.0, 3.0} } } } }
+    )oddl"};
+    CORRADE_VERIFY(importer->openData(s));
+    CORRADE_COMPARE(importer->meshCount(), 2);
+
+    /* A mesh failing to parse is reported just once even if it's repeated */
+    std::ostringstream out;
+    Error redirectError{&out};
+    const UnsignedInt ids[]{0, 1, 0};
+    Containers::Array<Containers::Optional<MeshData>> meshes = static_cast<OpenGexImporter&>(*importer).meshBatch(ids);
+    CORRADE_COMPARE(meshes.size(), 3);
+    CORRADE_VERIFY(!meshes[0]);
+    CORRADE_VERIFY(meshes[1]);
+    CORRADE_VERIFY(!meshes[2]);
+    CORRADE_COMPARE(meshes[1]->vertexCount(), 1);
+    CORRADE_COMPARE(out.str(),
+        "OpenDdl::Document::parse(): expected , character on line 1\n");
+    #endif
+}
+
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+void OpenGexImporterTest::meshThreads() {
+    auto&& data = MeshThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("lazyMeshes", data.lazyMeshes);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex")));
+    CORRADE_COMPARE(importer->meshCount(), 6);
+
+    /* Import different meshes concurrently through the regular interface,
+       each thread importing its own subset, repeatedly */
+    Containers::Array<Containers::Optional<MeshData>> meshes{Containers::ValueInit, importer->meshCount()};
+    std::vector<std::thread> threads;
+    for(UnsignedInt t = 0; t != 3; ++t) threads.emplace_back([&, t]() {
+        for(UnsignedInt i = t; i < meshes.size(); i += 3) {
+            for(std::size_t j = 0; j != 10; ++j)
+                meshes[i] = importer->mesh(i);
+        }
+    });
+    for(std::thread& thread: threads) thread.join();
+
+    for(UnsignedInt i = 0; i != meshes.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(meshes[i]);
+
+        Containers::Optional<MeshData> expected = importer->mesh(i);
+        CORRADE_VERIFY(expected);
+        CORRADE_COMPARE_AS(meshes[i]->indexData(), expected->indexData(),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(meshes[i]->vertexData(), expected->vertexData(),
+            TestSuite::Compare::Container);
+    }
+}
+#endif
+
 void OpenGexImporterTest::meshInvalidPrimitive() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh-invalid.ogex")));
-    CORRADE_COMPARE(importer->meshCount(), 6);
+    CORRADE_COMPARE(importer->meshCount(), 7);
 
     std::ostringstream out;
     Error redirectError{&out};
     CORRADE_VERIFY(!importer->mesh(0));
-    CORRADE_COMPARE(out.str(), "Trade::OpenGexImporter::mesh(): unsupported primitive quads\n");
+    CORRADE_COMPARE(out.str(), "Trade::OpenGexImporter::mesh(): unsupported primitive polygons\n");
 }
 
 void OpenGexImporterTest::meshUnsupportedSize() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh-invalid.ogex")));
-    CORRADE_COMPARE(importer->meshCount(), 6);
+    CORRADE_COMPARE(importer->meshCount(), 7);
 
     std::ostringstream out;
     Error redirectError{&out};
@@ -809,7 +1482,7 @@ void OpenGexImporterTest::meshUnsupportedSize() {
 void OpenGexImporterTest::meshMismatchedSizes() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh-invalid.ogex")));
-    CORRADE_COMPARE(importer->meshCount(), 6);
+    CORRADE_COMPARE(importer->meshCount(), 7);
 
     std::ostringstream out;
     Error redirectError{&out};
@@ -820,7 +1493,7 @@ void OpenGexImporterTest::meshMismatchedSizes() {
 void OpenGexImporterTest::meshInvalidIndexArraySubArraySize() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh-invalid.ogex")));
-    CORRADE_COMPARE(importer->meshCount(), 6);
+    CORRADE_COMPARE(importer->meshCount(), 7);
 
     std::ostringstream out;
     Error redirectError{&out};
@@ -828,6 +1501,31 @@ void OpenGexImporterTest::meshInvalidIndexArraySubArraySize() {
     CORRADE_COMPARE(out.str(), "Trade::OpenGexImporter::mesh(): invalid index array subarray size 3 for MeshPrimitive::Lines\n");
 }
 
+void OpenGexImporterTest::meshInvalidQuadVertexCount() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh-invalid.ogex")));
+    CORRADE_COMPARE(importer->meshCount(), 7);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(6));
+    CORRADE_COMPARE(out.str(), "Trade::OpenGexImporter::mesh(): quad vertex count 3 is not divisible by 4\n");
+}
+
+void OpenGexImporterTest::meshInvalidSkin() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh-skin.ogex")));
+    CORRADE_COMPARE(importer->meshCount(), 3);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(1));
+    CORRADE_VERIFY(!importer->mesh(2));
+    CORRADE_COMPARE(out.str(),
+        "Trade::OpenGexImporter::mesh(): skin bone index 1 out of bounds for 1 bones\n"
+        "Trade::OpenGexImporter::mesh(): expected 2 skin bone indices and weights but got 2 and 1\n");
+}
+
 #ifndef CORRADE_TARGET_EMSCRIPTEN
 void OpenGexImporterTest::meshUnsupportedIndexType() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
@@ -837,7 +1535,7 @@ void OpenGexImporterTest::meshUnsupportedIndexType() {
     std::ostringstream out;
     Error redirectError{&out};
     CORRADE_VERIFY(!importer->mesh(0));
-    CORRADE_COMPARE(out.str(), "Trade::OpenGexImporter::mesh(): 64bit indices are not supported\n");
+    CORRADE_COMPARE(out.str(), "Trade::OpenGexImporter::mesh(): 64bit indices larger than 32 bits are not supported\n");
 }
 #endif
 
@@ -1175,6 +1873,72 @@ void OpenGexImporterTest::fileCallbackImageNotFound() {
     CORRADE_COMPARE(out.str(), "Trade::AbstractImporter::openFile(): cannot open file image.tga\n");
 }
 
+/* Used by the benchmarks, a mesh with a million vertices */
+constexpr std::size_t BenchmarkVertexCount = 1000000;
+std::string benchmarkMeshData() {
+    std::string out = "Metric (key = \"distance\") { float { 0.5 } }\n"
+        "GeometryObject {\n"
+        "  Mesh {\n";
+    for(const char* const attrib: {"position", "normal"}) {
+        out += Utility::formatString("    VertexArray (attrib = \"{}\") {{ float[3] {{\n", attrib);
+        for(std::size_t i = 0; i != BenchmarkVertexCount; ++i) {
+            if(i) out += ",\n";
+            out += "{1.5, -2.5, 0.25}";
+        }
+        out += "\n    }}\n";
+    }
+    out += "  }\n}\n";
+    return out;
+}
+
+void OpenGexImporterTest::benchmarkMesh() {
+    const std::string data = benchmarkMeshData();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    CORRADE_VERIFY(importer->openData({data.data(), data.size()}));
+
+    Containers::Optional<MeshData> mesh;
+    CORRADE_BENCHMARK(1) {
+        mesh = importer->mesh(0);
+    }
+
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexCount(), BenchmarkVertexCount);
+    CORRADE_COMPARE(mesh->attribute<Vector3>(MeshAttribute::Position)[BenchmarkVertexCount - 1], (Vector3{0.75f, 0.125f, 1.25f}));
+    CORRADE_COMPARE(mesh->attribute<Vector3>(MeshAttribute::Normal)[BenchmarkVertexCount - 1], (Vector3{1.5f, 0.25f, 2.5f}));
+}
+
+/* Each node references its own mesh and material */
+std::string benchmarkObject3DData(const UnsignedInt count) {
+    std::string out;
+    for(UnsignedInt i = 0; i != count; ++i) {
+        out += Utility::formatString(
+            "GeometryObject $geometry{0} {{ Mesh {{ VertexArray (attrib = \"position\") {{ float[3] {{ }} }} }} }}\n"
+            "Material $material{0} {{ }}\n"
+            "GeometryNode {{ ObjectRef {{ ref {{ $geometry{0} }} }} MaterialRef {{ ref {{ $material{0} }} }} }}\n", i);
+    }
+    return out;
+}
+
+void OpenGexImporterTest::benchmarkObject3D() {
+    auto&& data = BenchmarkObject3DData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const std::string file = benchmarkObject3DData(data.count);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    CORRADE_VERIFY(importer->openData({file.data(), file.size()}));
+    CORRADE_COMPARE(importer->object3DCount(), data.count);
+
+    std::size_t meshIdSum = 0;
+    CORRADE_BENCHMARK(1) {
+        for(UnsignedInt i = 0; i != data.count; ++i)
+            meshIdSum += importer->object3D(i)->instance();
+    }
+
+    CORRADE_COMPARE(meshIdSum, std::size_t(data.count)*(data.count - 1)/2);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::OpenGexImporterTest)
@@ -108,6 +108,14 @@ const std::initializer_list<CharacterLiteral> properties{
 };
 #undef _c
 
+/* Contents of GeometryObject, used also for validating the contents when
+   they're parsed lazily */
+const Structures geometryObjectStructures{
+    {Mesh, {1, 0}},
+    {Morph, {}},
+    {Extension, {}}
+};
+
 const Structures rootStructures{
     {BoneNode, {}},
     {CameraNode, {}},
@@ -228,9 +236,7 @@ const std::initializer_list<Validation::Structure> structureInfo{
     {GeometryObject,    Properties{{visible, PropertyType::Bool, OptionalProperty},
                                    {shadow, PropertyType::Bool, OptionalProperty},
                                    {motion_blur, PropertyType::Bool, OptionalProperty}},
-                        Structures{{Mesh, {1, 0}},
-                                   {Morph, {}},
-                                   {Extension, {}}}},
+                        geometryObjectStructures},
     {IndexArray,        Properties{{material, PropertyType::UnsignedInt, OptionalProperty},
                                    #ifndef CORRADE_TARGET_EMSCRIPTEN
                                    {restart, PropertyType::UnsignedLong, OptionalProperty},
@@ -0,0 +1,555 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "Json.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <Corrade/Utility/FormatStl.h>
+
+#ifdef CORRADE_TARGET_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+namespace Magnum { namespace Trade { namespace Implementation {
+
+namespace {
+
+#ifdef CORRADE_TARGET_SSE2
+/* Position of the lowest set bit, the value is expected to be non-zero */
+inline UnsignedInt lowestSetBit(UnsignedInt value) {
+    #if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(value);
+    #elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return index;
+    #else
+    UnsignedInt index = 0;
+    for(; !(value & 1); value >>= 1) ++index;
+    return index;
+    #endif
+}
+#endif
+
+inline bool isWhitespace(const char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool isDigit(const char c) {
+    return c >= '0' && c <= '9';
+}
+
+const char* skipWhitespace(const char* i, const char* const end) {
+    /* Minified files have no whitespace between tokens, so check the first
+       character before going wide */
+    if(i == end || !isWhitespace(*i)) return i;
+
+    #ifdef CORRADE_TARGET_SSE2
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i carriageReturn = _mm_set1_epi8('\r');
+    const __m128i tab = _mm_set1_epi8('\t');
+    for(; i + 16 <= end; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(i));
+        const UnsignedInt whitespace = _mm_movemask_epi8(_mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+                         _mm_cmpeq_epi8(chunk, newline)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, carriageReturn),
+                         _mm_cmpeq_epi8(chunk, tab))));
+        if(whitespace != 0xffff) return i + lowestSetBit(~whitespace);
+    }
+    #endif
+
+    while(i != end && isWhitespace(*i)) ++i;
+    return i;
+}
+
+/* Finds the first double quote, backslash, control character or a byte
+   that's not ASCII, or returns end if there's none */
+const char* findStringSpecial(const char* i, const char* const end) {
+    #ifdef CORRADE_TARGET_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i lastControl = _mm_set1_epi8(0x1f);
+    for(; i + 16 <= end; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(i));
+        /* There's no unsigned comparison in SSE2, c <= 0x1f is expressed as
+           min(c, 0x1f) == c instead. Bytes >= 0x80 have the highest bit set,
+           which is exactly what the movemask picks. */
+        const UnsignedInt special = _mm_movemask_epi8(_mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                         _mm_cmpeq_epi8(chunk, backslash)),
+            _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(chunk, lastControl), chunk),
+                         chunk)));
+        if(special) return i + lowestSetBit(special);
+    }
+    #endif
+
+    for(; i != end; ++i) {
+        const UnsignedByte c = *i;
+        if(c == '"' || c == '\\' || c <= 0x1f || c >= 0x80) return i;
+    }
+    return end;
+}
+
+/* Size of a valid UTF-8 sequence starting at given non-ASCII byte, 0 if it's
+   not valid. Overlong encodings, surrogates and values above U+10FFFF are
+   invalid as well. */
+std::size_t utf8SequenceSize(const char* const i, const char* const end) {
+    const UnsignedByte c = i[0];
+    std::size_t size;
+    UnsignedByte secondMin = 0x80, secondMax = 0xbf;
+    if(c >= 0xc2 && c <= 0xdf) size = 2;
+    else if(c >= 0xe0 && c <= 0xef) {
+        size = 3;
+        if(c == 0xe0) secondMin = 0xa0;
+        else if(c == 0xed) secondMax = 0x9f;
+    } else if(c >= 0xf0 && c <= 0xf4) {
+        size = 4;
+        if(c == 0xf0) secondMin = 0x90;
+        else if(c == 0xf4) secondMax = 0x8f;
+    } else return 0;
+
+    if(std::size_t(end - i) < size) return 0;
+    const UnsignedByte second = i[1];
+    if(second < secondMin || second > secondMax) return 0;
+    for(std::size_t j = 2; j != size; ++j)
+        if((UnsignedByte(i[j]) & 0xc0) != 0x80) return 0;
+    return size;
+}
+
+/* Value of four hexadecimal digits, -1 if there's less than four or they're
+   not all hexadecimal */
+Int hexadecimal(const char* const i, const char* const end) {
+    if(end - i < 4) return -1;
+
+    Int value = 0;
+    for(std::size_t j = 0; j != 4; ++j) {
+        const char c = i[j];
+        value <<= 4;
+        if(c >= '0' && c <= '9') value |= c - '0';
+        else if(c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+        else if(c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+        else return -1;
+    }
+    return value;
+}
+
+void appendUtf8(std::string& out, const UnsignedInt codepoint) {
+    if(codepoint < 0x80) {
+        out += char(codepoint);
+    } else if(codepoint < 0x800) {
+        out += char(0xc0|(codepoint >> 6));
+        out += char(0x80|(codepoint & 0x3f));
+    } else if(codepoint < 0x10000) {
+        out += char(0xe0|(codepoint >> 12));
+        out += char(0x80|((codepoint >> 6) & 0x3f));
+        out += char(0x80|(codepoint & 0x3f));
+    } else {
+        out += char(0xf0|(codepoint >> 18));
+        out += char(0x80|((codepoint >> 12) & 0x3f));
+        out += char(0x80|((codepoint >> 6) & 0x3f));
+        out += char(0x80|(codepoint & 0x3f));
+    }
+}
+
+constexpr Double ExactPowersOfTen[]{
+    1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9,
+    1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18,
+    1.0e19, 1.0e20, 1.0e21, 1.0e22
+};
+
+/* Parses an already validated number literal as a double. If the
+   significand fits into 53 bits and the power of ten is exactly
+   representable, the result is a single correctly rounded multiplication or
+   division. Otherwise it falls back to the standard library with the classic
+   locale, which is slower and allocates, but handles all remaining cases
+   exactly. Values that overflow become infinities, same as with strtod(). */
+Double floatLiteral(const char* const begin, const char* const end) {
+    const char* i = begin;
+    const bool negative = *i == '-';
+    if(negative) ++i;
+
+    UnsignedLong significand = 0;
+    Int significantDigits = 0;
+    Int exponent = 0;
+    bool fallback = false;
+    bool afterDot = false;
+    for(; i != end; ++i) {
+        const char c = *i;
+        if(c == '.') {
+            afterDot = true;
+            continue;
+        }
+        if(!isDigit(c)) break;
+
+        /* Leading zeros don't count towards the precision, more than 19
+           significant digits could overflow */
+        if((significand || c != '0') && ++significantDigits > 19) {
+            fallback = true;
+            break;
+        }
+
+        significand = significand*10 + (c - '0');
+        if(afterDot) --exponent;
+    }
+
+    /* Exponent, clamped to a value that's out of range for a double */
+    if(!fallback && i != end) {
+        ++i;
+        bool negativeExponent = false;
+        if(*i == '+') ++i;
+        else if(*i == '-') {
+            negativeExponent = true;
+            ++i;
+        }
+
+        Int exponentValue = 0;
+        for(; i != end; ++i)
+            if(exponentValue < 100000)
+                exponentValue = exponentValue*10 + (*i - '0');
+        exponent += negativeExponent ? -exponentValue : exponentValue;
+    }
+
+    if(!fallback) {
+        if(!significand) return negative ? -0.0 : 0.0;
+
+        if(significand <= (1ull << 53) && exponent >= -22 && exponent <= 22) {
+            const Double value = exponent < 0 ?
+                Double(significand)/ExactPowersOfTen[-exponent] :
+                Double(significand)*ExactPowersOfTen[exponent];
+            return negative ? -value : value;
+        }
+    }
+
+    std::istringstream in{std::string{begin, end}};
+    in.imbue(std::locale::classic());
+    Double out{};
+    in >> out;
+    if(in.fail() && std::abs(out) >= std::numeric_limits<Double>::max())
+        return negative ? -std::numeric_limits<Double>::infinity() : std::numeric_limits<Double>::infinity();
+    return out;
+}
+
+}
+
+bool tokenizeJson(const Containers::ArrayView<const char> data, std::vector<JsonToken>& tokens, std::string& error) {
+    tokens.clear();
+
+    const char* const end = data.end();
+    const char* i = data.begin();
+
+    const auto fail = [&](const char* const position, const char* const message) -> bool {
+        std::size_t line = 1;
+        const char* lineBegin = data.begin();
+        for(const char* j = data.begin(); j != position; ++j) if(*j == '\n') {
+            ++line;
+            lineBegin = j + 1;
+        }
+        error = Utility::formatString("JSON parse error at line {}, column {}: {}", line, position - lineBegin + 1, message);
+        return false;
+    };
+
+    /* Sizes and token counts are 32-bit */
+    if(data.size() > std::numeric_limits<UnsignedInt>::max())
+        return fail(i, "data too large");
+
+    /* Skip a UTF-8 BOM */
+    if(data.size() >= 3 && std::memcmp(i, "\xef\xbb\xbf", 3) == 0) i += 3;
+
+    /* Expects i to point to the opening quote, on success i points after the
+       closing quote */
+    const auto parseString = [&]() -> bool {
+        const char* const begin = ++i;
+        bool escaped = false;
+        for(;;) {
+            i = findStringSpecial(i, end);
+            if(i == end)
+                return fail(begin - 1, "unterminated string");
+            if(*i == '"')
+                break;
+            if(UnsignedByte(*i) >= 0x80) {
+                const std::size_t size = utf8SequenceSize(i, end);
+                if(!size)
+                    return fail(i, "invalid UTF-8 sequence");
+                i += size;
+                continue;
+            }
+            if(*i != '\\')
+                return fail(i, "invalid control character in a string");
+
+            escaped = true;
+            if(i + 1 == end)
+                return fail(begin - 1, "unterminated string");
+            const char c = i[1];
+            if(c == '"' || c == '\\' || c == '/' || c == 'b' || c == 'f' ||
+               c == 'n' || c == 'r' || c == 't') {
+                i += 2;
+                continue;
+            }
+            if(c != 'u')
+                return fail(i, "invalid escape sequence");
+
+            const Int codepoint = hexadecimal(i + 2, end);
+            if(codepoint == -1)
+                return fail(i, "invalid unicode escape sequence");
+
+            /* A high surrogate has to be followed by a low one, a low
+               surrogate alone is invalid */
+            if(codepoint >= 0xd800 && codepoint <= 0xdbff) {
+                if(end - i < 12 || i[6] != '\\' || i[7] != 'u')
+                    return fail(i, "unpaired UTF-16 surrogate");
+                const Int low = hexadecimal(i + 8, end);
+                if(low < 0xdc00 || low > 0xdfff)
+                    return fail(i, "unpaired UTF-16 surrogate");
+                i += 12;
+            } else if(codepoint >= 0xdc00 && codepoint <= 0xdfff) {
+                return fail(i, "unpaired UTF-16 surrogate");
+            } else i += 6;
+        }
+
+        tokens.push_back({begin, UnsignedInt(i - begin), 1, JsonTokenType::String, escaped});
+        ++i;
+        return true;
+    };
+
+    /* Parses an object key including the colon after */
+    const auto parseKey = [&]() -> bool {
+        i = skipWhitespace(i, end);
+        if(i == end || *i != '"')
+            return fail(i, "expected a string key");
+        if(!parseString())
+            return false;
+        i = skipWhitespace(i, end);
+        if(i == end || *i != ':')
+            return fail(i, "expected :");
+        ++i;
+        return true;
+    };
+
+    /* Indices of currently open objects and arrays */
+    std::vector<UnsignedInt> containers;
+
+    for(;;) {
+        /* A value */
+        i = skipWhitespace(i, end);
+        if(i == end)
+            return fail(i, "expected a value");
+        if(!containers.empty())
+            ++tokens[containers.back()].size;
+
+        const char c = *i;
+        if(c == '{' || c == '[') {
+            containers.push_back(UnsignedInt(tokens.size()));
+            tokens.push_back({i, 0, 0, c == '{' ? JsonTokenType::Object : JsonTokenType::Array, false});
+            i = skipWhitespace(i + 1, end);
+
+            /* Non-empty container, continue with the first value. An empty
+               one gets closed below. */
+            if(i == end || *i != (c == '{' ? '}' : ']')) {
+                if(c == '{' && !parseKey())
+                    return false;
+                continue;
+            }
+
+        } else if(c == '"') {
+            if(!parseString())
+                return false;
+
+        } else if(c == '-' || isDigit(c)) {
+            const char* const begin = i;
+            if(*i == '-') ++i;
+            if(i == end || !isDigit(*i))
+                return fail(begin, "invalid number");
+            /* No leading zeros */
+            const char* const integerBegin = i;
+            if(*i == '0') ++i;
+            else while(i != end && isDigit(*i)) ++i;
+            const std::size_t integerDigits = i - integerBegin;
+            if(i != end && *i == '.') {
+                ++i;
+                if(i == end || !isDigit(*i))
+                    return fail(begin, "invalid number");
+                while(i != end && isDigit(*i)) ++i;
+            }
+            Int exponent = 0;
+            if(i != end && (*i == 'e' || *i == 'E')) {
+                ++i;
+                bool negativeExponent = false;
+                if(i != end && (*i == '+' || *i == '-'))
+                    negativeExponent = *i++ == '-';
+                if(i == end || !isDigit(*i))
+                    return fail(begin, "invalid number");
+                for(; i != end && isDigit(*i); ++i)
+                    if(exponent < 100000) exponent = exponent*10 + (*i - '0');
+                if(negativeExponent) exponent = -exponent;
+            }
+
+            /* Values that don't fit into a double are an error, not an
+               infinity. Only literals that are large enough to possibly
+               overflow are converted here, the rest is deferred to
+               jsonNumber(). */
+            if(Long(integerDigits) + exponent > std::numeric_limits<Double>::max_exponent10 && std::isinf(floatLiteral(begin, i)))
+                return fail(begin, "number out of range");
+
+            tokens.push_back({begin, UnsignedInt(i - begin), 1, JsonTokenType::Number, false});
+
+        } else if(end - i >= 4 && std::memcmp(i, "true", 4) == 0) {
+            tokens.push_back({i, 4, 1, JsonTokenType::True, false});
+            i += 4;
+        } else if(end - i >= 5 && std::memcmp(i, "false", 5) == 0) {
+            tokens.push_back({i, 5, 1, JsonTokenType::False, false});
+            i += 5;
+        } else if(end - i >= 4 && std::memcmp(i, "null", 4) == 0) {
+            tokens.push_back({i, 4, 1, JsonTokenType::Null, false});
+            i += 4;
+        } else return fail(i, "expected a value");
+
+        /* After a value, close all containers that end here and find the
+           separator before the next value */
+        for(;;) {
+            i = skipWhitespace(i, end);
+            if(containers.empty()) {
+                if(i != end)
+                    return fail(i, "unexpected trailing characters");
+                return true;
+            }
+
+            JsonToken& container = tokens[containers.back()];
+            const bool object = container.type == JsonTokenType::Object;
+            if(i != end && *i == (object ? '}' : ']')) {
+                container.tokenCount = UnsignedInt(tokens.size()) - containers.back();
+                containers.pop_back();
+                ++i;
+                continue;
+            }
+
+            if(i == end || *i != ',')
+                return fail(i, object ? "expected , or }" : "expected , or ]");
+            ++i;
+            if(object && !parseKey())
+                return false;
+            break;
+        }
+    }
+}
+
+std::string jsonString(const JsonToken& token) {
+    if(!token.escaped) return {token.data, token.size};
+
+    /* The tokenizer already verified the escapes, no need to check again */
+    std::string out;
+    out.reserve(token.size);
+    const char* const end = token.data + token.size;
+    for(const char* i = token.data; i != end; ) {
+        if(*i != '\\') {
+            out += *i++;
+            continue;
+        }
+
+        switch(i[1]) {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                UnsignedInt codepoint = hexadecimal(i + 2, end);
+                i += 6;
+                if(codepoint >= 0xd800 && codepoint <= 0xdbff) {
+                    codepoint = 0x10000 + ((codepoint - 0xd800) << 10) + (hexadecimal(i + 2, end) - 0xdc00);
+                    i += 6;
+                }
+                appendUtf8(out, codepoint);
+            } continue;
+            /* ", \ and / */
+            default: out += i[1];
+        }
+        i += 2;
+    }
+
+    return out;
+}
+
+bool jsonStringEquals(const JsonToken& token, const Containers::ArrayView<const char> string) {
+    if(!token.escaped)
+        return token.size == string.size() && std::memcmp(token.data, string.data(), string.size()) == 0;
+
+    const std::string unescaped = jsonString(token);
+    return unescaped.size() == string.size() && std::memcmp(unescaped.data(), string.data(), string.size()) == 0;
+}
+
+JsonNumber jsonNumber(const JsonToken& token) {
+    const char* const end = token.data + token.size;
+    const char* i = token.data;
+    const bool negative = *i == '-';
+    if(negative) ++i;
+
+    /* Integer literal, if it's without a fractional part and an exponent
+       and fits into 64 bits */
+    UnsignedLong value = 0;
+    for(; i != end && isDigit(*i); ++i) {
+        const UnsignedLong digit = *i - '0';
+        if(value > (std::numeric_limits<UnsignedLong>::max() - digit)/10)
+            break;
+        value = value*10 + digit;
+    }
+
+    JsonNumber out;
+    if(i == end && !negative) {
+        out.type = JsonNumberType::Unsigned;
+        out.unsignedValue = value;
+    } else if(i == end && value <= (1ull << 63)) {
+        out.type = JsonNumberType::Signed;
+        out.signedValue = value == (1ull << 63) ? std::numeric_limits<Long>::min() : -Long(value);
+    } else {
+        out.type = JsonNumberType::Float;
+        out.floatValue = floatLiteral(token.data, end);
+    }
+    return out;
+}
+
+const JsonToken* jsonFind(const JsonToken& object, const Containers::ArrayView<const char> key) {
+    if(object.type != JsonTokenType::Object) return nullptr;
+
+    const JsonToken* found = nullptr;
+    const JsonToken* i = &object + 1;
+    for(UnsignedInt j = 0; j != object.size; ++j) {
+        const JsonToken* const value = i + 1;
+        if(jsonStringEquals(*i, key)) found = value;
+        i = value + value->tokenCount;
+    }
+
+    return found;
+}
+
+}}}
@@ -0,0 +1,110 @@
+#ifndef Magnum_Trade_TinyGltfImporter_Json_h
+#define Magnum_Trade_TinyGltfImporter_Json_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <string>
+#include <vector>
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Magnum.h>
+
+namespace Magnum { namespace Trade { namespace Implementation {
+
+enum class JsonTokenType: UnsignedByte {
+    Object,
+    Array,
+    String,
+    Number,
+    True,
+    False,
+    Null
+};
+
+/* A single JSON value. Nothing is copied or converted during tokenization,
+   strings and numbers point into the original data, which thus has to stay
+   in scope for as long as the tokens are used. An object token is followed
+   by alternating key and value tokens, an array token by its element tokens,
+   each nested value again followed by all its children. */
+struct JsonToken {
+    /* String contents without the quotes, number literal or the opening
+       brace / bracket of a container */
+    const char* data;
+    /* Size of the string contents or number literal in bytes, count of
+       key/value pairs in an object or count of elements in an array */
+    UnsignedInt size;
+    /* Count of tokens this value occupies, including all its children. The
+       token after this value is at this + tokenCount. */
+    UnsignedInt tokenCount;
+    JsonTokenType type;
+    /* Whether a string contains escape sequences and thus can't be used
+       directly */
+    bool escaped;
+};
+
+enum class JsonNumberType: UnsignedByte {
+    Unsigned,   /* Integer without a minus sign that fits into 64 bits */
+    Signed,     /* Negative integer that fits into 64 bits */
+    Float       /* Everything else */
+};
+
+struct JsonNumber {
+    JsonNumberType type;
+    union {
+        UnsignedLong unsignedValue;
+        Long signedValue;
+        Double floatValue;
+    };
+};
+
+/* Splits the data into a flat list of tokens in a single pass, validating
+   the syntax, escape sequences, UTF-8 in strings and number literals. A
+   leading UTF-8 BOM is skipped. On failure returns false and fills the error
+   message with a line / column position. */
+bool tokenizeJson(Containers::ArrayView<const char> data, std::vector<JsonToken>& tokens, std::string& error);
+
+/* String token contents with escape sequences resolved */
+std::string jsonString(const JsonToken& token);
+
+/* Whether a string token is equal to given string, with escape sequences
+   resolved */
+bool jsonStringEquals(const JsonToken& token, Containers::ArrayView<const char> string);
+
+/* Number token value. Integers that don't fit into 64 bits are treated as
+   floats. Conversion to floating-point is correctly rounded and doesn't
+   depend on the current locale. */
+JsonNumber jsonNumber(const JsonToken& token);
+
+/* Value token for given key in an object token, nullptr if the token is not
+   an object or the key is not present. If the key is present more than once,
+   the last value is returned. */
+const JsonToken* jsonFind(const JsonToken& object, Containers::ArrayView<const char> key);
+
+template<std::size_t size> inline const JsonToken* jsonFind(const JsonToken& object, const char(&key)[size]) {
+    return jsonFind(object, Containers::ArrayView<const char>{key, size - 1});
+}
+
+}}}
+
+#endif
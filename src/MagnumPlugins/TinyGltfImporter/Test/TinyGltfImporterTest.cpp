@@ -25,6 +25,9 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <atomic>
+#include <cstdlib>
+#include <new>
 #include <sstream>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
@@ -59,6 +62,11 @@
 
 #include "configure.h"
 
+#ifndef TINYGLTFIMPORTER_PLUGIN_FILENAME
+#include "MagnumPlugins/TinyGltfImporter/TinyGltfImporter.h"
+#include "MagnumPlugins/TinyGltfImporter/FlatHierarchy.h"
+#endif
+
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
 struct TinyGltfImporterTest: TestSuite::Tester {
@@ -76,11 +84,13 @@ struct TinyGltfImporterTest: TestSuite::Tester {
     void animationSpline();
     void animationSplineSharedWithSameTimeTrack();
     void animationSplineSharedWithDifferentTimeTrack();
+    void animationTimeTrackDeduplication();
 
     void animationShortestPathOptimizationEnabled();
     void animationShortestPathOptimizationDisabled();
     void animationQuaternionNormalizationEnabled();
     void animationQuaternionNormalizationDisabled();
+    void animationQuaternionNormalizationManyKeys();
     void animationMergeEmpty();
     void animationMerge();
 
@@ -92,6 +102,9 @@ struct TinyGltfImporterTest: TestSuite::Tester {
     void sceneEmpty();
     void sceneNoDefault();
     void objectTransformation();
+    void flatHierarchy();
+
+    void nameLookupOnOpen();
 
     void objectTransformationQuaternionNormalizationEnabled();
     void objectTransformationQuaternionNormalizationDisabled();
@@ -104,7 +117,10 @@ struct TinyGltfImporterTest: TestSuite::Tester {
     void meshCustomAttributes();
     void meshCustomAttributesNoFileOpened();
     void meshMultiplePrimitives();
+    void meshTextureCoordinateYFlip();
+    void meshTextureCoordinateYFlipDequantized();
     void meshPrimitivesTypes();
+    void meshDequantize();
     /* This is THE ONE AND ONLY OOB check done by tinygltf, so it fails right
        at openData() and thus has to be separate. Everything else is not done
        by it. */
@@ -116,6 +132,7 @@ struct TinyGltfImporterTest: TestSuite::Tester {
     void materialProperties();
     void materialInvalid();
     void materialTexCoordFlip();
+    void materialTexCoordFlipDequantized();
     void materialTextureCoordinateSetsDefault();
     void materialTextureCoordinateSets();
 
@@ -130,7 +147,11 @@ struct TinyGltfImporterTest: TestSuite::Tester {
     void imageExternalNoPathNoCallback();
 
     void imageBasis();
+    void imageBasisu();
+    void imageBasisuFallback();
     void imageMipLevels();
+    void imageBatch();
+    void imageImporterCache();
 
     void fileCallbackBuffer();
     void fileCallbackBufferNotFound();
@@ -139,8 +160,24 @@ struct TinyGltfImporterTest: TestSuite::Tester {
 
     void utf8filenames();
 
+    void fastJsonParser();
+    void fastJsonParserError();
+
+    void benchmarkOpen();
+    void benchmarkOpenMemory();
+    void benchmarkOpenNameLookup();
+    void benchmarkHierarchy();
+    void benchmarkNameLookup();
+    void benchmarkAnimation();
+    void benchmarkAnimationQuaternionPostprocessing();
+    void benchmarkMeshTextureCoordinateYFlip();
+
+    void benchmarkMemoryBegin();
+    std::uint64_t benchmarkMemoryEnd();
+
     /* Needs to load AnyImageImporter from system-wide location */
     PluginManager::Manager<AbstractImporter> _manager;
+    std::size_t _memoryBenchmarkBase;
 };
 
 /* The external-data.* files are packed in via a resource, filename mapping
@@ -419,6 +456,353 @@ constexpr struct {
     {"embedded binary", "-embedded.glb"},
 };
 
+constexpr struct {
+    const char* name;
+    UnsignedInt threads;
+} ImageBatchData[]{
+    {"single-threaded", 1},
+    {"hardware concurrency", 0},
+    {"three threads", 3}
+};
+
+constexpr struct {
+    const char* name;
+    UnsignedInt cacheSize;
+    std::size_t expectedLoadCount;
+} ImageImporterCacheData[]{
+    {"single importer", 1, 4},
+    {"zero treated as one", 0, 4},
+    {"two importers", 2, 2}
+};
+
+constexpr struct {
+    const char* name;
+    bool buildNameLookupOnOpen;
+} NameLookupData[]{
+    {"lazy", false},
+    {"on open", true}
+};
+
+constexpr struct {
+    const char* name;
+    bool flat;
+} HierarchyData[]{
+    {"object3D()", false},
+    {"flatHierarchy()", true}
+};
+
+constexpr struct {
+    const char* name;
+    bool optimizeQuaternionShortestPath, normalizeQuaternions;
+} QuaternionPostprocessingData[]{
+    {"splines only", false, false},
+    {"shortest path", true, false},
+    {"normalization", false, true},
+    {"shortest path + normalization", true, true}
+};
+
+constexpr struct {
+    const char* name;
+    bool interleaved, textureCoordinateYFlipInMaterial;
+} TextureCoordinateYFlipData[]{
+    {"contiguous", false, false},
+    {"interleaved", true, false},
+    {"flip in material", false, true}
+};
+
+constexpr struct {
+    const char* name;
+    const char* filename;
+} FastJsonParserData[]{
+    {"animation", "animation.gltf"},
+    {"animation, binary", "animation.glb"},
+    {"animation, embedded", "animation-embedded.gltf"},
+    {"camera", "camera.gltf"},
+    {"light", "light.gltf"},
+    {"material", "material-properties.gltf"},
+    {"material, metallic/roughness", "material-metallicroughness.gltf"},
+    {"material, invalid", "material-invalid.gltf"},
+    {"mesh", "mesh.gltf"},
+    {"mesh, primitive types", "mesh-primitives-types.gltf"},
+    {"mesh, custom attributes", "mesh-custom-attributes.gltf"},
+    {"mesh, invalid", "mesh-invalid.gltf"},
+    {"object transformation", "object-transformation.gltf"},
+    {"scene", "scene.gltf"},
+    {"texture", "texture.gltf"},
+    {"image, embedded", "image-embedded.gltf"},
+    {"image, binary", "image-buffer.glb"}
+};
+
+constexpr struct {
+    const char* name;
+    Containers::ArrayView<const char> data;
+    const char* filename;
+    const char* message;
+} FastJsonParserErrorData[]{
+    {"too short", {"{}", 2}, nullptr,
+        "JSON string too short."},
+    {"binary too short", {"glTF?", 5}, nullptr,
+        "Too short data size for glTF Binary."},
+    {"root not an object", {"[1, 2]", 6}, nullptr,
+        "Root element is not a JSON object"},
+    {"unexpected character", {"{\n  \"asset\": {\"version\": \"2.0\"},\n  \"nodes\": [}\n}", 48}, nullptr,
+        "JSON parse error at line 3, column 13: expected a value"},
+    {"invalid escape", {"{\"nodes\": [{\"name\": \"\\q\"}]}", 27}, nullptr,
+        "JSON parse error at line 1, column 22: invalid escape sequence"},
+    {"buffer not found", nullptr, "buffer-notfound.gltf",
+        "File read error : /nonexistent.bin : file not found"}
+};
+
+constexpr struct {
+    const char* name;
+    bool fastJsonParser;
+} JsonParserData[]{
+    {"tinygltf", false},
+    {"fastJsonParser", true}
+};
+
+/* Imports everything that doesn't need an image importer and prints it along
+   with all warnings and errors, used to verify that both JSON parsers give the
+   same result */
+std::string importEverything(AbstractImporter& importer) {
+    std::ostringstream out;
+    Debug redirectOutput{&out};
+    Warning redirectWarning{&out};
+    Error redirectError{&out};
+
+    Debug{} << "default scene" << importer.defaultScene();
+    for(UnsignedInt i = 0; i != importer.sceneCount(); ++i) {
+        Debug{} << "scene" << importer.sceneName(i);
+        if(Containers::Optional<SceneData> scene = importer.scene(i))
+            Debug{} << scene->children3D();
+    }
+    for(UnsignedInt i = 0; i != importer.object3DCount(); ++i) {
+        Debug{} << "object" << importer.object3DName(i);
+        if(Containers::Pointer<ObjectData3D> object = importer.object3D(i))
+            Debug{} << object->children() << object->transformation() << object->instanceType() << object->instance();
+    }
+    for(UnsignedInt i = 0; i != importer.meshCount(); ++i) {
+        Debug{} << "mesh" << importer.meshName(i);
+        Containers::Optional<MeshData> mesh = importer.mesh(i);
+        if(!mesh) continue;
+        Debug{} << mesh->primitive() << mesh->vertexCount() << mesh->attributeCount();
+        for(UnsignedInt j = 0; j != mesh->attributeCount(); ++j)
+            Debug{} << mesh->attributeName(j) << mesh->attributeFormat(j) << mesh->attributeOffset(j) << mesh->attributeStride(j);
+        Debug{} << Containers::arrayCast<const UnsignedByte>(mesh->vertexData());
+        if(mesh->isIndexed())
+            Debug{} << mesh->indexType() << Containers::arrayCast<const UnsignedByte>(mesh->indexData());
+    }
+    for(UnsignedInt i = 0; i != importer.materialCount(); ++i) {
+        Debug{} << "material" << importer.materialName(i);
+        if(Containers::Pointer<AbstractMaterialData> material = importer.material(i)) {
+            Debug{} << material->type() << material->alphaMode() << material->alphaMask();
+            if(material->type() == MaterialType::Phong)
+                Debug{} << static_cast<PhongMaterialData&>(*material).flags();
+        }
+    }
+    for(UnsignedInt i = 0; i != importer.textureCount(); ++i) {
+        Debug{} << "texture" << importer.textureName(i);
+        if(Containers::Optional<TextureData> texture = importer.texture(i))
+            Debug{} << texture->type() << texture->minificationFilter() << texture->magnificationFilter() << texture->mipmapFilter() << texture->wrapping() << texture->image();
+    }
+    for(UnsignedInt i = 0; i != importer.image2DCount(); ++i)
+        Debug{} << "image" << importer.image2DName(i);
+    for(UnsignedInt i = 0; i != importer.cameraCount(); ++i) {
+        Debug{} << "camera" << importer.cameraName(i);
+        if(Containers::Optional<CameraData> camera = importer.camera(i))
+            Debug{} << camera->type() << camera->size() << camera->aspectRatio() << camera->near() << camera->far();
+    }
+    for(UnsignedInt i = 0; i != importer.lightCount(); ++i) {
+        Debug{} << "light" << importer.lightName(i);
+        if(Containers::Optional<LightData> light = importer.light(i))
+            Debug{} << light->type() << light->color() << light->intensity();
+    }
+    for(UnsignedInt i = 0; i != importer.animationCount(); ++i) {
+        Debug{} << "animation" << importer.animationName(i);
+        Containers::Optional<AnimationData> animation = importer.animation(i);
+        if(!animation) continue;
+        Debug{} << animation->duration() << animation->trackCount();
+        for(UnsignedInt j = 0; j != animation->trackCount(); ++j)
+            Debug{} << animation->trackType(j) << animation->trackTargetType(j) << animation->trackTarget(j);
+        Debug{} << Containers::arrayCast<const UnsignedByte>(animation->data());
+    }
+
+    return out.str();
+}
+
+/* Used by benchmarkOpenMemory(), counts the bytes currently allocated through
+   the global operator new and the peak since the last reset. The size is
+   stored in front of each allocation so operator delete knows what to
+   subtract. */
+std::atomic<std::size_t> allocatedBytes{}, peakAllocatedBytes{};
+
+/* Big enough to keep the malloc() alignment on all supported platforms */
+constexpr std::size_t AllocationHeaderSize = 16;
+
+void* allocate(const std::size_t size) noexcept {
+    char* const memory = static_cast<char*>(std::malloc(size + AllocationHeaderSize));
+    if(!memory) return nullptr;
+    *reinterpret_cast<std::size_t*>(memory) = size;
+    const std::size_t allocated = allocatedBytes += size;
+    std::size_t peak = peakAllocatedBytes;
+    while(allocated > peak && !peakAllocatedBytes.compare_exchange_weak(peak, allocated));
+    return memory + AllocationHeaderSize;
+}
+
+void deallocate(void* const pointer) noexcept {
+    if(!pointer) return;
+    char* const memory = static_cast<char*>(pointer) - AllocationHeaderSize;
+    allocatedBytes -= *reinterpret_cast<std::size_t*>(memory);
+    std::free(memory);
+}
+
+/* Used by the benchmarks, a glTF file with given count of named nodes */
+constexpr std::size_t BenchmarkNodeCount = 10000;
+std::string manyNodesGltf(const std::size_t count) {
+    std::string out = R"({"asset":{"version":"2.0"},"nodes":[)";
+    for(std::size_t i = 0; i != count; ++i) {
+        if(i) out += ',';
+        out += R"({"name":"node)" + std::to_string(i) + R"("})";
+    }
+    out += "]}";
+    return out;
+}
+
+/* Packs JSON and binary data into a GLB file, used by the benchmarks */
+std::string glbFile(std::string json, const std::vector<Float>& bin) {
+    /* Chunks have to be padded to four bytes */
+    json.append((4 - json.size() % 4) % 4, ' ');
+    const std::size_t binSize = bin.size()*sizeof(Float);
+
+    std::string out;
+    const auto appendUnsignedInt = [&out](const UnsignedInt value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(UnsignedInt));
+    };
+    out += "glTF";
+    appendUnsignedInt(2);
+    appendUnsignedInt(12 + 8 + json.size() + 8 + binSize);
+    appendUnsignedInt(json.size());
+    out += "JSON";
+    out += json;
+    appendUnsignedInt(binSize);
+    out.append("BIN\0", 4);
+    out.append(reinterpret_cast<const char*>(bin.data()), binSize);
+    return out;
+}
+
+/* Used by the open benchmark, a GLB file with given count of nodes, each
+   referencing its own mesh with its own accessor */
+constexpr std::size_t BenchmarkMeshCount = 100000;
+std::string manyMeshesGlb(const std::size_t count) {
+    std::string nodes, meshes, accessors;
+    for(std::size_t i = 0; i != count; ++i) {
+        if(i) {
+            nodes += ',';
+            meshes += ',';
+            accessors += ',';
+        }
+        const std::string id = std::to_string(i);
+        nodes += R"({"name":"node)" + id + R"(","mesh":)" + id + R"(,"translation":[1,2,3]})";
+        meshes += R"({"name":"mesh)" + id + R"(","primitives":[{"attributes":{"POSITION":)" + id + "}}]}";
+        accessors += R"({"bufferView":0,"componentType":5126,"count":1,"type":"VEC3"})";
+    }
+
+    return glbFile(R"({"asset":{"version":"2.0"},"nodes":[)" + nodes + R"(],"meshes":[)" + meshes + R"(],"accessors":[)" + accessors + R"(],"bufferViews":[{"buffer":0,"byteLength":12}],"buffers":[{"byteLength":12}]})", {1.0f, 2.0f, 3.0f});
+}
+
+/* Used by the animation benchmark, a GLB file with given count of linearly
+   interpolated rotation and translation channels. Each channel has its own
+   time track, all with the same contents. */
+constexpr std::size_t BenchmarkChannelCount = 2000;
+constexpr std::size_t BenchmarkKeyCount = 100;
+std::string manyChannelsGlb(const std::size_t channelCount, const std::size_t keyCount) {
+    std::string channels, samplers, accessors;
+    std::vector<Float> bin;
+    for(std::size_t i = 0; i != channelCount; ++i) {
+        const bool rotation = i % 2 == 0;
+        if(i) {
+            channels += ',';
+            samplers += ',';
+            accessors += ',';
+        }
+        channels += R"({"sampler":)" + std::to_string(i) + R"(,"target":{"node":0,"path":")" + (rotation ? "rotation" : "translation") + R"("}})";
+        samplers += R"({"input":)" + std::to_string(2*i) + R"(,"interpolation":"LINEAR","output":)" + std::to_string(2*i + 1) + "}";
+        accessors += R"({"bufferView":0,"byteOffset":)" + std::to_string(bin.size()*sizeof(Float)) + R"(,"componentType":5126,"count":)" + std::to_string(keyCount) + R"(,"type":"SCALAR"})";
+        for(std::size_t j = 0; j != keyCount; ++j)
+            bin.push_back(j*0.1f);
+        accessors += R"(,{"bufferView":0,"byteOffset":)" + std::to_string(bin.size()*sizeof(Float)) + R"(,"componentType":5126,"count":)" + std::to_string(keyCount) + R"(,"type":")" + (rotation ? "VEC4" : "VEC3") + R"("})";
+        for(std::size_t j = 0; j != keyCount; ++j) {
+            if(rotation) bin.insert(bin.end(), {0.0f, 0.0f, 0.0f, 1.0f});
+            else bin.insert(bin.end(), {Float(j), 0.0f, 0.0f});
+        }
+    }
+
+    const std::string binSize = std::to_string(bin.size()*sizeof(Float));
+    return glbFile(R"({"asset":{"version":"2.0"},"nodes":[{}],"animations":[{"channels":[)" + channels + R"(],"samplers":[)" + samplers + R"(]}],"accessors":[)" + accessors + R"(],"bufferViews":[{"buffer":0,"byteLength":)" + binSize + R"(}],"buffers":[{"byteLength":)" + binSize + "}]}", bin);
+}
+
+/* Used by the quaternion postprocessing benchmark, a GLB file with a linearly
+   interpolated and a spline-interpolated rotation channel, with the linear
+   one needing both shortest path patching and renormalization */
+constexpr std::size_t BenchmarkRotationKeyCount = 100000;
+std::string rotationChannelsGlb(const std::size_t keyCount) {
+    std::vector<Float> bin;
+    for(std::size_t i = 0; i != keyCount; ++i)
+        bin.push_back(i*0.1f);
+    for(std::size_t i = 0; i != keyCount; ++i) {
+        const Quaternion q = Quaternion::rotation(Deg(i*25.0f), Vector3::zAxis())*(i % 3 ? 1.0f : -1.0f)*(i % 5 ? 1.0f : 2.0f);
+        bin.insert(bin.end(), {q.vector().x(), q.vector().y(), q.vector().z(), q.scalar()});
+    }
+    for(std::size_t i = 0; i != keyCount; ++i) {
+        const Quaternion q = Quaternion::rotation(Deg(i*25.0f), Vector3::zAxis());
+        for(const Quaternion& value: {q*0.5f, q, q*0.5f})
+            bin.insert(bin.end(), {value.vector().x(), value.vector().y(), value.vector().z(), value.scalar()});
+    }
+
+    const std::string count = std::to_string(keyCount);
+    const std::string binSize = std::to_string(bin.size()*sizeof(Float));
+    return glbFile(R"({"asset":{"version":"2.0"},"nodes":[{}],"animations":[{"channels":[)"
+        R"({"sampler":0,"target":{"node":0,"path":"rotation"}},)"
+        R"({"sampler":1,"target":{"node":0,"path":"rotation"}}],"samplers":[)"
+        R"({"input":0,"interpolation":"LINEAR","output":1},)"
+        R"({"input":0,"interpolation":"CUBICSPLINE","output":2}]}],"accessors":[)"
+        R"({"bufferView":0,"componentType":5126,"count":)" + count + R"(,"type":"SCALAR"},)"
+        R"({"bufferView":0,"byteOffset":)" + std::to_string(keyCount*sizeof(Float)) + R"(,"componentType":5126,"count":)" + count + R"(,"type":"VEC4"},)"
+        R"({"bufferView":0,"byteOffset":)" + std::to_string(keyCount*(sizeof(Float) + sizeof(Quaternion))) + R"(,"componentType":5126,"count":)" + std::to_string(3*keyCount) + R"(,"type":"VEC4"}],)"
+        R"("bufferViews":[{"buffer":0,"byteLength":)" + binSize + R"(}],"buffers":[{"byteLength":)" + binSize + "}]}", bin);
+}
+
+/* Used by the texture coordinate Y-flip benchmark, a GLB file with a mesh
+   having two texture coordinate sets, either each in its own buffer view or
+   interleaved together */
+constexpr std::size_t BenchmarkVertexCount = 1000000;
+std::string textureCoordinatesGlb(const std::size_t vertexCount, const bool interleaved) {
+    std::vector<Float> bin;
+    bin.reserve(vertexCount*4);
+    if(interleaved) for(std::size_t i = 0; i != vertexCount; ++i)
+        bin.insert(bin.end(), {i*0.5f, i*0.25f, i*0.125f, i*0.0625f});
+    else {
+        for(std::size_t i = 0; i != vertexCount; ++i)
+            bin.insert(bin.end(), {i*0.5f, i*0.25f});
+        for(std::size_t i = 0; i != vertexCount; ++i)
+            bin.insert(bin.end(), {i*0.125f, i*0.0625f});
+    }
+
+    const std::string count = std::to_string(vertexCount);
+    const std::string viewSize = std::to_string(vertexCount*sizeof(Vector2));
+    const std::string binSize = std::to_string(bin.size()*sizeof(Float));
+    return glbFile(R"({"asset":{"version":"2.0"},"meshes":[{"primitives":[{"attributes":{"TEXCOORD_0":0,"TEXCOORD_1":1}}]}],"accessors":[)" +
+        (interleaved ?
+            R"({"bufferView":0,"componentType":5126,"count":)" + count + R"(,"type":"VEC2"},)"
+            R"({"bufferView":0,"byteOffset":8,"componentType":5126,"count":)" + count + R"(,"type":"VEC2"}],)"
+            R"("bufferViews":[{"buffer":0,"byteStride":16,"byteLength":)" + binSize + "}],"
+        :
+            R"({"bufferView":0,"componentType":5126,"count":)" + count + R"(,"type":"VEC2"},)"
+            R"({"bufferView":1,"componentType":5126,"count":)" + count + R"(,"type":"VEC2"}],)"
+            R"("bufferViews":[{"buffer":0,"byteLength":)" + viewSize + R"(},{"buffer":0,"byteOffset":)" + viewSize + R"(,"byteLength":)" + viewSize + "}],") +
+        R"("buffers":[{"byteLength":)" + binSize + "}]}", bin);
+}
+
 using namespace Magnum::Math::Literals;
 
 TinyGltfImporterTest::TinyGltfImporterTest() {
@@ -444,11 +828,13 @@ TinyGltfImporterTest::TinyGltfImporterTest() {
 
     addTests({&TinyGltfImporterTest::animationSplineSharedWithSameTimeTrack,
               &TinyGltfImporterTest::animationSplineSharedWithDifferentTimeTrack,
+              &TinyGltfImporterTest::animationTimeTrackDeduplication,
 
               &TinyGltfImporterTest::animationShortestPathOptimizationEnabled,
               &TinyGltfImporterTest::animationShortestPathOptimizationDisabled,
               &TinyGltfImporterTest::animationQuaternionNormalizationEnabled,
               &TinyGltfImporterTest::animationQuaternionNormalizationDisabled,
+              &TinyGltfImporterTest::animationQuaternionNormalizationManyKeys,
               &TinyGltfImporterTest::animationMergeEmpty,
               &TinyGltfImporterTest::animationMerge});
 
@@ -462,9 +848,14 @@ TinyGltfImporterTest::TinyGltfImporterTest() {
                        &TinyGltfImporterTest::objectTransformation},
                       Containers::arraySize(SingleFileData));
 
+    addTests({&TinyGltfImporterTest::flatHierarchy});
+
     addTests({&TinyGltfImporterTest::objectTransformationQuaternionNormalizationEnabled,
               &TinyGltfImporterTest::objectTransformationQuaternionNormalizationDisabled});
 
+    addInstancedTests({&TinyGltfImporterTest::nameLookupOnOpen},
+                      Containers::arraySize(SingleFileData));
+
     addInstancedTests({&TinyGltfImporterTest::mesh},
                       Containers::arraySize(MultiFileData));
 
@@ -474,9 +865,12 @@ TinyGltfImporterTest::TinyGltfImporterTest() {
               &TinyGltfImporterTest::meshColors,
               &TinyGltfImporterTest::meshCustomAttributes,
               &TinyGltfImporterTest::meshCustomAttributesNoFileOpened,
-              &TinyGltfImporterTest::meshMultiplePrimitives});
+              &TinyGltfImporterTest::meshMultiplePrimitives,
+              &TinyGltfImporterTest::meshTextureCoordinateYFlip,
+              &TinyGltfImporterTest::meshTextureCoordinateYFlipDequantized});
 
-    addInstancedTests({&TinyGltfImporterTest::meshPrimitivesTypes},
+    addInstancedTests({&TinyGltfImporterTest::meshPrimitivesTypes,
+                       &TinyGltfImporterTest::meshDequantize},
         Containers::arraySize(MeshPrimitivesTypesData));
 
     addTests({&TinyGltfImporterTest::meshIndexAccessorOutOfBounds});
@@ -493,7 +887,8 @@ TinyGltfImporterTest::TinyGltfImporterTest() {
     addInstancedTests({&TinyGltfImporterTest::materialInvalid},
         Containers::arraySize(MaterialInvalidData));
 
-    addInstancedTests({&TinyGltfImporterTest::materialTexCoordFlip},
+    addInstancedTests({&TinyGltfImporterTest::materialTexCoordFlip,
+                       &TinyGltfImporterTest::materialTexCoordFlipDequantized},
         Containers::arraySize(MaterialTexCoordFlipData));
 
     addInstancedTests({&TinyGltfImporterTest::texture,
@@ -515,8 +910,17 @@ TinyGltfImporterTest::TinyGltfImporterTest() {
     addInstancedTests({&TinyGltfImporterTest::imageBasis},
                       Containers::arraySize(ImageBasisData));
 
+    addTests({&TinyGltfImporterTest::imageBasisu,
+              &TinyGltfImporterTest::imageBasisuFallback});
+
     addTests({&TinyGltfImporterTest::imageMipLevels});
 
+    addInstancedTests({&TinyGltfImporterTest::imageBatch},
+                      Containers::arraySize(ImageBatchData));
+
+    addInstancedTests({&TinyGltfImporterTest::imageImporterCache},
+                      Containers::arraySize(ImageImporterCacheData));
+
     addInstancedTests({&TinyGltfImporterTest::fileCallbackBuffer,
                        &TinyGltfImporterTest::fileCallbackBufferNotFound,
                        &TinyGltfImporterTest::fileCallbackImage,
@@ -525,6 +929,36 @@ TinyGltfImporterTest::TinyGltfImporterTest() {
 
     addTests({&TinyGltfImporterTest::utf8filenames});
 
+    addInstancedTests({&TinyGltfImporterTest::fastJsonParser},
+        Containers::arraySize(FastJsonParserData));
+
+    addInstancedTests({&TinyGltfImporterTest::fastJsonParserError},
+        Containers::arraySize(FastJsonParserErrorData));
+
+    addInstancedBenchmarks({&TinyGltfImporterTest::benchmarkOpen}, 5,
+        Containers::arraySize(JsonParserData));
+
+    addCustomInstancedBenchmarks({&TinyGltfImporterTest::benchmarkOpenMemory}, 1,
+        Containers::arraySize(JsonParserData),
+        &TinyGltfImporterTest::benchmarkMemoryBegin,
+        &TinyGltfImporterTest::benchmarkMemoryEnd,
+        BenchmarkUnits::Bytes);
+
+    addInstancedBenchmarks({&TinyGltfImporterTest::benchmarkOpenNameLookup}, 5,
+        Containers::arraySize(NameLookupData));
+
+    addInstancedBenchmarks({&TinyGltfImporterTest::benchmarkHierarchy}, 5,
+        Containers::arraySize(HierarchyData));
+
+    addBenchmarks({&TinyGltfImporterTest::benchmarkNameLookup,
+                   &TinyGltfImporterTest::benchmarkAnimation}, 5);
+
+    addInstancedBenchmarks({&TinyGltfImporterTest::benchmarkAnimationQuaternionPostprocessing}, 5,
+        Containers::arraySize(QuaternionPostprocessingData));
+
+    addInstancedBenchmarks({&TinyGltfImporterTest::benchmarkMeshTextureCoordinateYFlip}, 5,
+        Containers::arraySize(TextureCoordinateYFlipData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. It also pulls in the AnyImageImporter dependency. Reset
        the plugin dir after so it doesn't load anything else from the filesystem. */
@@ -911,6 +1345,34 @@ void TinyGltfImporterTest::animationSplineSharedWithDifferentTimeTrack() {
     CORRADE_COMPARE(out.str(), "Trade::TinyGltfImporter::animation(): spline track is shared with different time tracks, we don't support that, sorry\n");
 }
 
+void TinyGltfImporterTest::animationTimeTrackDeduplication() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "animation-time-sharing.gltf")));
+    CORRADE_COMPARE(importer->animationCount(), 1);
+
+    auto animation = importer->animation(0);
+    CORRADE_VERIFY(animation);
+    /* The first two time tracks have the same contents and so they're stored
+       just once, the third differs in the middle value. The translation data
+       are used by all three tracks. */
+    CORRADE_COMPARE(animation->data().size(),
+        2*3*sizeof(Float) + 3*sizeof(Vector3));
+    CORRADE_COMPARE(animation->trackCount(), 3);
+
+    Animation::TrackView<const Float, const Vector3> translation = animation->track<Vector3>(0);
+    Animation::TrackView<const Float, const Vector3> scaling = animation->track<Vector3>(1);
+    Animation::TrackView<const Float, const Vector3> translation2 = animation->track<Vector3>(2);
+    CORRADE_COMPARE(translation.keys().data(), scaling.keys().data());
+    CORRADE_VERIFY(translation.keys().data() != translation2.keys().data());
+    CORRADE_COMPARE(translation.values().data(), translation2.values().data());
+    const Float expectedKeys[]{0.0f, 1.0f, 2.0f};
+    const Float expectedKeys2[]{0.0f, 1.5f, 2.0f};
+    CORRADE_COMPARE_AS(scaling.keys(), (Containers::StridedArrayView1D<const Float>{expectedKeys}), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(translation2.keys(), (Containers::StridedArrayView1D<const Float>{expectedKeys2}), TestSuite::Compare::Container);
+    CORRADE_COMPARE(scaling.at(1.5f), (Vector3{2.5f, 3.5f, 4.5f}));
+}
+
 void TinyGltfImporterTest::animationShortestPathOptimizationEnabled() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
     /* Enabled by default */
@@ -1082,6 +1544,45 @@ void TinyGltfImporterTest::animationQuaternionNormalizationDisabled() {
     CORRADE_COMPARE_AS(track.values(), (Containers::StridedArrayView1D<const Quaternion>{rotationValues}), TestSuite::Compare::Container);
 }
 
+void TinyGltfImporterTest::animationQuaternionNormalizationManyKeys() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "animation-quaternion-normalization.gltf")));
+    CORRADE_COMPARE(importer->animationCount(), 1);
+
+    Containers::Optional<AnimationData> animation;
+    std::ostringstream out;
+    {
+        Warning warningRedirection{&out};
+        animation = importer->animation(0);
+    }
+    CORRADE_VERIFY(animation);
+    CORRADE_COMPARE(out.str(), "Trade::TinyGltfImporter::animation(): quaternions in some rotation tracks were renormalized\n");
+    CORRADE_COMPARE(animation->trackCount(), 1);
+    CORRADE_COMPARE(animation->trackType(0), AnimationTrackType::Quaternion);
+
+    /* More than four keys and not a multiple of four, so both the vectorized
+       variant and the remainder get tested. Should be the same as in
+       animation-quaternion-normalization.bin.in. */
+    Animation::TrackView<const Float, const Quaternion> track = animation->track<Quaternion>(0);
+    const Quaternion rotationValues[]{
+        {{0.0f, 0.0f, 0.0f}, 1.0f},
+        {{0.0f, 0.0f, 0.087156f}, 0.996195f},
+        {{0.0f, 0.0f, 0.173648f}, 0.984808f},
+        {{0.0f, 0.0f, 0.258819f}, 0.965926f},
+        {{0.0f, 0.0f, 0.342020f}, 0.939693f},
+        {{0.0f, 0.0f, 0.422618f}, 0.906308f},   // renormalized
+        {{0.0f, 0.0f, 0.5f}, 0.866025f},
+        {{0.0f, 0.0f, 0.573576f}, 0.819152f},   // renormalized
+        {{0.0f, 0.0f, 0.642788f}, 0.766044f}    // renormalized
+    };
+    CORRADE_COMPARE_AS(track.values(), (Containers::StridedArrayView1D<const Quaternion>{rotationValues}), TestSuite::Compare::Container);
+    for(std::size_t i = 0; i != track.values().size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(track.values()[i].isNormalized());
+    }
+}
+
 void TinyGltfImporterTest::animationMergeEmpty() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
     /* Enable animation merging */
@@ -1486,6 +1987,62 @@ void TinyGltfImporterTest::objectTransformation() {
     }
 }
 
+void TinyGltfImporterTest::flatHierarchy() {
+    #ifdef TINYGLTFIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only if the plugin is built as static.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+
+    {
+        CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, "scene.gltf")));
+
+        TinyGltfImporter::FlatHierarchy hierarchy = static_cast<TinyGltfImporter&>(*importer).flatHierarchy();
+        CORRADE_COMPARE_AS(hierarchy.parents, Containers::arrayView<Int>({
+            1, 4, -1, 4, -1
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(hierarchy.meshes, Containers::arrayView<Int>({
+            -1, -1, 0, -1, -1
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(hierarchy.materials, Containers::arrayView<Int>({
+            -1, -1, -1, -1, -1
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(hierarchy.cameras, Containers::arrayView<Int>({
+            0, -1, -1, -1, -1
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(hierarchy.lights, Containers::arrayView<Int>({
+            -1, -1, -1, 0, -1
+        }), TestSuite::Compare::Container);
+    } {
+        CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, "mesh-multiple-primitives.gltf")));
+
+        /* The extra multi-primitive nodes are children of the original node,
+           which has the first primitive */
+        TinyGltfImporter::FlatHierarchy hierarchy = static_cast<TinyGltfImporter&>(*importer).flatHierarchy();
+        CORRADE_COMPARE_AS(hierarchy.parents, Containers::arrayView<Int>({
+            -1, 0, 0, 0, -1, -1, 5, 5, 0, 8
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(hierarchy.meshes, Containers::arrayView<Int>({
+            1, 2, 3, 0, -1, 1, 2, 3, 5, 6
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE(hierarchy.transformations[1], Matrix4{});
+    } {
+        CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, "object-transformation.gltf")));
+
+        /* The transformations should be the same as with object3D(), both
+           for matrices and for TRS */
+        TinyGltfImporter::FlatHierarchy hierarchy = static_cast<TinyGltfImporter&>(*importer).flatHierarchy();
+        CORRADE_COMPARE(hierarchy.transformations.size(), importer->object3DCount());
+        for(UnsignedInt i = 0; i != importer->object3DCount(); ++i) {
+            CORRADE_ITERATION(i);
+            Containers::Pointer<ObjectData3D> object = importer->object3D(i);
+            CORRADE_VERIFY(object);
+            CORRADE_COMPARE(hierarchy.transformations[i], object->transformation());
+            CORRADE_COMPARE(hierarchy.meshes[i], object->instanceType() == ObjectInstanceType3D::Mesh ? object->instance() : -1);
+        }
+    }
+    #endif
+}
+
 void TinyGltfImporterTest::objectTransformationQuaternionNormalizationEnabled() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
     /* Enabled by default */
@@ -1524,6 +2081,28 @@ void TinyGltfImporterTest::objectTransformationQuaternionNormalizationDisabled()
     CORRADE_COMPARE(object->rotation(), Quaternion::rotation(45.0_degf, Vector3::yAxis())*2.0f);
 }
 
+void TinyGltfImporterTest::nameLookupOnOpen() {
+    auto&& data = SingleFileData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("buildNameLookupOnOpen", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "scene" + std::string{data.suffix})));
+
+    /* The same name used for different object kinds shouldn't clash */
+    CORRADE_COMPARE(importer->cameraForName("Camera"), 0);
+    CORRADE_COMPARE(importer->object3DForName("Camera"), 0);
+    CORRADE_COMPARE(importer->meshForName("Camera"), -1);
+    CORRADE_COMPARE(importer->lightForName("Lamp"), 0);
+    CORRADE_COMPARE(importer->lightForName("Ambient_Scene"), 1);
+    CORRADE_COMPARE(importer->object3DForName("Lamp"), -1);
+    CORRADE_COMPARE(importer->materialForName("Material"), 0);
+    CORRADE_COMPARE(importer->object3DForName("Empty 2"), 4);
+    CORRADE_COMPARE(importer->sceneForName("Scene"), 1);
+    CORRADE_COMPARE(importer->sceneForName("Nonexistent"), -1);
+}
+
 void TinyGltfImporterTest::mesh() {
     auto&& data = MultiFileData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -1943,6 +2522,154 @@ void TinyGltfImporterTest::meshMultiplePrimitives() {
     }
 }
 
+void TinyGltfImporterTest::meshTextureCoordinateYFlip() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-texcoord-flip.gltf")));
+    CORRADE_COMPARE(importer->meshCount(), 3);
+
+    /* The attributes are long enough to go through both the SIMD loop and
+       the scalar remainder when flipped during the copy */
+    {
+        CORRADE_ITERATION("float");
+        auto mesh = importer->mesh("float");
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::TextureCoordinates), VertexFormat::Vector2);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+            Containers::arrayView<Vector2>({
+                {0.0f, 1.0f},
+                {0.1f, 0.95f},
+                {0.2f, 0.9f},
+                {0.3f, 0.85f},
+                {0.4f, 0.8f},
+                {0.5f, 0.75f},
+                {0.6f, 0.7f},
+                {0.7f, 0.65f},
+                {0.8f, 0.6f},
+                {0.9f, 0.55f},
+                {1.0f, 0.5f}
+            }), TestSuite::Compare::Container);
+    } {
+        CORRADE_ITERATION("normalized unsigned byte");
+        auto mesh = importer->mesh("normalized unsigned byte");
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::TextureCoordinates), VertexFormat::Vector2ubNormalized);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector2ub>(MeshAttribute::TextureCoordinates),
+            Containers::arrayView<Vector2ub>({
+                {0, 255},
+                {20, 232},
+                {40, 209},
+                {60, 186},
+                {80, 163},
+                {100, 140},
+                {120, 117},
+                {140, 94},
+                {160, 71},
+                {180, 48},
+                {200, 0}
+            }), TestSuite::Compare::Container);
+    } {
+        CORRADE_ITERATION("normalized unsigned short");
+        auto mesh = importer->mesh("normalized unsigned short");
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::TextureCoordinates), VertexFormat::Vector2usNormalized);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector2us>(MeshAttribute::TextureCoordinates),
+            Containers::arrayView<Vector2us>({
+                {0, 65535},
+                {10000, 53190},
+                {20000, 40845},
+                {30000, 28500},
+                {65535, 0}
+            }), TestSuite::Compare::Container);
+    }
+}
+
+void TinyGltfImporterTest::meshTextureCoordinateYFlipDequantized() {
+    /* Y-flip is left at the default, so the dequantized texture coordinates
+       get flipped in the mesh. Compare to what MeshData unpacks from the
+       quantized data, which are flipped before unpacking. */
+    Containers::Pointer<AbstractImporter> quantizedImporter = _manager.instantiate("TinyGltfImporter");
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("dequantizeAttributes", true);
+    CORRADE_VERIFY(quantizedImporter->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-texcoord-flip.gltf")));
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-texcoord-flip.gltf")));
+
+    /* The attributes are long enough to go through both the SIMD loop and
+       the scalar remainder when dequantized */
+    for(const char* name: {"normalized unsigned byte", "normalized unsigned short"}) {
+        CORRADE_ITERATION(name);
+        auto quantized = quantizedImporter->mesh(name);
+        auto mesh = importer->mesh(name);
+        CORRADE_VERIFY(quantized);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::TextureCoordinates), VertexFormat::Vector2);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+            Containers::arrayView(quantized->textureCoordinates2DAsArray()),
+            TestSuite::Compare::Container);
+    }
+}
+
+void TinyGltfImporterTest::meshDequantize() {
+    auto&& data = MeshPrimitivesTypesData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Compare to what MeshData unpacks from the quantized data, which should
+       be exactly the same. Y-flipping disabled as in meshPrimitivesTypes(),
+       dequantization combined with Y-flipping is tested in
+       meshTextureCoordinateYFlipDequantized() and
+       materialTexCoordFlipDequantized(). */
+    Containers::Pointer<AbstractImporter> quantizedImporter = _manager.instantiate("TinyGltfImporter");
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    quantizedImporter->configuration().setValue("textureCoordinateYFlipInMaterial", true);
+    importer->configuration().setValue("textureCoordinateYFlipInMaterial", true);
+    importer->configuration().setValue("dequantizeAttributes", true);
+    if(data.objectIdAttribute) {
+        quantizedImporter->configuration().setValue("objectIdAttribute", data.objectIdAttribute);
+        importer->configuration().setValue("objectIdAttribute", data.objectIdAttribute);
+    }
+
+    CORRADE_VERIFY(quantizedImporter->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-primitives-types.gltf")));
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-primitives-types.gltf")));
+
+    auto quantized = quantizedImporter->mesh(data.name);
+    auto mesh = importer->mesh(data.name);
+    CORRADE_VERIFY(quantized);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexCount(), quantized->vertexCount());
+
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3);
+    CORRADE_COMPARE_AS(mesh->positions3DAsArray(), quantized->positions3DAsArray(),
+        TestSuite::Compare::Container);
+
+    if(data.normalFormat != VertexFormat{}) {
+        CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Normal), VertexFormat::Vector3);
+        CORRADE_COMPARE_AS(mesh->normalsAsArray(), quantized->normalsAsArray(),
+            TestSuite::Compare::Container);
+    }
+
+    if(data.tangentFormat != VertexFormat{}) {
+        CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Tangent), VertexFormat::Vector4);
+        CORRADE_COMPARE_AS(mesh->tangentsAsArray(), quantized->tangentsAsArray(),
+            TestSuite::Compare::Container);
+    }
+
+    if(data.textureCoordinateFormat != VertexFormat{}) {
+        CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::TextureCoordinates), VertexFormat::Vector2);
+        CORRADE_COMPARE_AS(mesh->textureCoordinates2DAsArray(), quantized->textureCoordinates2DAsArray(),
+            TestSuite::Compare::Container);
+    }
+
+    /* Colors and object IDs are kept as-is */
+    if(data.colorFormat != VertexFormat{})
+        CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Color), data.colorFormat);
+    if(data.objectIdFormat != VertexFormat{})
+        CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::ObjectId), data.objectIdFormat);
+}
+
 void TinyGltfImporterTest::meshPrimitivesTypes() {
     auto&& data = MeshPrimitivesTypesData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -2517,6 +3244,44 @@ void TinyGltfImporterTest::materialTexCoordFlip() {
     }), TestSuite::Compare::Container);
 }
 
+void TinyGltfImporterTest::materialTexCoordFlipDequantized() {
+    auto&& data = MaterialTexCoordFlipData[testCaseInstanceId()];
+    setTestCaseDescription(Utility::formatString("{}{}", data.name, data.flipInMaterial ? ", textureCoordinateYFlipInMaterial" : ""));
+
+    /* Same as materialTexCoordFlip(), but with the quantized texture
+       coordinates converted to floats. The normalized unsigned ones get
+       Y-flipped after being dequantized, the others still have the flip in
+       the material. */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("dequantizeAttributes", true);
+    if(data.flipInMaterial)
+        importer->configuration().setValue("textureCoordinateYFlipInMaterial", true);
+
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        data.fileName)));
+
+    auto mesh = importer->mesh(data.meshName);
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(mesh->hasAttribute(MeshAttribute::TextureCoordinates));
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::TextureCoordinates), VertexFormat::Vector2);
+    Containers::Array<Vector2> texCoords = mesh->textureCoordinates2DAsArray();
+
+    auto material = importer->material(data.name);
+    CORRADE_VERIFY(material);
+    CORRADE_COMPARE(material->type(), MaterialType::Phong);
+    auto& phongMaterial = static_cast<PhongMaterialData&>(*material);
+    if(data.flipInMaterial) CORRADE_COMPARE(phongMaterial.flags(),
+        data.materialFlags|PhongMaterialData::Flag::TextureTransformation);
+    else CORRADE_COMPARE(phongMaterial.flags(), data.materialFlags);
+
+    MeshTools::transformPointsInPlace(phongMaterial.textureMatrix(), texCoords);
+    CORRADE_COMPARE_AS(texCoords, Containers::arrayView<Vector2>({
+        {1.0f, 0.5f},
+        {0.5f, 1.0f},
+        {0.0f, 0.0f}
+    }), TestSuite::Compare::Container);
+}
+
 void TinyGltfImporterTest::materialTextureCoordinateSetsDefault() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
@@ -2783,6 +3548,85 @@ void TinyGltfImporterTest::imageBasis() {
     CORRADE_COMPARE(texture->image(), 1);
 }
 
+void TinyGltfImporterTest::imageBasisu() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("preferKhrTextureBasisu", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, "image-basisu.gltf")));
+
+    CORRADE_COMPARE(importer->textureCount(), 1);
+    CORRADE_COMPARE(importer->image2DCount(), 2);
+
+    /* The extension source should be picked over the PNG fallback if
+       requested */
+    auto texture = importer->texture(0);
+    CORRADE_VERIFY(texture);
+    CORRADE_COMPARE(texture->image(), 1);
+
+    if(_manager.loadState("BasisImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("BasisImporter plugin not found, cannot test");
+
+    /* Import as ASTC, no RGBA decode needed */
+    _manager.metadata("BasisImporter")->configuration().setValue("format", "Astc4x4RGBA");
+
+    auto image = importer->image2D(1);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(image->isCompressed());
+    CORRADE_COMPARE(image->size(), Vector2i(5, 3));
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Astc4x4RGBAUnorm);
+}
+
+void TinyGltfImporterTest::imageBasisuFallback() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    /* Disabled by default */
+    CORRADE_VERIFY(!importer->configuration().value<bool>("preferKhrTextureBasisu"));
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, "image-basisu-ktx2.gltf")));
+
+    CORRADE_COMPARE(importer->textureCount(), 4);
+    CORRADE_COMPARE(importer->image2DCount(), 2);
+
+    /* The KTX2 image can't be imported, so the core PNG source is used */
+    {
+        auto texture = importer->texture(0);
+        CORRADE_VERIFY(texture);
+        CORRADE_COMPARE(texture->image(), 0);
+    }
+
+    /* If there's no core source, the extension is used always */
+    {
+        auto texture = importer->texture(1);
+        CORRADE_VERIFY(texture);
+        CORRADE_COMPARE(texture->image(), 1);
+    }
+
+    /* The extension source gets bounds-checked */
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->texture(2));
+        CORRADE_VERIFY(!importer->texture(3));
+        CORRADE_COMPARE(out.str(),
+            "Trade::TinyGltfImporter::texture(): KHR_texture_basisu image 2 out of bounds for 2 images\n"
+            "Trade::TinyGltfImporter::texture(): invalid KHR_texture_basisu image source\n");
+    }
+
+    /* If the extension is preferred, the KTX2 image is picked even though it
+       can't be imported */
+    importer->configuration().setValue("preferKhrTextureBasisu", true);
+    {
+        auto texture = importer->texture(0);
+        CORRADE_VERIFY(texture);
+        CORRADE_COMPARE(texture->image(), 1);
+    }
+
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    /* The fallback image imports fine */
+    auto image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(5, 3));
+}
+
 void TinyGltfImporterTest::imageMipLevels() {
     if(_manager.loadState("BasisImporter") == PluginManager::LoadState::NotFound)
         CORRADE_SKIP("BasisImporter plugin not found, cannot test");
@@ -2843,6 +3687,78 @@ void TinyGltfImporterTest::imageMipLevels() {
         }), TestSuite::Compare::Container);
 }
 
+void TinyGltfImporterTest::imageBatch() {
+    auto&& data = ImageBatchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifdef TINYGLTFIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only if the plugin is built as static.");
+    #else
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("imageThreads", data.threads);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, "image.gltf")));
+    CORRADE_COMPARE(importer->image2DCount(), 2);
+
+    /* Repeated IDs should get a separate importer each */
+    const UnsignedInt ids[]{1, 0, 1, 1, 0};
+    Containers::Array<Containers::Optional<ImageData2D>> images = static_cast<TinyGltfImporter&>(*importer).image2DBatch(ids);
+    CORRADE_COMPARE(images.size(), Containers::arraySize(ids));
+    for(const Containers::Optional<ImageData2D>& image: images) {
+        CORRADE_VERIFY(image);
+        CORRADE_VERIFY(image->importerState());
+        CORRADE_COMPARE(image->size(), Vector2i(5, 3));
+        CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+        CORRADE_COMPARE_AS(image->data(), Containers::arrayView(ExpectedImageData).prefix(60), TestSuite::Compare::Container);
+    }
+
+    /* The batch import shouldn't affect the regular one */
+    Containers::Optional<ImageData2D> image = importer->image2D(1);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(5, 3));
+    #endif
+}
+
+void TinyGltfImporterTest::imageImporterCache() {
+    auto&& data = ImageImporterCacheData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("imageImporterCacheSize", data.cacheSize);
+
+    struct State {
+        Containers::Array<char> image;
+        std::size_t loadCount{};
+    } state;
+    state.image = Utility::Directory::read(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, "texture.png"));
+    importer->setFileCallback([](const std::string& filename, InputFileCallbackPolicy policy, State& state)
+            -> Containers::Optional<Containers::ArrayView<const char>>
+        {
+            if(policy == InputFileCallbackPolicy::Close) return {};
+            CORRADE_INTERNAL_ASSERT(filename == "texture.png");
+            ++state.loadCount;
+            return Containers::optional(Containers::ArrayView<const char>{state.image});
+        }, state);
+
+    /* Open as data so the callback gets called only for the images */
+    CORRADE_VERIFY(importer->openData(Utility::Directory::read(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, "image.gltf"))));
+    CORRADE_COMPARE(importer->image2DCount(), 2);
+
+    /* Alternate between the two images, each switch reopens the file unless
+       both importers fit into the cache */
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 1);
+    CORRADE_VERIFY(importer->image2D(1));
+    CORRADE_VERIFY(importer->image2D(0));
+    CORRADE_COMPARE(importer->image2DLevelCount(1), 1);
+    CORRADE_VERIFY(importer->image2D(1));
+    CORRADE_COMPARE(state.loadCount, data.expectedLoadCount);
+}
+
 void TinyGltfImporterTest::fileCallbackBuffer() {
     auto&& data = SingleFileData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -2973,6 +3889,270 @@ void TinyGltfImporterTest::utf8filenames() {
     CORRADE_COMPARE_AS(image->data(), Containers::arrayView(ExpectedImageData).prefix(60), TestSuite::Compare::Container);
 }
 
+void TinyGltfImporterTest::fastJsonParser() {
+    auto&& data = FastJsonParserData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const std::string filename = Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, data.filename);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(filename));
+
+    Containers::Pointer<AbstractImporter> fastImporter = _manager.instantiate("TinyGltfImporter");
+    fastImporter->configuration().setValue("fastJsonParser", true);
+    CORRADE_VERIFY(fastImporter->openFile(filename));
+
+    CORRADE_COMPARE(importEverything(*fastImporter), importEverything(*importer));
+}
+
+void TinyGltfImporterTest::fastJsonParserError() {
+    auto&& data = FastJsonParserErrorData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("fastJsonParser", true);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    if(data.filename)
+        CORRADE_VERIFY(!importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, data.filename)));
+    else
+        CORRADE_VERIFY(!importer->openData(data.data));
+    CORRADE_COMPARE(out.str(), "Trade::TinyGltfImporter::openData(): error opening file: " + std::string{data.message} + "\n");
+}
+
+void TinyGltfImporterTest::benchmarkOpen() {
+    auto&& data = JsonParserData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const std::string file = manyMeshesGlb(BenchmarkMeshCount);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("fastJsonParser", data.fastJsonParser);
+
+    CORRADE_BENCHMARK(1)
+        CORRADE_VERIFY(importer->openData({file.data(), file.size()}));
+
+    CORRADE_COMPARE(importer->object3DCount(), BenchmarkMeshCount);
+    CORRADE_COMPARE(importer->meshCount(), BenchmarkMeshCount);
+}
+
+void TinyGltfImporterTest::benchmarkOpenMemory() {
+    auto&& data = JsonParserData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #if defined(CORRADE_TARGET_WINDOWS) && defined(TINYGLTFIMPORTER_PLUGIN_FILENAME)
+    CORRADE_SKIP("Allocations in a dynamic plugin DLL don't go through the operator new replaced in the test executable.");
+    #endif
+
+    const std::string file = manyMeshesGlb(BenchmarkMeshCount);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("fastJsonParser", data.fastJsonParser);
+
+    /* Closing the file inside the benchmark so the next iteration starts
+       with nothing allocated by the importer */
+    std::size_t meshCount = 0;
+    CORRADE_BENCHMARK(1) {
+        CORRADE_VERIFY(importer->openData({file.data(), file.size()}));
+        meshCount += importer->meshCount();
+        importer->close();
+    }
+
+    CORRADE_COMPARE(meshCount, BenchmarkMeshCount);
+}
+
+void TinyGltfImporterTest::benchmarkOpenNameLookup() {
+    auto&& data = NameLookupData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const std::string file = manyNodesGltf(BenchmarkNodeCount);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("buildNameLookupOnOpen", data.buildNameLookupOnOpen);
+
+    CORRADE_BENCHMARK(1)
+        CORRADE_VERIFY(importer->openData({file.data(), file.size()}));
+
+    CORRADE_COMPARE(importer->object3DCount(), BenchmarkNodeCount);
+}
+
+void TinyGltfImporterTest::benchmarkHierarchy() {
+    auto&& data = HierarchyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifdef TINYGLTFIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific API can be tested only if the plugin is built as static.");
+    #else
+    const std::string file = manyMeshesGlb(BenchmarkMeshCount);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openData({file.data(), file.size()}));
+
+    std::size_t meshCount = 0;
+    if(data.flat) {
+        CORRADE_BENCHMARK(1) {
+            TinyGltfImporter::FlatHierarchy hierarchy = static_cast<TinyGltfImporter&>(*importer).flatHierarchy();
+            for(const Int mesh: hierarchy.meshes)
+                if(mesh != -1) ++meshCount;
+        }
+    } else {
+        CORRADE_BENCHMARK(1) {
+            for(UnsignedInt i = 0; i != importer->object3DCount(); ++i)
+                if(importer->object3D(i)->instanceType() == ObjectInstanceType3D::Mesh) ++meshCount;
+        }
+    }
+
+    CORRADE_COMPARE(meshCount, BenchmarkMeshCount);
+    #endif
+}
+
+void TinyGltfImporterTest::benchmarkNameLookup() {
+    const std::string file = manyNodesGltf(BenchmarkNodeCount);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("buildNameLookupOnOpen", true);
+    CORRADE_VERIFY(importer->openData({file.data(), file.size()}));
+
+    std::vector<std::string> names;
+    names.reserve(BenchmarkNodeCount);
+    for(std::size_t i = 0; i != BenchmarkNodeCount; ++i)
+        names.push_back("node" + std::to_string(BenchmarkNodeCount - i - 1));
+
+    std::size_t sum = 0;
+    CORRADE_BENCHMARK(1)
+        for(const std::string& name: names)
+            sum += importer->object3DForName(name);
+
+    CORRADE_COMPARE(sum, BenchmarkNodeCount*(BenchmarkNodeCount - 1)/2);
+}
+
+void TinyGltfImporterTest::benchmarkAnimation() {
+    const std::string file = manyChannelsGlb(BenchmarkChannelCount, BenchmarkKeyCount);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openData({file.data(), file.size()}));
+    CORRADE_COMPARE(importer->animationCount(), 1);
+
+    Containers::Optional<AnimationData> animation;
+    CORRADE_BENCHMARK(1)
+        animation = importer->animation(0);
+
+    CORRADE_VERIFY(animation);
+    CORRADE_COMPARE(animation->trackCount(), BenchmarkChannelCount);
+    /* All time tracks have the same contents, so only one is stored */
+    CORRADE_COMPARE(animation->data().size(),
+        BenchmarkKeyCount*sizeof(Float) +
+        BenchmarkChannelCount/2*BenchmarkKeyCount*(sizeof(Quaternion) + sizeof(Vector3)));
+}
+
+void TinyGltfImporterTest::benchmarkAnimationQuaternionPostprocessing() {
+    auto&& data = QuaternionPostprocessingData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const std::string file = rotationChannelsGlb(BenchmarkRotationKeyCount);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("optimizeQuaternionShortestPath", data.optimizeQuaternionShortestPath);
+    importer->configuration().setValue("normalizeQuaternions", data.normalizeQuaternions);
+    CORRADE_VERIFY(importer->openData({file.data(), file.size()}));
+
+    Containers::Optional<AnimationData> animation;
+    {
+        /* Silence the renormalization warning */
+        Warning redirectWarning{nullptr};
+        CORRADE_BENCHMARK(1)
+            animation = importer->animation(0);
+    }
+
+    CORRADE_VERIFY(animation);
+    CORRADE_COMPARE(animation->trackCount(), 2);
+
+    /* Verify that the postprocessing did what it should */
+    Animation::TrackView<const Float, const Quaternion> track = animation->track<Quaternion>(0);
+    for(std::size_t i = 0; i != track.size(); ++i) {
+        if(data.normalizeQuaternions)
+            CORRADE_VERIFY(track.values()[i].isNormalized());
+        if(data.optimizeQuaternionShortestPath && i)
+            CORRADE_VERIFY(Math::dot(track.values()[i - 1], track.values()[i]) >= 0.0f);
+    }
+
+    Animation::TrackView<const Float, const CubicHermiteQuaternion> spline = animation->track<CubicHermiteQuaternion>(1);
+    CORRADE_COMPARE(spline.values()[1].inTangent(), spline.values()[1].point()*0.5f*0.1f);
+    CORRADE_COMPARE(spline.values()[1].outTangent(), spline.values()[1].point()*0.5f*0.1f);
+}
+
+void TinyGltfImporterTest::benchmarkMeshTextureCoordinateYFlip() {
+    auto&& data = TextureCoordinateYFlipData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const std::string file = textureCoordinatesGlb(BenchmarkVertexCount, data.interleaved);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("textureCoordinateYFlipInMaterial", data.textureCoordinateYFlipInMaterial);
+    CORRADE_VERIFY(importer->openData({file.data(), file.size()}));
+
+    Containers::Optional<MeshData> mesh;
+    CORRADE_BENCHMARK(1)
+        mesh = importer->mesh(0);
+
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexCount(), BenchmarkVertexCount);
+    CORRADE_COMPARE(mesh->attributeCount(MeshAttribute::TextureCoordinates), 2);
+
+    /* Verify that the flip was done (or not done) for both sets */
+    const Containers::StridedArrayView1D<const Vector2> first = mesh->attribute<Vector2>(MeshAttribute::TextureCoordinates, 0);
+    const Containers::StridedArrayView1D<const Vector2> second = mesh->attribute<Vector2>(MeshAttribute::TextureCoordinates, 1);
+    for(const std::size_t i: {std::size_t{0}, std::size_t{5}, BenchmarkVertexCount - 1}) {
+        const Float y0 = i*0.25f, y1 = i*0.0625f;
+        CORRADE_COMPARE(first[i], (Vector2{i*0.5f, data.textureCoordinateYFlipInMaterial ? y0 : 1.0f - y0}));
+        CORRADE_COMPARE(second[i], (Vector2{i*0.125f, data.textureCoordinateYFlipInMaterial ? y1 : 1.0f - y1}));
+    }
+}
+
+void TinyGltfImporterTest::benchmarkMemoryBegin() {
+    peakAllocatedBytes = std::size_t(allocatedBytes);
+    _memoryBenchmarkBase = allocatedBytes;
+}
+
+std::uint64_t TinyGltfImporterTest::benchmarkMemoryEnd() {
+    return peakAllocatedBytes - _memoryBenchmarkBase;
+}
+
 }}}}
 
+void* operator new(const std::size_t size) {
+    if(void* const pointer = Magnum::Trade::Test::allocate(size))
+        return pointer;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](const std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept {
+    return Magnum::Trade::Test::allocate(size);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept {
+    return Magnum::Trade::Test::allocate(size);
+}
+
+void operator delete(void* const pointer) noexcept {
+    Magnum::Trade::Test::deallocate(pointer);
+}
+
+void operator delete[](void* const pointer) noexcept {
+    Magnum::Trade::Test::deallocate(pointer);
+}
+
+void operator delete(void* const pointer, const std::nothrow_t&) noexcept {
+    Magnum::Trade::Test::deallocate(pointer);
+}
+
+void operator delete[](void* const pointer, const std::nothrow_t&) noexcept {
+    Magnum::Trade::Test::deallocate(pointer);
+}
+
 CORRADE_TEST_MAIN(Magnum::Trade::Test::TinyGltfImporterTest)
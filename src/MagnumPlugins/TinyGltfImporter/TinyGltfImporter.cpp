@@ -26,9 +26,12 @@
 */
 
 #include "TinyGltfImporter.h"
+#include "FlatHierarchy.h"
 
 #include <algorithm>
+#include <cstring>
 #include <limits>
+#include <tuple>
 #include <unordered_map>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/ArrayView.h>
@@ -44,7 +47,9 @@
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/CubicHermite.h>
 #include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Packing.h>
 #include <Magnum/Math/Quaternion.h>
+#include <Magnum/Math/TypeTraits.h>
 #include <Magnum/Trade/AnimationData.h>
 #include <Magnum/Trade/CameraData.h>
 #include <Magnum/Trade/LightData.h>
@@ -56,6 +61,12 @@
 #include <Magnum/Trade/MeshObjectData3D.h>
 
 #include "MagnumPlugins/AnyImageImporter/AnyImageImporter.h"
+#include "MagnumPlugins/Implementation/parallelFor.h"
+#include "MagnumPlugins/TinyGltfImporter/loadGltfModel.h"
+
+#ifdef CORRADE_TARGET_SSE2
+#include <emmintrin.h>
+#endif
 
 #define TINYGLTF_IMPLEMENTATION
 /* Opt out of tinygltf stb_image dependency */
@@ -162,6 +173,83 @@ Containers::StridedArrayView2D<const char> bufferView(const tinygltf::Model& mod
         {std::ptrdiff_t(stride), 1}};
 }
 
+/* Kinds of named objects. The name lookup table is shared by all of them, so
+   the kind is a part of the key. */
+enum class NameKind: UnsignedByte {
+    Animation,
+    Camera,
+    Light,
+    Scene,
+    Node,
+    Mesh,
+    Material,
+    Image,
+    Texture
+};
+
+/* Flat open-addressing hash table with linear probing, mapping (kind, name)
+   pairs to IDs. The names are not copied, the entries point to strings owned
+   by the tinygltf::Model, which lives for as long as the table does. The load
+   factor is kept at or below 0.5, so there's always at least one empty slot
+   and the probing always terminates. */
+class NameLookup {
+    public:
+        explicit NameLookup(std::size_t count) {
+            std::size_t capacity = 2;
+            while(capacity < count*2) capacity <<= 1;
+            _entries = Containers::Array<Entry>{Containers::ValueInit, capacity};
+        }
+
+        /* If a name of the same kind is already present, the original entry
+           is kept, consistently with std::unordered_map::emplace() */
+        void insert(const NameKind kind, const std::string& name, const Int id) {
+            const UnsignedInt hash = hashName(kind, name);
+            const std::size_t mask = _entries.size() - 1;
+            for(std::size_t i = hash & mask; ; i = (i + 1) & mask) {
+                Entry& entry = _entries[i];
+                if(!entry.name) {
+                    entry.name = &name;
+                    entry.hash = hash;
+                    entry.kind = kind;
+                    entry.id = id;
+                    return;
+                }
+
+                if(entry.hash == hash && entry.kind == kind && *entry.name == name)
+                    return;
+            }
+        }
+
+        Int find(const NameKind kind, const std::string& name) const {
+            const UnsignedInt hash = hashName(kind, name);
+            const std::size_t mask = _entries.size() - 1;
+            for(std::size_t i = hash & mask; ; i = (i + 1) & mask) {
+                const Entry& entry = _entries[i];
+                if(!entry.name) return -1;
+                if(entry.hash == hash && entry.kind == kind && *entry.name == name)
+                    return entry.id;
+            }
+        }
+
+    private:
+        struct Entry {
+            /* Null for an empty slot */
+            const std::string* name;
+            UnsignedInt hash;
+            NameKind kind;
+            Int id;
+        };
+
+        /* 32-bit FNV-1a, with the kind mixed into the initial state */
+        static UnsignedInt hashName(const NameKind kind, const std::string& name) {
+            UnsignedInt hash = (2166136261u ^ UnsignedInt(kind))*16777619u;
+            for(const char c: name) hash = (hash ^ UnsignedByte(c))*16777619u;
+            return hash;
+        }
+
+        Containers::Array<Entry> _entries;
+};
+
 }
 
 struct TinyGltfImporter::Document {
@@ -169,16 +257,13 @@ struct TinyGltfImporter::Document {
 
     tinygltf::Model model;
 
-    Containers::Optional<std::unordered_map<std::string, Int>>
-        animationsForName,
-        camerasForName,
-        lightsForName,
-        scenesForName,
-        nodesForName,
-        meshesForName,
-        materialsForName,
-        imagesForName,
-        texturesForName;
+    /* Lookup table for all *ForName() queries. Built in a single pass over
+       all named objects either on first use or, if buildNameLookupOnOpen is
+       enabled, already during openData(). */
+    Containers::Optional<NameLookup> nameLookup;
+
+    void buildNameLookup();
+    Int forName(NameKind kind, const std::string& name);
 
     /* Unlike the ones above, these are filled already during construction as
        we need them in three different places and on-demand construction would
@@ -216,10 +301,59 @@ struct TinyGltfImporter::Document {
 
     bool open = false;
 
-    UnsignedInt imageImporterId = ~UnsignedInt{};
-    Containers::Optional<AnyImageImporter> imageImporter;
+    /* Recently used image importers, allocated on first use with the size
+       given by the imageImporterCacheSize option. Entries that were never
+       used have lastUsed set to 0, so they get picked first. */
+    struct ImageImporter {
+        UnsignedInt id = ~UnsignedInt{};
+        std::size_t lastUsed = 0;
+        Containers::Optional<AnyImageImporter> importer;
+    };
+    Containers::Array<ImageImporter> imageImporters;
+    std::size_t imageImporterUseCounter = 0;
 };
 
+void TinyGltfImporter::Document::buildNameLookup() {
+    nameLookup.emplace(
+        model.animations.size() +
+        model.cameras.size() +
+        model.lights.size() +
+        model.scenes.size() +
+        model.nodes.size() +
+        model.meshes.size() +
+        model.materials.size() +
+        model.images.size() +
+        model.textures.size());
+
+    for(std::size_t i = 0; i != model.animations.size(); ++i)
+        nameLookup->insert(NameKind::Animation, model.animations[i].name, i);
+    for(std::size_t i = 0; i != model.cameras.size(); ++i)
+        nameLookup->insert(NameKind::Camera, model.cameras[i].name, i);
+    for(std::size_t i = 0; i != model.lights.size(); ++i)
+        nameLookup->insert(NameKind::Light, model.lights[i].name, i);
+    for(std::size_t i = 0; i != model.scenes.size(); ++i)
+        nameLookup->insert(NameKind::Scene, model.scenes[i].name, i);
+    /* A mesh node can be duplicated for as many primitives as the mesh has,
+       point to the first node in the duplicate sequence */
+    for(std::size_t i = 0; i != model.nodes.size(); ++i)
+        nameLookup->insert(NameKind::Node, model.nodes[i].name, nodeSizeOffsets[i]);
+    /* The mesh can be duplicated for as many primitives as it has, point to
+       the first mesh in the duplicate sequence */
+    for(std::size_t i = 0; i != model.meshes.size(); ++i)
+        nameLookup->insert(NameKind::Mesh, model.meshes[i].name, meshSizeOffsets[i]);
+    for(std::size_t i = 0; i != model.materials.size(); ++i)
+        nameLookup->insert(NameKind::Material, model.materials[i].name, i);
+    for(std::size_t i = 0; i != model.images.size(); ++i)
+        nameLookup->insert(NameKind::Image, model.images[i].name, i);
+    for(std::size_t i = 0; i != model.textures.size(); ++i)
+        nameLookup->insert(NameKind::Texture, model.textures[i].name, i);
+}
+
+Int TinyGltfImporter::Document::forName(const NameKind kind, const std::string& name) {
+    if(!nameLookup) buildNameLookup();
+    return nameLookup->find(kind, name);
+}
+
 namespace {
 
 void fillDefaultConfiguration(Utility::ConfigurationGroup& conf) {
@@ -229,6 +363,12 @@ void fillDefaultConfiguration(Utility::ConfigurationGroup& conf) {
     conf.setValue("mergeAnimationClips", false);
     conf.setValue("textureCoordinateYFlipInMaterial", false);
     conf.setValue("objectIdAttribute", "_OBJECT_ID");
+    conf.setValue("dequantizeAttributes", false);
+    conf.setValue("buildNameLookupOnOpen", false);
+    conf.setValue("imageThreads", 1);
+    conf.setValue("imageImporterCacheSize", 1);
+    conf.setValue("preferKhrTextureBasisu", false);
+    conf.setValue("fastJsonParser", false);
 }
 
 }
@@ -311,7 +451,9 @@ void TinyGltfImporter::doOpenData(const Containers::ArrayView<const char> data)
     loader.SetImageLoader(&loadImageData, nullptr);
 
     _d->open = true;
-    if(data.size() >= 4 && strncmp(data.data(), "glTF", 4) == 0) {
+    if(configuration().value<bool>("fastJsonParser")) {
+        _d->open = Implementation::loadGltfModel(_d->model, err, data, callbacks);
+    } else if(data.size() >= 4 && strncmp(data.data(), "glTF", 4) == 0) {
         _d->open = loader.LoadBinaryFromMemory(&_d->model, &err, nullptr, reinterpret_cast<const unsigned char*>(data.data()), data.size(), "", tinygltf::SectionCheck::NO_REQUIRE);
     } else {
         _d->open = loader.LoadASCIIFromString(&_d->model, &err, nullptr, data.data(), data.size(), "", tinygltf::SectionCheck::NO_REQUIRE);
@@ -326,6 +468,8 @@ void TinyGltfImporter::doOpenData(const Containers::ArrayView<const char> data)
 
     /* Treat meshes with multiple primitives as separate meshes. Each mesh gets
        duplicated as many times as is the size of the primitives array. */
+    _d->meshSizeOffsets.reserve(_d->model.meshes.size() + 1);
+    _d->meshMap.reserve(_d->model.meshes.size());
     _d->meshSizeOffsets.emplace_back(0);
     for(std::size_t i = 0; i != _d->model.meshes.size(); ++i) {
         CORRADE_INTERNAL_ASSERT(!_d->model.meshes[i].primitives.empty());
@@ -337,6 +481,8 @@ void TinyGltfImporter::doOpenData(const Containers::ArrayView<const char> data)
 
     /* In order to support multi-primitive meshes, we need to duplicate the
        nodes as well */
+    _d->nodeSizeOffsets.reserve(_d->model.nodes.size() + 1);
+    _d->nodeMap.reserve(_d->model.nodes.size());
     _d->nodeSizeOffsets.emplace_back(0);
     for(std::size_t i = 0; i != _d->model.nodes.size(); ++i) {
         _d->nodeMap.emplace_back(i, 0);
@@ -394,7 +540,10 @@ void TinyGltfImporter::doOpenData(const Containers::ArrayView<const char> data)
         }
     }
 
-    /* Name maps are lazy-loaded because these might not be needed every time */
+    /* The name lookup is by default built lazily because it might not be
+       needed every time */
+    if(configuration().value<bool>("buildNameLookupOnOpen"))
+        _d->buildNameLookup();
 }
 
 UnsignedInt TinyGltfImporter::doCameraCount() const {
@@ -402,15 +551,7 @@ UnsignedInt TinyGltfImporter::doCameraCount() const {
 }
 
 Int TinyGltfImporter::doCameraForName(const std::string& name) {
-    if(!_d->camerasForName) {
-        _d->camerasForName.emplace();
-        _d->camerasForName->reserve(_d->model.cameras.size());
-        for(std::size_t i = 0; i != _d->model.cameras.size(); ++i)
-            _d->camerasForName->emplace(_d->model.cameras[i].name, i);
-    }
-
-    const auto found = _d->camerasForName->find(name);
-    return found == _d->camerasForName->end() ? -1 : found->second;
+    return _d->forName(NameKind::Camera, name);
 }
 
 std::string TinyGltfImporter::doCameraName(const UnsignedInt id) {
@@ -429,15 +570,7 @@ Int TinyGltfImporter::doAnimationForName(const std::string& name) {
     /* If the animations are merged, don't report any names */
     if(configuration().value<bool>("mergeAnimationClips")) return -1;
 
-    if(!_d->animationsForName) {
-        _d->animationsForName.emplace();
-        _d->animationsForName->reserve(_d->model.animations.size());
-        for(std::size_t i = 0; i != _d->model.animations.size(); ++i)
-            _d->animationsForName->emplace(_d->model.animations[i].name, i);
-    }
-
-    const auto found = _d->animationsForName->find(name);
-    return found == _d->animationsForName->end() ? -1 : found->second;
+    return _d->forName(NameKind::Animation, name);
 }
 
 std::string TinyGltfImporter::doAnimationName(UnsignedInt id) {
@@ -448,22 +581,158 @@ std::string TinyGltfImporter::doAnimationName(UnsignedInt id) {
 
 namespace {
 
-template<class V> void postprocessSplineTrack(const std::size_t timeTrackUsed, const Containers::ArrayView<const Float> keys, const Containers::ArrayView<Math::CubicHermite<V>> values) {
+/* Convert the `a` values to `n` and the `b` values to `m` as described in
+   https://github.com/KhronosGroup/glTF/tree/master/specification/2.0#appendix-c-spline-interpolation
+   Unfortunately I was not able to find any concrete name for this, so it's
+   not part of the CubicHermite implementation but is kept here locally. */
+template<class V> void scaleSplineTangents(const Containers::ArrayView<const Float> keys, const Containers::ArrayView<Math::CubicHermite<V>> values, const std::size_t begin) {
+    for(std::size_t i = begin; i < keys.size() - 1; ++i) {
+        const Float timeDifference = keys[i + 1] - keys[i];
+        values[i].outTangent() *= timeDifference;
+        values[i + 1].inTangent() *= timeDifference;
+    }
+}
+
+template<class V> void scaleSplineTangents(const Containers::ArrayView<const Float> keys, const Containers::ArrayView<Math::CubicHermite<V>> values) {
+    scaleSplineTangents(keys, values, 0);
+}
+
+#ifdef CORRADE_TARGET_SSE2
+/* Quaternion tangents are four floats each, so the scaling is done for four
+   keys at a time with a single multiplication per tangent. The results are
+   the same as with the scalar variant. */
+void scaleSplineTangents(const Containers::ArrayView<const Float> keys, const Containers::ArrayView<CubicHermiteQuaternion> values) {
+    /* In tangent, point and out tangent, four floats each */
+    static_assert(sizeof(CubicHermiteQuaternion) == 12*sizeof(Float), "unexpected CubicHermiteQuaternion layout");
+    Float* const data = reinterpret_cast<Float*>(values.data());
+
+    std::size_t i = 0;
+    for(; i + 4 < keys.size(); i += 4) {
+        const __m128 timeDifference = _mm_sub_ps(_mm_loadu_ps(keys.data() + i + 1), _mm_loadu_ps(keys.data() + i));
+        const __m128 timeDifferences[]{
+            _mm_shuffle_ps(timeDifference, timeDifference, _MM_SHUFFLE(0, 0, 0, 0)),
+            _mm_shuffle_ps(timeDifference, timeDifference, _MM_SHUFFLE(1, 1, 1, 1)),
+            _mm_shuffle_ps(timeDifference, timeDifference, _MM_SHUFFLE(2, 2, 2, 2)),
+            _mm_shuffle_ps(timeDifference, timeDifference, _MM_SHUFFLE(3, 3, 3, 3))
+        };
+        for(std::size_t j = 0; j != 4; ++j) {
+            Float* const outTangent = data + 12*(i + j) + 8;
+            Float* const nextInTangent = data + 12*(i + j + 1);
+            _mm_storeu_ps(outTangent, _mm_mul_ps(_mm_loadu_ps(outTangent), timeDifferences[j]));
+            _mm_storeu_ps(nextInTangent, _mm_mul_ps(_mm_loadu_ps(nextInTangent), timeDifferences[j]));
+        }
+    }
+
+    scaleSplineTangents<Quaternion>(keys, values, i);
+}
+#endif
+
+template<class V> void postprocessSplineTrack(const UnsignedInt timeTrackUsed, const Containers::ArrayView<const Float> keys, const Containers::ArrayView<Math::CubicHermite<V>> values) {
     /* Already processed, don't do that again */
-    if(timeTrackUsed != ~std::size_t{}) return;
+    if(timeTrackUsed != ~UnsignedInt{}) return;
 
     CORRADE_INTERNAL_ASSERT(keys.size() == values.size());
     if(keys.size() < 2) return;
 
-    /* Convert the `a` values to `n` and the `b` values to `m` as described in
-       https://github.com/KhronosGroup/glTF/tree/master/specification/2.0#appendix-c-spline-interpolation
-       Unfortunately I was not able to find any concrete name for this, so it's
-       not part of the CubicHermite implementation but is kept here locally. */
-    for(std::size_t i = 0; i < keys.size() - 1; ++i) {
-        const Float timeDifference = keys[i + 1] - keys[i];
-        values[i].outTangent() *= timeDifference;
-        values[i + 1].inTangent() *= timeDifference;
+    scaleSplineTangents(keys, values);
+}
+
+/* Ensures shortest path is always chosen between consecutive quaternions */
+void optimizeQuaternionShortestPath(const Containers::ArrayView<Quaternion> values) {
+    if(values.size() < 2) return;
+
+    Float flip = 1.0f;
+    std::size_t i = 0;
+
+    #ifdef CORRADE_TARGET_SSE2
+    /* The sign of a dot product doesn't change when both quaternions are
+       negated (and the value is bit-exact, as negation is), so the dot
+       products can be calculated on the original values four pairs at a time
+       and the flips then applied as a running product of their signs. The
+       per-component products are transposed and summed in the same order as
+       Math::dot() does, to get the exact same results as the scalar
+       variant. */
+    static_assert(sizeof(Quaternion) == 4*sizeof(Float), "unexpected Quaternion layout");
+    Float* const data = reinterpret_cast<Float*>(values.data());
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 previous = _mm_loadu_ps(data);
+    for(; i + 4 < values.size(); i += 4) {
+        const __m128 next[]{
+            _mm_loadu_ps(data + 4*(i + 1)),
+            _mm_loadu_ps(data + 4*(i + 2)),
+            _mm_loadu_ps(data + 4*(i + 3)),
+            _mm_loadu_ps(data + 4*(i + 4))
+        };
+        __m128 x = _mm_mul_ps(previous, next[0]);
+        __m128 y = _mm_mul_ps(next[0], next[1]);
+        __m128 z = _mm_mul_ps(next[1], next[2]);
+        __m128 w = _mm_mul_ps(next[2], next[3]);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_add_ps(x, y), z), w);
+        const int negative = _mm_movemask_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()));
+
+        /* Remember the original value for the next round before it gets
+           flipped */
+        previous = next[3];
+        for(std::size_t j = 0; j != 4; ++j) {
+            if(negative & (1 << j)) flip = -flip;
+            if(flip < 0.0f)
+                _mm_storeu_ps(data + 4*(i + j + 1), _mm_xor_ps(next[j], signMask));
+        }
+    }
+    #endif
+
+    for(; i != values.size() - 1; ++i) {
+        if(Math::dot(values[i], values[i + 1]*flip) < 0) flip = -flip;
+        values[i + 1] *= flip;
+    }
+}
+
+/* Normalizes quaternions that aren't already, returns true if any had to be
+   normalized. Not normalizing every time to avoid tiny differences. */
+bool normalizeQuaternions(const Containers::ArrayView<Quaternion> values) {
+    bool hadToRenormalize = false;
+    std::size_t i = 0;
+
+    #ifdef CORRADE_TARGET_SSE2
+    /* Four quaternions at a time, with the length calculated and compared the
+       same way as Quaternion::isNormalized() and Quaternion::normalized()
+       does. The negated comparison is true for NaNs, same as in the scalar
+       variant. */
+    Float* const data = reinterpret_cast<Float*>(values.data());
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 epsilon = _mm_set1_ps(2.0f*Math::TypeTraits<Float>::epsilon());
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    for(; i + 4 <= values.size(); i += 4) {
+        const __m128 q[]{
+            _mm_loadu_ps(data + 4*i),
+            _mm_loadu_ps(data + 4*(i + 1)),
+            _mm_loadu_ps(data + 4*(i + 2)),
+            _mm_loadu_ps(data + 4*(i + 3))
+        };
+        __m128 x = _mm_mul_ps(q[0], q[0]);
+        __m128 y = _mm_mul_ps(q[1], q[1]);
+        __m128 z = _mm_mul_ps(q[2], q[2]);
+        __m128 w = _mm_mul_ps(q[3], q[3]);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_add_ps(x, y), z), w);
+        const int denormalized = _mm_movemask_ps(_mm_cmpnlt_ps(_mm_and_ps(_mm_sub_ps(dot, one), absMask), epsilon));
+        if(!denormalized) continue;
+
+        hadToRenormalize = true;
+        Float lengths[4];
+        _mm_storeu_ps(lengths, _mm_sqrt_ps(dot));
+        for(std::size_t j = 0; j != 4; ++j) if(denormalized & (1 << j))
+            _mm_storeu_ps(data + 4*(i + j), _mm_div_ps(q[j], _mm_set1_ps(lengths[j])));
+    }
+    #endif
+
+    for(; i != values.size(); ++i) if(!values[i].isNormalized()) {
+        values[i] = values[i].normalized();
+        hadToRenormalize = true;
     }
+
+    return hadToRenormalize;
 }
 
 }
@@ -480,15 +749,30 @@ Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(UnsignedInt id
     const std::size_t animationEnd =
         configuration().value<bool>("mergeAnimationClips") ? _d->model.animations.size() : id + 1;
 
-    /* First gather the input and output data ranges. Key is unique accessor ID
-       so we don't duplicate shared data, value is range in the input buffer,
-       offset in the output data and ID of the corresponding key track in case
-       given track is a spline interpolation. The key ID is initialized to ~0
-       and will be used later to check that a spline track was not used with
-       more than one time track, as it needs to be postprocessed for given time
-       track. */
-    std::unordered_map<int, std::tuple<Containers::StridedArrayView2D<const char>, std::size_t, std::size_t>> samplerData;
-    std::size_t dataSize = 0;
+    /* First pass, gather the input and output data ranges. Every accessor
+       gets an entry only once so we don't duplicate shared data, the mapping
+       from accessor ID to the entry is a flat array as there's usually about
+       as many animation accessors as there are accessors in total. */
+    struct SamplerData {
+        Containers::StridedArrayView2D<const char> view;
+        /* Offset in the output data */
+        std::size_t outputOffset;
+        /* ID of the entry holding data for this one. Same as the entry index
+           unless it's a time track with the same contents as some other time
+           track. */
+        UnsignedInt dataEntry;
+        /* ID of the time track entry used to postprocess a spline track. Is
+           initialized to ~0 and is used later to check that a spline track was
+           not used with more than one time track, as it needs to be
+           postprocessed for given time track. */
+        UnsignedInt timeTrackUsed;
+        /* Whether the accessor is used as a sampler output, which means the
+           data can be modified in place and thus can't be shared based on
+           contents */
+        bool output;
+    };
+    Containers::Array<UnsignedInt> samplerDataForAccessor{Containers::DirectInit, _d->model.accessors.size(), ~UnsignedInt{}};
+    Containers::Array<SamplerData> samplerData;
     for(std::size_t a = animationBegin; a != animationEnd; ++a) {
         const tinygltf::Animation& animation = _d->model.animations[a];
         for(std::size_t i = 0; i != animation.samplers.size(); ++i) {
@@ -503,38 +787,93 @@ Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(UnsignedInt id
             /** @todo handle alignment once we do more than just four-byte types */
 
             /* If the input view is not yet present in the output data buffer, add
-            it */
-            if(samplerData.find(sampler.input) == samplerData.end()) {
-                Containers::StridedArrayView2D<const char> view = bufferView(_d->model, *input);
-                samplerData.emplace(sampler.input, std::make_tuple(view, dataSize, ~std::size_t{}));
-                dataSize += view.size()[0]*view.size()[1];
+               it */
+            if(samplerDataForAccessor[sampler.input] == ~UnsignedInt{}) {
+                samplerDataForAccessor[sampler.input] = samplerData.size();
+                arrayAppend(samplerData, SamplerData{
+                    bufferView(_d->model, *input), 0,
+                    UnsignedInt(samplerData.size()), ~UnsignedInt{}, false});
             }
 
             /* If the output view is not yet present in the output data buffer, add
-            it */
-            if(samplerData.find(sampler.output) == samplerData.end()) {
-                Containers::StridedArrayView2D<const char> view = bufferView(_d->model, *output);
-                samplerData.emplace(sampler.output, std::make_tuple(view, dataSize, ~std::size_t{}));
-                dataSize += view.size()[0]*view.size()[1];
+               it */
+            if(samplerDataForAccessor[sampler.output] == ~UnsignedInt{}) {
+                samplerDataForAccessor[sampler.output] = samplerData.size();
+                arrayAppend(samplerData, SamplerData{
+                    bufferView(_d->model, *output), 0,
+                    UnsignedInt(samplerData.size()), ~UnsignedInt{}, true});
+            } else samplerData[samplerDataForAccessor[sampler.output]].output = true;
+        }
+    }
+
+    /* Some exporters write a separate time track for each sampler, even
+       though most of them have the same contents. Sort the time tracks
+       by size and their first and last value to find candidates for sharing
+       cheaply, and make all entries in a run of equal tracks refer to the
+       first one. */
+    {
+        Containers::Array<UnsignedInt> timeTracks;
+        for(std::size_t i = 0; i != samplerData.size(); ++i)
+            if(!samplerData[i].output) arrayAppend(timeTracks, UnsignedInt(i));
+
+        const auto key = [&samplerData](const UnsignedInt i) {
+            const Containers::StridedArrayView2D<const char>& view = samplerData[i].view;
+            UnsignedInt first{}, last{};
+            if(view.size()[0]) {
+                const std::size_t size = Math::min(view.size()[1], sizeof(UnsignedInt));
+                std::memcpy(&first, view[0].data(), size);
+                std::memcpy(&last, view[view.size()[0] - 1].data(), size);
+            }
+            return std::make_tuple(view.size()[0], view.size()[1], first, last);
+        };
+        std::sort(timeTracks.begin(), timeTracks.end(), [&key](UnsignedInt a, UnsignedInt b) {
+            return key(a) < key(b);
+        });
+
+        for(std::size_t i = 0; i != timeTracks.size(); ++i) {
+            SamplerData& current = samplerData[timeTracks[i]];
+            for(std::size_t j = i; j-- && key(timeTracks[j]) == key(timeTracks[i]); ) {
+                SamplerData& candidate = samplerData[timeTracks[j]];
+                /* Compare only with entries that hold data themselves */
+                if(candidate.dataEntry != timeTracks[j]) continue;
+
+                bool same = true;
+                for(std::size_t k = 0; k != current.view.size()[0] && same; ++k)
+                    same = std::memcmp(current.view[k].data(), candidate.view[k].data(), current.view.size()[1]) == 0;
+                if(same) {
+                    current.dataEntry = timeTracks[j];
+                    break;
+                }
             }
         }
     }
 
-    /* Populate the data array */
+    /* Calculate output offsets of all entries that hold data, the rest points
+       to data of the entries they're sharing with */
+    std::size_t dataSize = 0;
+    for(std::size_t i = 0; i != samplerData.size(); ++i) {
+        SamplerData& entry = samplerData[i];
+        if(entry.dataEntry != i) continue;
+        entry.outputOffset = dataSize;
+        dataSize += entry.view.size()[0]*entry.view.size()[1];
+    }
+    for(SamplerData& entry: samplerData)
+        entry.outputOffset = samplerData[entry.dataEntry].outputOffset;
+
+    /* Second pass, populate the data array */
     /**
      * @todo Once memory-mapped files are supported, this can all go away
      *      except when spline tracks are present -- in that case we need to
      *      postprocess them and can't just use the memory directly.
      */
-    Containers::Array<char> data{dataSize};
-    for(const std::pair<const int, std::tuple<Containers::StridedArrayView2D<const char>, std::size_t, std::size_t>>& view: samplerData) {
-        Containers::StridedArrayView2D<const char> src;
-        std::size_t outputOffset;
-        std::tie(src, outputOffset, std::ignore) = view.second;
-
-        Containers::StridedArrayView2D<char> dst{data.suffix(outputOffset),
-            src.size()};
-        Utility::copy(src, dst);
+    Containers::Array<char> data{Containers::NoInit, dataSize};
+    for(std::size_t i = 0; i != samplerData.size(); ++i) {
+        const SamplerData& entry = samplerData[i];
+        if(entry.dataEntry != i) continue;
+
+        Containers::StridedArrayView2D<char> dst{data.suffix(entry.outputOffset),
+            entry.view.size()};
+        Utility::copy(entry.view, dst);
     }
 
     /* Calculate total track count. If merging all animations together, this is
@@ -567,12 +906,10 @@ Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(UnsignedInt id
             }
 
             /* View on the key data */
-            const auto inputDataFound = samplerData.find(sampler.input);
-            CORRADE_INTERNAL_ASSERT(inputDataFound != samplerData.end());
+            const SamplerData& inputData = samplerData[samplerDataForAccessor[sampler.input]];
             const auto keys = Containers::arrayCast<Float>(
-                data.suffix(std::get<1>(inputDataFound->second)).prefix(
-                    std::get<0>(inputDataFound->second).size()[0]*
-                    std::get<0>(inputDataFound->second).size()[1]));
+                data.suffix(inputData.outputOffset).prefix(
+                    inputData.view.size()[0]*inputData.view.size()[1]));
 
             /* Interpolation mode */
             Animation::Interpolation interpolation;
@@ -593,12 +930,11 @@ Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(UnsignedInt id
             AnimationTrackTargetType target;
             AnimationTrackType type, resultType;
             Animation::TrackViewStorage<const Float> track;
-            const auto outputDataFound = samplerData.find(sampler.output);
-            CORRADE_INTERNAL_ASSERT(outputDataFound != samplerData.end());
-            const auto outputData = data.suffix(std::get<1>(outputDataFound->second))
-                .prefix(std::get<0>(outputDataFound->second).size()[0]*
-                        std::get<0>(outputDataFound->second).size()[1]);
-            std::size_t& timeTrackUsed = std::get<2>(outputDataFound->second);
+            SamplerData& outputSamplerData = samplerData[samplerDataForAccessor[sampler.output]];
+            const auto outputData = data.suffix(outputSamplerData.outputOffset)
+                .prefix(outputSamplerData.view.size()[0]*
+                        outputSamplerData.view.size()[1]);
+            UnsignedInt& timeTrackUsed = outputSamplerData.timeTrackUsed;
 
             /* Translation */
             if(channel.target_path == "translation") {
@@ -659,25 +995,16 @@ Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(UnsignedInt id
                        for spline interpolation, there it would cause war and
                        famine. */
                     const auto values = Containers::arrayCast<Quaternion>(outputData);
-                    if(configuration().value<bool>("optimizeQuaternionShortestPath")) {
-                        Float flip = 1.0f;
-                        for(std::size_t i = 0; i != values.size() - 1; ++i) {
-                            if(Math::dot(values[i], values[i + 1]*flip) < 0) flip = -flip;
-                            values[i + 1] *= flip;
-                        }
-                    }
+                    if(configuration().value<bool>("optimizeQuaternionShortestPath"))
+                        optimizeQuaternionShortestPath(values);
 
                     /* Normalize the quaternions if not already. Don't attempt
                        to normalize every time to avoid tiny differences, only
                        when the quaternion looks to be off. Again, not doing
                        this for splines as it would cause things to go
                        haywire. */
-                    if(configuration().value<bool>("normalizeQuaternions")) {
-                        for(auto& i: values) if(!i.isNormalized()) {
-                            i = i.normalized();
-                            hadToRenormalize = true;
-                        }
-                    }
+                    if(configuration().value<bool>("normalizeQuaternions") && normalizeQuaternions(values))
+                        hadToRenormalize = true;
 
                     type = AnimationTrackType::Quaternion;
                     track = Animation::TrackView<const Float, const Quaternion>{
@@ -727,9 +1054,9 @@ Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(UnsignedInt id
                Otherwise check that the spline track is always used with the
                same time track. */
             if(interpolation == Animation::Interpolation::Spline) {
-                if(timeTrackUsed == ~std::size_t{})
-                    timeTrackUsed = sampler.input;
-                else if(timeTrackUsed != std::size_t(sampler.input)) {
+                if(timeTrackUsed == ~UnsignedInt{})
+                    timeTrackUsed = inputData.dataEntry;
+                else if(timeTrackUsed != inputData.dataEntry) {
                     Error{} << "Trade::TinyGltfImporter::animation(): spline track is shared with different time tracks, we don't support that, sorry";
                     return Containers::NullOpt;
                 }
@@ -790,15 +1117,7 @@ UnsignedInt TinyGltfImporter::doLightCount() const {
 }
 
 Int TinyGltfImporter::doLightForName(const std::string& name) {
-    if(!_d->lightsForName) {
-        _d->lightsForName.emplace();
-        _d->lightsForName->reserve(_d->model.lights.size());
-        for(std::size_t i = 0; i != _d->model.lights.size(); ++i)
-            _d->lightsForName->emplace(_d->model.lights[i].name, i);
-    }
-
-    const auto found = _d->lightsForName->find(name);
-    return found == _d->lightsForName->end() ? -1 : found->second;
+    return _d->forName(NameKind::Light, name);
 }
 
 std::string TinyGltfImporter::doLightName(const UnsignedInt id) {
@@ -849,15 +1168,7 @@ Int TinyGltfImporter::doDefaultScene() {
 UnsignedInt TinyGltfImporter::doSceneCount() const { return _d->model.scenes.size(); }
 
 Int TinyGltfImporter::doSceneForName(const std::string& name) {
-    if(!_d->scenesForName) {
-        _d->scenesForName.emplace();
-        _d->scenesForName->reserve(_d->model.scenes.size());
-        for(std::size_t i = 0; i != _d->model.scenes.size(); ++i)
-            _d->scenesForName->emplace(_d->model.scenes[i].name, i);
-    }
-
-    const auto found = _d->scenesForName->find(name);
-    return found == _d->scenesForName->end() ? -1 : found->second;
+    return _d->forName(NameKind::Scene, name);
 }
 
 std::string TinyGltfImporter::doSceneName(const UnsignedInt id) {
@@ -882,18 +1193,7 @@ UnsignedInt TinyGltfImporter::doObject3DCount() const {
 }
 
 Int TinyGltfImporter::doObject3DForName(const std::string& name) {
-    if(!_d->nodesForName) {
-        _d->nodesForName.emplace();
-        _d->nodesForName->reserve(_d->model.nodes.size());
-        for(std::size_t i = 0; i != _d->model.nodes.size(); ++i) {
-            /* A mesh node can be duplicated for as many primitives as the mesh
-               has, point to the first node in the duplicate sequence */
-            _d->nodesForName->emplace(_d->model.nodes[i].name, _d->nodeSizeOffsets[i]);
-        }
-    }
-
-    const auto found = _d->nodesForName->find(name);
-    return found == _d->nodesForName->end() ? -1 : found->second;
+    return _d->forName(NameKind::Node, name);
 }
 
 std::string TinyGltfImporter::doObject3DName(UnsignedInt id) {
@@ -997,23 +1297,77 @@ Containers::Pointer<ObjectData3D> TinyGltfImporter::doObject3D(UnsignedInt id) {
         new ObjectData3D{std::move(children), transformation, instanceType, instanceId, &node});
 }
 
+TinyGltfImporter::FlatHierarchy TinyGltfImporter::flatHierarchy() {
+    CORRADE_ASSERT(isOpened(), "Trade::TinyGltfImporter::flatHierarchy(): no file opened", {});
+
+    const std::size_t count = _d->nodeMap.size();
+    const bool normalizeQuaternions = configuration().value<bool>("normalizeQuaternions");
+
+    FlatHierarchy out;
+    out.parents = Containers::Array<Int>{Containers::DirectInit, count, -1};
+    out.transformations = Containers::Array<Matrix4>{Containers::ValueInit, count};
+    out.meshes = Containers::Array<Int>{Containers::DirectInit, count, -1};
+    out.materials = Containers::Array<Int>{Containers::DirectInit, count, -1};
+    out.cameras = Containers::Array<Int>{Containers::DirectInit, count, -1};
+    out.lights = Containers::Array<Int>{Containers::DirectInit, count, -1};
+
+    for(std::size_t i = 0; i != _d->model.nodes.size(); ++i) {
+        const tinygltf::Node& node = _d->model.nodes[i];
+        const std::size_t id = _d->nodeSizeOffsets[i];
+
+        /* Same as in doObject3D(), except that TRS is always combined into a
+           matrix */
+        if(node.matrix.size() == 16) {
+            out.transformations[id] = Matrix4(Matrix4d::from(node.matrix.data()));
+        } else {
+            Vector3 translation;
+            Quaternion rotation;
+            Vector3 scaling{1.0f};
+            if(node.translation.size() == 3)
+                translation = Vector3{Vector3d::from(node.translation.data())};
+            if(node.rotation.size() == 4) {
+                rotation = Quaternion{Vector3{Vector3d::from(node.rotation.data())}, Float(node.rotation[3])};
+                if(!rotation.isNormalized() && normalizeQuaternions) {
+                    rotation = rotation.normalized();
+                    Warning{} << "Trade::TinyGltfImporter::flatHierarchy(): rotation quaternion was renormalized";
+                }
+            }
+            if(node.scale.size() == 3)
+                scaling = Vector3{Vector3d::from(node.scale.data())};
+            out.transformations[id] = Matrix4::from(rotation.toMatrix(), translation)*Matrix4::scaling(scaling);
+        }
+
+        /* Extra nodes added for multi-primitive meshes are children of the
+           node with identity transformation, each referencing one primitive */
+        if(node.mesh >= 0) {
+            const tinygltf::Mesh& mesh = _d->model.meshes[node.mesh];
+            for(std::size_t j = 0; j != mesh.primitives.size(); ++j) {
+                out.meshes[id + j] = Int(_d->meshSizeOffsets[node.mesh] + j);
+                out.materials[id + j] = mesh.primitives[j].material;
+                if(j) out.parents[id + j] = Int(id);
+            }
+        }
+
+        if(node.camera >= 0)
+            out.cameras[id] = node.camera;
+
+        const auto light = node.extensions.find("KHR_lights_punctual");
+        if(light != node.extensions.end())
+            out.lights[id] = light->second.Get("light").Get<int>();
+
+        for(const std::size_t child: node.children)
+            out.parents[_d->nodeSizeOffsets[child]] = Int(id);
+    }
+
+    return out;
+}
+
 UnsignedInt TinyGltfImporter::doMeshCount() const {
     return _d->meshMap.size();
 }
 
 Int TinyGltfImporter::doMeshForName(const std::string& name) {
-    if(!_d->meshesForName) {
-        _d->meshesForName.emplace();
-        _d->meshesForName->reserve(_d->model.meshes.size());
-        for(std::size_t i = 0; i != _d->model.meshes.size(); ++i) {
-            /* The mesh can be duplicated for as many primitives as it has,
-               point to the first mesh in the duplicate sequence */
-            _d->meshesForName->emplace(_d->model.meshes[i].name, _d->meshSizeOffsets[i]);
-        }
-    }
-
-    const auto found = _d->meshesForName->find(name);
-    return found == _d->meshesForName->end() ? -1 : found->second;
+    return _d->forName(NameKind::Mesh, name);
 }
 
 std::string TinyGltfImporter::doMeshName(const UnsignedInt id) {
@@ -1021,6 +1375,154 @@ std::string TinyGltfImporter::doMeshName(const UnsignedInt id) {
     return _d->model.meshes[_d->meshMap[id].first].name;
 }
 
+namespace {
+
+/* Copies texture coordinates while doing a Y-flip on them. Used for
+   contiguous attributes instead of a copy followed by an in-place flip, so
+   the data are touched only once. The results are the same as with the
+   in-place flip. */
+void copyTextureCoordinatesYFlipped(const Containers::ArrayView<const char> src, const Containers::ArrayView<char> dst, const VertexFormat format) {
+    CORRADE_INTERNAL_ASSERT(src.size() == dst.size());
+    std::size_t i = 0;
+
+    if(format == VertexFormat::Vector2) {
+        #ifdef CORRADE_TARGET_SSE2
+        /* Two texture coordinates at a time, selecting the flipped value only
+           for the Y lanes so -0.0 and NaNs in X stay the same */
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 yMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, -1, 0));
+        for(; i + 16 <= src.size(); i += 16) {
+            const __m128 in = _mm_loadu_ps(reinterpret_cast<const Float*>(src.data() + i));
+            const __m128 flipped = _mm_sub_ps(one, in);
+            _mm_storeu_ps(reinterpret_cast<Float*>(dst.data() + i),
+                _mm_or_ps(_mm_and_ps(yMask, flipped), _mm_andnot_ps(yMask, in)));
+        }
+        #endif
+        for(; i != src.size(); i += sizeof(Vector2)) {
+            Vector2 c;
+            std::memcpy(&c, src.data() + i, sizeof(Vector2));
+            c.y() = 1.0f - c.y();
+            std::memcpy(dst.data() + i, &c, sizeof(Vector2));
+        }
+
+    /* For unsigned normalized types, 255 - y and 65535 - y is the same as
+       flipping all bits */
+    } else if(format == VertexFormat::Vector2ubNormalized) {
+        #ifdef CORRADE_TARGET_SSE2
+        const __m128i yMask = _mm_set1_epi16(Short(0xff00));
+        for(; i + 16 <= src.size(); i += 16)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst.data() + i),
+                _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src.data() + i)), yMask));
+        #endif
+        for(; i != src.size(); i += sizeof(Vector2ub)) {
+            dst[i] = src[i];
+            dst[i + 1] = char(255 - UnsignedByte(src[i + 1]));
+        }
+
+    } else if(format == VertexFormat::Vector2usNormalized) {
+        #ifdef CORRADE_TARGET_SSE2
+        const __m128i yMask = _mm_set1_epi32(Int(0xffff0000));
+        for(; i + 16 <= src.size(); i += 16)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst.data() + i),
+                _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src.data() + i)), yMask));
+        #endif
+        for(; i != src.size(); i += sizeof(Vector2us)) {
+            Vector2us c;
+            std::memcpy(&c, src.data() + i, sizeof(Vector2us));
+            c.y() = 65535 - c.y();
+            std::memcpy(dst.data() + i, &c, sizeof(Vector2us));
+        }
+
+    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+#ifdef CORRADE_TARGET_SSE2
+/* Converts eight 16-bit integers to floats. The unpack for signed types
+   puts the value into the upper half and then sign-extends it with an
+   arithmetic shift. */
+template<class> void dequantizeEight(__m128i in, __m128& lo, __m128& hi);
+template<> inline void dequantizeEight<Short>(const __m128i in, __m128& lo, __m128& hi) {
+    lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16));
+    hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16));
+}
+template<> inline void dequantizeEight<UnsignedShort>(const __m128i in, __m128& lo, __m128& hi) {
+    lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(in, _mm_setzero_si128()));
+    hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(in, _mm_setzero_si128()));
+}
+/* For bytes the input has only the lower eight bytes filled, which get
+   widened to 16 bits first */
+template<> inline void dequantizeEight<Byte>(const __m128i in, __m128& lo, __m128& hi) {
+    dequantizeEight<Short>(_mm_srai_epi16(_mm_unpacklo_epi8(in, in), 8), lo, hi);
+}
+template<> inline void dequantizeEight<UnsignedByte>(const __m128i in, __m128& lo, __m128& hi) {
+    dequantizeEight<UnsignedShort>(_mm_unpacklo_epi8(in, _mm_setzero_si128()), lo, hi);
+}
+
+template<class T> inline __m128i loadEight(const char* data) {
+    return sizeof(T) == 1 ?
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data)) :
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+/* Same operation as Math::unpack(), the division is kept to have the same
+   results as the scalar code */
+template<class T> inline __m128 unpackFour(const __m128 in) {
+    const __m128 out = _mm_div_ps(in, _mm_set1_ps(Float(std::numeric_limits<T>::max())));
+    return std::is_signed<T>::value ? _mm_max_ps(out, _mm_set1_ps(-1.0f)) : out;
+}
+#endif
+
+/* Converts integer vertex data to floats, optionally unpacking normalized
+   values to the [0, 1] or [-1, 1] range. Contiguous data are processed as a
+   flat array, eight components at a time using SSE2 if available. */
+template<class T> void dequantizeComponents(const Containers::StridedArrayView1D<const char>& src, const std::size_t componentCount, const bool normalized, const Containers::ArrayView<Float> dst) {
+    CORRADE_INTERNAL_ASSERT(src.size()*componentCount == dst.size());
+
+    if(src.stride() == std::ptrdiff_t(componentCount*sizeof(T))) {
+        const char* const data = static_cast<const char*>(src.data());
+        std::size_t i = 0;
+        #ifdef CORRADE_TARGET_SSE2
+        for(; i + 8 <= dst.size(); i += 8) {
+            __m128 lo, hi;
+            dequantizeEight<T>(loadEight<T>(data + i*sizeof(T)), lo, hi);
+            if(normalized) {
+                lo = unpackFour<T>(lo);
+                hi = unpackFour<T>(hi);
+            }
+            _mm_storeu_ps(dst.data() + i, lo);
+            _mm_storeu_ps(dst.data() + i + 4, hi);
+        }
+        #endif
+        for(; i != dst.size(); ++i) {
+            T value;
+            std::memcpy(&value, data + i*sizeof(T), sizeof(T));
+            dst[i] = normalized ? Math::unpack<Float>(value) : Float(value);
+        }
+
+    } else for(std::size_t i = 0; i != src.size(); ++i) {
+        const char* const data = &src[i];
+        for(std::size_t j = 0; j != componentCount; ++j) {
+            T value;
+            std::memcpy(&value, data + j*sizeof(T), sizeof(T));
+            dst[i*componentCount + j] = normalized ? Math::unpack<Float>(value) : Float(value);
+        }
+    }
+}
+
+void dequantize(const Containers::StridedArrayView1D<const char>& src, const VertexFormat componentFormat, const std::size_t componentCount, const bool normalized, const Containers::ArrayView<Float> dst) {
+    if(componentFormat == VertexFormat::Byte)
+        dequantizeComponents<Byte>(src, componentCount, normalized, dst);
+    else if(componentFormat == VertexFormat::UnsignedByte)
+        dequantizeComponents<UnsignedByte>(src, componentCount, normalized, dst);
+    else if(componentFormat == VertexFormat::Short)
+        dequantizeComponents<Short>(src, componentCount, normalized, dst);
+    else if(componentFormat == VertexFormat::UnsignedShort)
+        dequantizeComponents<UnsignedShort>(src, componentCount, normalized, dst);
+    else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+}
+
 Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, UnsignedInt) {
     const tinygltf::Mesh& mesh = _d->model.meshes[_d->meshMap[id].first];
     const tinygltf::Primitive& primitive = mesh.primitives[_d->meshMap[id].second];
@@ -1052,6 +1554,20 @@ Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, Un
     std::size_t attributeId = 0;
     Math::Range1D<std::size_t> bufferRange;
     Containers::Array<MeshAttributeData> attributeData{primitive.attributes.size()};
+
+    /* Integer positions, normals, tangents and texture coordinates get
+       converted to floats during the copy if requested. The component count
+       is zero for attributes that are copied as-is. */
+    const bool dequantizeAttributes = configuration().value<bool>("dequantizeAttributes");
+    struct Dequantization {
+        VertexFormat componentFormat;
+        UnsignedInt componentCount;
+        bool normalized;
+    };
+    Containers::Array<Dequantization> dequantization{Containers::ValueInit, primitive.attributes.size()};
+    std::size_t dequantizedCount = 0;
+    std::size_t dequantizedSize = 0;
+
     for(auto& attribute: primitive.attributes) {
         auto* acessorPointer = checkedAccessor(_d->model, "mesh", attribute.second);
         if(!acessorPointer) return Containers::NullOpt;
@@ -1257,6 +1773,17 @@ Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, Un
             }
         }
 
+        if(dequantizeAttributes && !vectorCount &&
+           componentFormat != VertexFormat::Float &&
+          (name == MeshAttribute::Position ||
+           name == MeshAttribute::Normal ||
+           name == MeshAttribute::Tangent ||
+           name == MeshAttribute::TextureCoordinates)) {
+            dequantization[attributeId] = Dequantization{componentFormat, componentCount, accessor.normalized};
+            ++dequantizedCount;
+            dequantizedSize += vertexCount*componentCount*sizeof(Float);
+        }
+
         /* Fill in an attribute. Offset-only, will be patched to be relative to
            the actual output buffer once we know how large it is and where it
            is allocated. */
@@ -1269,28 +1796,97 @@ Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, Un
     /* Verify we really filled all attributes */
     CORRADE_INTERNAL_ASSERT(attributeId == attributeData.size());
 
-    /* Allocate & copy vertex data (if any) */
-    Containers::Array<char> vertexData{Containers::NoInit, bufferRange.size()};
-    if(vertexData.size()) Utility::copy(Containers::arrayCast<const char>(
-        Containers::arrayView(_d->model.buffers[bufferId].data)
-            .slice(bufferRange.min(), bufferRange.max())),
-        vertexData);
+    /* Texture coordinates that need a Y-flip and are contiguous get flipped
+       while being copied. Pick the ones that don't overlap each other -- the
+       rest is flipped in-place after the copy, same as interleaved
+       attributes. */
+    Containers::Array<bool> yFlippedWhileCopying{Containers::ValueInit, attributeData.size()};
+    Containers::Array<UnsignedInt> yFlippedAttributes;
+    if(!_d->textureCoordinateYFlipInMaterial) {
+        for(std::size_t i = 0; i != attributeData.size(); ++i) {
+            const VertexFormat format = attributeData[i].format();
+            if(attributeData[i].name() == MeshAttribute::TextureCoordinates &&
+               !dequantization[i].componentCount &&
+               (format == VertexFormat::Vector2 ||
+                format == VertexFormat::Vector2ubNormalized ||
+                format == VertexFormat::Vector2usNormalized) &&
+               attributeData[i].stride() == std::ptrdiff_t(vertexFormatSize(format)))
+                arrayAppend(yFlippedAttributes, UnsignedInt(i));
+        }
+
+        std::sort(yFlippedAttributes.begin(), yFlippedAttributes.end(), [&attributeData](UnsignedInt a, UnsignedInt b) {
+            return attributeData[a].offset({}) < attributeData[b].offset({});
+        });
+        std::size_t end = 0;
+        for(const UnsignedInt i: yFlippedAttributes) {
+            const std::size_t offset = attributeData[i].offset({});
+            if(offset < end) continue;
+            yFlippedWhileCopying[i] = true;
+            end = offset + vertexCount*attributeData[i].stride();
+        }
+    }
+
+    /* Allocate vertex data (if any). If all attributes get dequantized, the
+       original range doesn't need to be copied at all, otherwise the
+       dequantized attributes are put after it, aligned to four bytes. */
+    const std::size_t copiedSize = dequantizedCount == attributeData.size() ? 0 : bufferRange.size();
+    std::size_t dequantizedOffset = (copiedSize + 3) & ~std::size_t{3};
+    Containers::Array<char> vertexData{Containers::NoInit, dequantizedSize ? dequantizedOffset + dequantizedSize : copiedSize};
+
+    /* Copy the original range, flipping the texture coordinates picked above
+       in the process */
+    const Containers::ArrayView<const char> bufferData = Containers::arrayCast<const char>(Containers::arrayView(_d->model.buffers[bufferId].data));
+    if(copiedSize) {
+        const Containers::ArrayView<const char> src = bufferData.slice(bufferRange.min(), bufferRange.max());
+        const Containers::ArrayView<char> dst = vertexData.prefix(copiedSize);
+
+        std::size_t copied = 0;
+        for(const UnsignedInt i: yFlippedAttributes) {
+            if(!yFlippedWhileCopying[i]) continue;
+
+            const std::size_t begin = attributeData[i].offset({}) - bufferRange.min();
+            const std::size_t end = begin + vertexCount*attributeData[i].stride();
+            Utility::copy(src.slice(copied, begin), dst.slice(copied, begin));
+            copyTextureCoordinatesYFlipped(src.slice(begin, end), dst.slice(begin, end), attributeData[i].format());
+            copied = end;
+        }
+        Utility::copy(src.suffix(copied), dst.suffix(copied));
+    }
 
     /* Convert the attributes from relative to absolute, copy them to a
        non-growable array and do additional patching */
     for(std::size_t i = 0; i != attributeData.size(); ++i) {
-        Containers::StridedArrayView1D<char> data{vertexData,
+        Containers::StridedArrayView1D<char> data;
+        VertexFormat format = attributeData[i].format();
+
+        /* Dequantize directly from the source buffer into the area after the
+           copied range */
+        if(const UnsignedInt componentCount = dequantization[i].componentCount) {
+            const std::size_t size = vertexCount*componentCount*sizeof(Float);
+            dequantize(Containers::StridedArrayView1D<const char>{bufferData,
+                    bufferData + attributeData[i].offset(bufferData),
+                    vertexCount, attributeData[i].stride()},
+                dequantization[i].componentFormat, componentCount,
+                dequantization[i].normalized,
+                Containers::arrayCast<Float>(vertexData.slice(dequantizedOffset, dequantizedOffset + size)));
+            data = Containers::StridedArrayView1D<char>{vertexData,
+                vertexData + dequantizedOffset, vertexCount,
+                std::ptrdiff_t(componentCount*sizeof(Float))};
+            format = vertexFormat(VertexFormat::Float, componentCount, false);
+            dequantizedOffset += size;
+
+        } else data = Containers::StridedArrayView1D<char>{vertexData,
             /* Offset is what with the range min subtracted, as we copied
                without the prefix */
             vertexData + attributeData[i].offset(vertexData) - bufferRange.min(),
             vertexCount, attributeData[i].stride()};
 
         attributeData[i] = MeshAttributeData{attributeData[i].name(),
-            attributeData[i].format(), data};
+            format, data};
 
         /* Flip Y axis of texture coordinates, unless it's done in the material
-           instead */
-        if(attributeData[i].name() == MeshAttribute::TextureCoordinates && !_d->textureCoordinateYFlipInMaterial) {
+           instead or it was done already while copying */
+        if(attributeData[i].name() == MeshAttribute::TextureCoordinates && !_d->textureCoordinateYFlipInMaterial && !yFlippedWhileCopying[i]) {
            if(attributeData[i].format() == VertexFormat::Vector2)
                 for(auto& c: Containers::arrayCast<Vector2>(data))
                     c.y() = 1.0f - c.y();
@@ -1382,15 +1978,7 @@ UnsignedInt TinyGltfImporter::doMaterialCount() const {
 }
 
 Int TinyGltfImporter::doMaterialForName(const std::string& name) {
-    if(!_d->materialsForName) {
-        _d->materialsForName.emplace();
-        _d->materialsForName->reserve(_d->model.materials.size());
-        for(std::size_t i = 0; i != _d->model.materials.size(); ++i)
-            _d->materialsForName->emplace(_d->model.materials[i].name, i);
-    }
-
-    const auto found = _d->materialsForName->find(name);
-    return found == _d->materialsForName->end() ? -1 : found->second;
+    return _d->forName(NameKind::Material, name);
 }
 
 std::string TinyGltfImporter::doMaterialName(const UnsignedInt id) {
@@ -1642,15 +2230,7 @@ UnsignedInt TinyGltfImporter::doTextureCount() const {
 }
 
 Int TinyGltfImporter::doTextureForName(const std::string& name) {
-    if(!_d->texturesForName) {
-        _d->texturesForName.emplace();
-        _d->texturesForName->reserve(_d->model.textures.size());
-        for(std::size_t i = 0; i != _d->model.textures.size(); ++i)
-            _d->texturesForName->emplace(_d->model.textures[i].name, i);
-    }
-
-    const auto found = _d->texturesForName->find(name);
-    return found == _d->texturesForName->end() ? -1 : found->second;
+    return _d->forName(NameKind::Texture, name);
 }
 
 std::string TinyGltfImporter::doTextureName(const UnsignedInt id) {
@@ -1663,6 +2243,23 @@ Containers::Optional<TextureData> TinyGltfImporter::doTexture(const UnsignedInt
     /* Image ID. Try various extensions first. */
     UnsignedInt imageId;
 
+    /* KTX2 with Basis Universal supercompression. No importer here can
+       decode KTX2, so the core source, which the extension specifies as a
+       fallback for implementations not supporting it, is used unless the
+       extension is explicitly preferred or there's no core source. */
+    const auto basisu = tex.extensions.find("KHR_texture_basisu");
+    if(basisu != tex.extensions.end() && (tex.source == -1 || configuration().value<bool>("preferKhrTextureBasisu"))) {
+        const tinygltf::Value& source = basisu->second.Get("source");
+        if(!source.IsInt()) {
+            Error{} << "Trade::TinyGltfImporter::texture(): invalid KHR_texture_basisu image source";
+            return Containers::NullOpt;
+        }
+        if(UnsignedInt(source.Get<int>()) >= _d->model.images.size()) {
+            Error{} << "Trade::TinyGltfImporter::texture(): KHR_texture_basisu image" << source.Get<int>() << "out of bounds for" << _d->model.images.size() << "images";
+            return Containers::NullOpt;
+        }
+        imageId = source.Get<int>();
+
     /* Basis textures. This extension is nonstandard and in case of embedded
        images there's no standardized MIME type either. Fortunately we
        don't care as we detect the file type based on magic, unfortunately we
@@ -1673,7 +2270,7 @@ Containers::Optional<TextureData> TinyGltfImporter::doTexture(const UnsignedInt
        more complex as well). For reference:
        https://github.com/BabylonJS/Babylon.js/issues/6636
        https://github.com/BinomialLLC/basis_universal/issues/52 */
-    if(tex.extensions.find("GOOGLE_texture_basis") != tex.extensions.end()) {
+    } else if(tex.extensions.find("GOOGLE_texture_basis") != tex.extensions.end()) {
         /** @todo check for "extensionsRequired" as well? currently not doing
             that, because I don't see why */
         tinygltf::Value basis = tex.extensions.at("GOOGLE_texture_basis");
@@ -1778,43 +2375,20 @@ UnsignedInt TinyGltfImporter::doImage2DCount() const {
 }
 
 Int TinyGltfImporter::doImage2DForName(const std::string& name) {
-    if(!_d->imagesForName) {
-        _d->imagesForName.emplace();
-        _d->imagesForName->reserve(_d->model.images.size());
-        for(std::size_t i = 0; i != _d->model.images.size(); ++i)
-            _d->imagesForName->emplace(_d->model.images[i].name, i);
-    }
-
-    const auto found = _d->imagesForName->find(name);
-    return found == _d->imagesForName->end() ? -1 : found->second;
+    return _d->forName(NameKind::Image, name);
 }
 
 std::string TinyGltfImporter::doImage2DName(const UnsignedInt id) {
     return _d->model.images[id].name;
 }
 
-AbstractImporter* TinyGltfImporter::setupOrReuseImporterForImage(const UnsignedInt id, const char* const errorPrefix) {
-    /* Looking for the same ID, so reuse an importer populated before. If the
-       previous attempt failed, the importer is not set, so return nullptr in
-       that case. Going through everything below again would not change the
-       outcome anyway, only spam the output with redundant messages. */
-    if(_d->imageImporterId == id)
-        return _d->imageImporter ? &*_d->imageImporter : nullptr;
-
-    /* Otherwise reset the importer and remember the new ID. If the import
-       fails, the importer will stay unset, but the ID will be updated so the
-       next round can again just return nullptr above instead of going through
-       the doomed-to-fail process again. */
-    _d->imageImporter = Containers::NullOpt;
-    _d->imageImporterId = id;
-
+bool TinyGltfImporter::openImporterForImage(AbstractImporter& importer, const UnsignedInt id, const char* const errorPrefix) {
     /* Because we specified an empty callback for loading image data,
        Image.image, Image.width, Image.height and Image.component will not be
        valid and should not be accessed. */
 
     const tinygltf::Image& image = _d->model.images[id];
 
-    AnyImageImporter importer{*manager()};
     if(fileCallback()) importer.setFileCallback(fileCallback(), fileCallbackUserData());
 
     /* Load embedded image */
@@ -1834,22 +2408,52 @@ AbstractImporter* TinyGltfImporter::setupOrReuseImporterForImage(const UnsignedI
             data = Containers::arrayCast<const char>(Containers::arrayView(image.image.data(), image.image.size()));
         }
 
-        Containers::Optional<ImageData2D> imageData;
-        if(!importer.openData(data))
-            return nullptr;
-        return &_d->imageImporter.emplace(std::move(importer));
+        return importer.openData(data);
     }
 
     /* Load external image */
     if(!_d->filePath && !fileCallback()) {
         Error{} << errorPrefix << "external images can be imported only when opening files from the filesystem or if a file callback is present";
-        return nullptr;
+        return false;
     }
 
-    Containers::Optional<ImageData2D> imageData;
-    if(!importer.openFile(Utility::Directory::join(_d->filePath ? *_d->filePath : "", image.uri)))
+    return importer.openFile(Utility::Directory::join(_d->filePath ? *_d->filePath : "", image.uri));
+}
+
+AbstractImporter* TinyGltfImporter::setupOrReuseImporterForImage(const UnsignedInt id, const char* const errorPrefix) {
+    if(!_d->imageImporters)
+        _d->imageImporters = Containers::Array<Document::ImageImporter>{Containers::ValueInit,
+            Math::max(configuration().value<UnsignedInt>("imageImporterCacheSize"), 1u)};
+
+    /* Looking for an ID that's in the cache, so reuse an importer populated
+       before. If the previous attempt failed, the importer is not set, so
+       return nullptr in that case. Going through everything below again would
+       not change the outcome anyway, only spam the output with redundant
+       messages. The cache is expected to be small, so a linear search is
+       fine. */
+    Document::ImageImporter* leastRecentlyUsed = nullptr;
+    for(Document::ImageImporter& entry: _d->imageImporters) {
+        if(entry.id == id) {
+            entry.lastUsed = ++_d->imageImporterUseCounter;
+            return entry.importer ? &*entry.importer : nullptr;
+        }
+
+        if(!leastRecentlyUsed || entry.lastUsed < leastRecentlyUsed->lastUsed)
+            leastRecentlyUsed = &entry;
+    }
+
+    /* Otherwise evict the least recently used importer and remember the new
+       ID in its place. If the import fails, the importer will stay unset, but
+       the ID will be updated so the next round can again just return nullptr
+       above instead of going through the doomed-to-fail process again. */
+    leastRecentlyUsed->importer = Containers::NullOpt;
+    leastRecentlyUsed->id = id;
+    leastRecentlyUsed->lastUsed = ++_d->imageImporterUseCounter;
+
+    AnyImageImporter importer{*manager()};
+    if(!openImporterForImage(importer, id, errorPrefix))
         return nullptr;
-    return &_d->imageImporter.emplace(std::move(importer));
+    return &leastRecentlyUsed->importer.emplace(std::move(importer));
 }
 
 UnsignedInt TinyGltfImporter::doImage2DLevelCount(const UnsignedInt id) {
@@ -1875,6 +2479,41 @@ Containers::Optional<ImageData2D> TinyGltfImporter::doImage2D(const UnsignedInt
     return ImageData2D{std::move(*imageData), &_d->model.images[id]};
 }
 
+Containers::Array<Containers::Optional<ImageData2D>> TinyGltfImporter::image2DBatch(const Containers::ArrayView<const UnsignedInt> ids, const UnsignedInt level) {
+    CORRADE_ASSERT(isOpened(), "Trade::TinyGltfImporter::image2DBatch(): no file opened", {});
+    CORRADE_ASSERT(manager(), "Trade::TinyGltfImporter::image2DBatch(): the plugin must be instantiated with access to plugin manager in order to load images", {});
+
+    /* Open all importers upfront on this thread -- instantiating plugins
+       through the manager isn't thread-safe, and it's also where the file
+       I/O happens. Only the actual decoding is then done in parallel, with
+       each image having its own importer instance. */
+    Containers::Array<Containers::Optional<AnyImageImporter>> importers{Containers::ValueInit, ids.size()};
+    for(std::size_t i = 0; i != ids.size(); ++i) {
+        CORRADE_ASSERT(ids[i] < _d->model.images.size(),
+            "Trade::TinyGltfImporter::image2DBatch(): index" << ids[i] << "out of range for" << _d->model.images.size() << "entries", {});
+
+        AnyImageImporter importer{*manager()};
+        if(!openImporterForImage(importer, ids[i], "Trade::TinyGltfImporter::image2DBatch():"))
+            continue;
+
+        CORRADE_ASSERT(level < importer.image2DLevelCount(0),
+            "Trade::TinyGltfImporter::image2DBatch(): level" << level << "out of range for" << importer.image2DLevelCount(0) << "entries in image" << ids[i], {});
+        importers[i].emplace(std::move(importer));
+    }
+
+    Containers::Array<Containers::Optional<ImageData2D>> out{Containers::ValueInit, ids.size()};
+    Magnum::Implementation::parallelFor(configuration().value<UnsignedInt>("imageThreads"), ids.size(), [&](std::size_t i) {
+        if(!importers[i]) return;
+
+        /* Include a pointer to the tinygltf state in the result */
+        Containers::Optional<ImageData2D> imageData = importers[i]->image2D(0, level);
+        if(imageData) out[i] = ImageData2D{std::move(*imageData), &_d->model.images[ids[i]]};
+    });
+
+
+    return out;
+}
+
 const void* TinyGltfImporter::doImporterState() const {
     return &_d->model;
 }
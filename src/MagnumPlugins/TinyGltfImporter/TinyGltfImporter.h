@@ -133,6 +133,23 @@ read.
 
 Import of skeleton, skin and morph data is not supported at the moment.
 
+All @ref animationForName(), @ref cameraForName(), @ref object3DForName(),
+@ref meshForName() and other name queries share a single lookup table that's
+built in one pass over all object names, referencing the names stored in
+the `tinygltf::Model` instead of copying them. The table is built on the first
+query, enable the @cb{.ini} buildNameLookupOnOpen @ce
+@ref Trade-TinyGltfImporter-configuration "configuration option" to build it
+already when opening the file instead.
+
+By default the file is parsed using the JSON library bundled with `tiny_gltf`,
+which builds a DOM of the whole file first. Enabling the
+@cb{.ini} fastJsonParser @ce
+@ref Trade-TinyGltfImporter-configuration "configuration option" makes the
+plugin use a tokenizer that works directly on the file data, with string
+values referencing it instead of being copied, and fill the same
+`tinygltf::Model` from it. All other behavior is unaffected, only JSON syntax
+errors are worded differently.
+
 @subsection Trade-TinyGltfImporter-behavior-animation Animation import
 
 -   Linear quaternion rotation tracks are postprocessed in order to make it
@@ -177,6 +194,12 @@ Import of skeleton, skin and morph data is not supported at the moment.
     warning and normalizes it. Can be disabled per-object with the
     @cb{.ini} normalizeQuaternions @ce option, see
     @ref Trade-TinyGltfImporter-configuration "below".
+-   If you use this class directly (and not through a plugin manager), the
+    whole object hierarchy can be imported at once using
+    @ref flatHierarchy(), which avoids allocating an @ref ObjectData3D
+    instance for every node. The object IDs are the same as with
+    @ref object3D(). The returned @ref FlatHierarchy structure is defined in
+    a separate `MagnumPlugins/TinyGltfImporter/FlatHierarchy.h` header.
 
 @subsection Trade-TinyGltfImporter-behavior-camera Camera import
 
@@ -254,6 +277,17 @@ Import of skeleton, skin and morph data is not supported at the moment.
         extra nodes, always pointing to the first object in the sequence and
         thus indirectly affecting transformations of the extra nodes
         represented as its children
+-   Integer positions, normals, tangents and texture coordinates allowed by
+    [KHR_mesh_quantization](https://github.com/KhronosGroup/glTF/blob/master/extensions/2.0/Khronos/KHR_mesh_quantization/README.md)
+    are by default imported as-is, with the dequantization transform being
+    part of node transformations and material texture transformations as the
+    extension specifies. Enable the @cb{.ini} dequantizeAttributes @ce
+    @ref Trade-TinyGltfImporter-configuration "configuration option" to have
+    them converted to @ref VertexFormat::Vector2, @ref VertexFormat::Vector3
+    or @ref VertexFormat::Vector4 during import instead, with normalized
+    values unpacked the same way as @ref MeshData::positions3DAsArray() and
+    other convenience accessors do. The transformations are not applied to
+    the data in either case.
 -   Attribute-less meshes either with or without an index buffer are supported,
     however since glTF has no way of specifying vertex count for those,
     returned @ref Trade::MeshData::vertexCount() is set to @cpp 0 @ce
@@ -366,8 +400,53 @@ following defaults have been chosen for this importer:
     }
     @endcode
 </li>
+<li>
+    The [KHR_texture_basisu](https://github.com/KhronosGroup/glTF/tree/master/extensions/2.0/Khronos/KHR_texture_basisu)
+    extension is recognized as well. The extension requires the images to be
+    KTX2 files, which no importer in this repository supports yet, so by
+    default the core @cb{.json} "source" @ce, which the extension specifies
+    as a fallback, is used instead. Enable the
+    @cb{.ini} preferKhrTextureBasisu @ce
+    @ref Trade-TinyGltfImporter-configuration "configuration option" to use
+    the extension @cb{.json} "source" @ce if you have an importer able to
+    open such images. Textures that have no core source use the extension
+    image always. The image is again loaded using @ref AnyImageImporter,
+    which picks the importer based on the file extension, and the same
+    restriction for embedded data URIs as above applies.
+</li>
+<li>
+    Image importers opened by @ref image2DLevelCount() and @ref image2D() are
+    kept around so accessing different levels of the same image doesn't need
+    to open and parse the file again. By default only the last used importer
+    is kept, use the @cb{.ini} imageImporterCacheSize @ce
+    @ref Trade-TinyGltfImporter-configuration "configuration option" to keep
+    more of them when alternating between several images.
+</li>
 </ul>
 
+@subsubsection Trade-TinyGltfImporter-behavior-textures-parallel Parallel image import
+
+If you use this class directly (and not through a plugin manager), it's
+possible to import multiple images at once using @ref image2DBatch(). Files
+are opened in the calling thread, after which the images are decoded on
+@cb{.ini} imageThreads @ce threads, each using a separate image importer
+instance. Setting the @ref Trade-TinyGltfImporter-configuration "configuration option"
+to @cpp 0 @ce uses the value of @ref std::thread::hardware_concurrency(),
+@cpp 1 @ce, which is the default, decodes everything on the calling thread.
+On @ref CORRADE_TARGET_EMSCRIPTEN "Emscripten" the import is always done on
+the calling thread. The call blocks until all images are decoded.
+
+For the parallel decode to be safe, the plugins used for importing given image
+formats have to support being used from multiple threads at once. Similarly
+to @ref Trade-BasisImageConverter-loading "BasisImageConverter", if the option
+is set to a value other than @cpp 1 @ce, on Linux the *application* has to be
+linked to `pthread` for the threads to be created successfully:
+
+@code{.cmake}
+find_package(Threads REQUIRED)
+target_link_libraries(your-application PRIVATE Threads::Threads)
+@endcode
+
 @section Trade-TinyGltfImporter-configuration Plugin-specific config
 
 It's possible to tune various output options through @ref configuration(). See
@@ -408,6 +487,10 @@ this:
 */
 class MAGNUM_TINYGLTFIMPORTER_EXPORT TinyGltfImporter: public AbstractImporter {
     public:
+        /* Defined in FlatHierarchy.h to not force the Array and Matrix4
+           includes on all users of this header */
+        struct FlatHierarchy;
+
         /**
          * @brief Default constructor
          *
@@ -439,6 +522,39 @@ class MAGNUM_TINYGLTFIMPORTER_EXPORT TinyGltfImporter: public AbstractImporter {
             return static_cast<const tinygltf::Model*>(AbstractImporter::importerState());
         }
 
+        /**
+         * @brief Import multiple images in parallel
+         * @param ids       Image IDs, each expected to be less than
+         *      @ref image2DCount()
+         * @param level     Mip level, expected to be less than
+         *      @ref image2DLevelCount() for all images
+         *
+         * Equivalent to calling @ref image2D() for each ID in @p ids, but
+         * with the images decoded in parallel. The items are in the same order
+         * as @p ids, failed imports are set to @ref Containers::NullOpt. See
+         * @ref Trade-TinyGltfImporter-behavior-textures-parallel for more
+         * information.
+         */
+        Containers::Array<Containers::Optional<ImageData2D>> image2DBatch(Containers::ArrayView<const UnsignedInt> ids, UnsignedInt level = 0);
+
+        /**
+         * @brief Import the whole object hierarchy
+         *
+         * Returns data for all @ref object3DCount() objects in a
+         * structure-of-arrays form, with each array indexed by the object ID,
+         * in a single pass. Compared to calling @ref object3D() for each
+         * object, there are no per-object allocations. Unlike with
+         * @ref object3D(), a node referencing both a mesh and a camera or a
+         * light has all of them filled in. Expects that a file is opened.
+         * See @ref Trade-TinyGltfImporter-behavior-objects for more
+         * information.
+         *
+         * The @ref FlatHierarchy structure is defined in
+         * @ref MagnumPlugins/TinyGltfImporter/FlatHierarchy.h, include it
+         * in order to use this function.
+         */
+        FlatHierarchy flatHierarchy();
+
     private:
         struct Document;
 
@@ -496,6 +612,7 @@ class MAGNUM_TINYGLTFIMPORTER_EXPORT TinyGltfImporter: public AbstractImporter {
         MAGNUM_TINYGLTFIMPORTER_LOCAL std::string doTextureName(UnsignedInt id) override;
         MAGNUM_TINYGLTFIMPORTER_LOCAL Containers::Optional<TextureData> doTexture(UnsignedInt id) override;
 
+        MAGNUM_TINYGLTFIMPORTER_LOCAL bool openImporterForImage(AbstractImporter& importer, UnsignedInt id, const char* errorPrefix);
         MAGNUM_TINYGLTFIMPORTER_LOCAL AbstractImporter* setupOrReuseImporterForImage(UnsignedInt id, const char* errorPrefix);
 
         MAGNUM_TINYGLTFIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
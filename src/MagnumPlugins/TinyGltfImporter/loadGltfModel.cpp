@@ -0,0 +1,1356 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "loadGltfModel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Corrade/Utility/FormatStl.h>
+
+#include "MagnumPlugins/TinyGltfImporter/Json.h"
+
+/* Without TINYGLTF_IMPLEMENTATION this is just the data structures and a few
+   function declarations, the JSON library and the parser itself get compiled
+   only into TinyGltfImporter.cpp. IsDataURI() and DecodeDataURI() are used
+   from there as well. */
+#include "tiny_gltf.h"
+
+namespace Magnum { namespace Trade { namespace Implementation {
+
+/* Everything below mirrors the corresponding Parse*() function in
+   tiny_gltf.h, including the error messages and the order in which they're
+   produced, so the importer behaves the same with both parsers. Deviations
+   are commented. */
+
+namespace {
+
+inline const JsonToken* find(const JsonToken& object, const char* const name) {
+    return jsonFind(object, Containers::ArrayView<const char>{name, std::strlen(name)});
+}
+
+/* Calls given function for each key and value of an object. The JSON
+   library tinygltf uses keeps only the last value of a duplicated key, so
+   the earlier ones are skipped. */
+template<class F> void forEachMember(const JsonToken& object, F f) {
+    const JsonToken* i = &object + 1;
+    for(UnsignedInt j = 0; j != object.size; ++j) {
+        const JsonToken* const value = i + 1;
+        const std::string key = jsonString(*i);
+        if(jsonFind(object, Containers::ArrayView<const char>{key.data(), key.size()}) == value)
+            f(key, *value);
+        i = value + value->tokenCount;
+    }
+}
+
+/* Integers with a fraction or an exponent are not integers for tinygltf */
+bool getInteger(const JsonToken& token, Int& out) {
+    if(token.type != JsonTokenType::Number) return false;
+
+    const JsonNumber number = jsonNumber(token);
+    if(number.type == JsonNumberType::Float) return false;
+
+    out = Int(number.type == JsonNumberType::Unsigned ? Long(number.unsignedValue) : number.signedValue);
+    return true;
+}
+
+bool getNumber(const JsonToken& token, Double& out) {
+    if(token.type != JsonTokenType::Number) return false;
+
+    const JsonNumber number = jsonNumber(token);
+    if(number.type == JsonNumberType::Unsigned)
+        out = Double(number.unsignedValue);
+    else if(number.type == JsonNumberType::Signed)
+        out = Double(number.signedValue);
+    else out = number.floatValue;
+    return true;
+}
+
+void appendMissing(std::string& err, const char* const property, const char* const parent) {
+    err += Utility::formatString("'{}' property is missing", property);
+    if(parent) {
+        err += " in ";
+        err += parent;
+    }
+    err += ".\n";
+}
+
+bool parseBoolean(bool& out, std::string& err, const JsonToken& o, const char* const property, const bool required = false, const char* const parent = nullptr) {
+    const JsonToken* const value = find(o, property);
+    if(!value) {
+        if(required) appendMissing(err, property, parent);
+        return false;
+    }
+
+    if(value->type != JsonTokenType::True && value->type != JsonTokenType::False) {
+        if(required)
+            err += Utility::formatString("'{}' property is not a bool type.\n", property);
+        return false;
+    }
+
+    out = value->type == JsonTokenType::True;
+    return true;
+}
+
+bool parseInteger(Int& out, std::string& err, const JsonToken& o, const char* const property, const bool required = false, const char* const parent = nullptr) {
+    const JsonToken* const value = find(o, property);
+    if(!value) {
+        if(required) appendMissing(err, property, parent);
+        return false;
+    }
+
+    Int integer;
+    if(!getInteger(*value, integer)) {
+        if(required)
+            err += Utility::formatString("'{}' property is not an integer type.\n", property);
+        return false;
+    }
+
+    out = integer;
+    return true;
+}
+
+bool parseUnsigned(std::size_t& out, std::string& err, const JsonToken& o, const char* const property, const bool required = false, const char* const parent = nullptr) {
+    const JsonToken* const value = find(o, property);
+    if(!value) {
+        if(required) appendMissing(err, property, parent);
+        return false;
+    }
+
+    JsonNumber number;
+    if(value->type != JsonTokenType::Number || (number = jsonNumber(*value)).type != JsonNumberType::Unsigned) {
+        if(required)
+            err += Utility::formatString("'{}' property is not a positive integer.\n", property);
+        return false;
+    }
+
+    out = std::size_t(number.unsignedValue);
+    return true;
+}
+
+bool parseNumber(Double& out, std::string& err, const JsonToken& o, const char* const property, const bool required = false, const char* const parent = nullptr) {
+    const JsonToken* const value = find(o, property);
+    if(!value) {
+        if(required) appendMissing(err, property, parent);
+        return false;
+    }
+
+    Double number;
+    if(!getNumber(*value, number)) {
+        if(required)
+            err += Utility::formatString("'{}' property is not a number type.\n", property);
+        return false;
+    }
+
+    out = number;
+    return true;
+}
+
+/* Unlike the other helpers, on failure in the middle of the array the output
+   contains the elements parsed so far, same as in tinygltf */
+bool parseNumberArray(std::vector<Double>& out, std::string& err, const JsonToken& o, const char* const property, const bool required = false, const char* const parent = nullptr) {
+    const JsonToken* const value = find(o, property);
+    if(!value) {
+        if(required) appendMissing(err, property, parent);
+        return false;
+    }
+
+    if(value->type != JsonTokenType::Array) {
+        if(required) {
+            err += Utility::formatString("'{}' property is not an array", property);
+            if(parent) {
+                err += " in ";
+                err += parent;
+            }
+            err += ".\n";
+        }
+        return false;
+    }
+
+    out.clear();
+    out.reserve(value->size);
+    const JsonToken* i = value + 1;
+    for(UnsignedInt j = 0; j != value->size; ++j, i += i->tokenCount) {
+        Double number;
+        if(!getNumber(*i, number)) {
+            if(required) {
+                err += Utility::formatString("'{}' property is not a number.\n", property);
+                if(parent) {
+                    err += " in ";
+                    err += parent;
+                }
+                err += ".\n";
+            }
+            return false;
+        }
+        out.push_back(number);
+    }
+
+    return true;
+}
+
+bool parseIntegerArray(std::vector<Int>& out, std::string& err, const JsonToken& o, const char* const property, const bool required = false, const char* const parent = nullptr) {
+    const JsonToken* const value = find(o, property);
+    if(!value) {
+        if(required) appendMissing(err, property, parent);
+        return false;
+    }
+
+    if(value->type != JsonTokenType::Array) {
+        if(required) {
+            err += Utility::formatString("'{}' property is not an array", property);
+            if(parent) {
+                err += " in ";
+                err += parent;
+            }
+            err += ".\n";
+        }
+        return false;
+    }
+
+    out.clear();
+    out.reserve(value->size);
+    const JsonToken* i = value + 1;
+    for(UnsignedInt j = 0; j != value->size; ++j, i += i->tokenCount) {
+        Int integer;
+        if(!getInteger(*i, integer)) {
+            if(required) {
+                err += Utility::formatString("'{}' property is not an integer type.\n", property);
+                if(parent) {
+                    err += " in ";
+                    err += parent;
+                }
+                err += ".\n";
+            }
+            return false;
+        }
+        out.push_back(integer);
+    }
+
+    return true;
+}
+
+bool parseString(std::string& out, std::string& err, const JsonToken& o, const char* const property, const bool required = false, const char* const parent = nullptr) {
+    const JsonToken* const value = find(o, property);
+    if(!value) {
+        if(required) {
+            err += Utility::formatString("'{}' property is missing", property);
+            if(parent) err += Utility::formatString(" in `{}'.\n", parent);
+            else err += ".\n";
+        }
+        return false;
+    }
+
+    if(value->type != JsonTokenType::String) {
+        if(required)
+            err += Utility::formatString("'{}' property is not a string type.\n", property);
+        return false;
+    }
+
+    out = jsonString(*value);
+    return true;
+}
+
+bool parseStringInteger(std::map<std::string, Int>& out, std::string& err, const JsonToken& o, const char* const property, const bool required, const char* const parent) {
+    const JsonToken* const value = find(o, property);
+    if(!value) {
+        if(required)
+            err += Utility::formatString("'{}' property is missing in {}.\n", property, parent);
+        return false;
+    }
+
+    if(value->type != JsonTokenType::Object) {
+        if(required)
+            err += Utility::formatString("'{}' property is not an object.\n", property);
+        return false;
+    }
+
+    out.clear();
+    bool success = true;
+    forEachMember(*value, [&](const std::string& key, const JsonToken& member) {
+        if(!success) return;
+
+        Int integer;
+        if(!getInteger(member, integer)) {
+            if(required)
+                err += Utility::formatString("'{}' value is not an integer type.\n", property);
+            success = false;
+            return;
+        }
+        out[key] = integer;
+    });
+
+    return success;
+}
+
+/* Empty objects and arrays and nulls are a NULL_TYPE value, nulls are
+   dropped from objects and arrays */
+tinygltf::Value parseValue(const JsonToken& token) {
+    switch(token.type) {
+        case JsonTokenType::Object: {
+            tinygltf::Value::Object object;
+            const JsonToken* i = &token + 1;
+            for(UnsignedInt j = 0; j != token.size; ++j) {
+                const JsonToken* const value = i + 1;
+                /* A duplicated key overwrites the previous value, so if the
+                   last one is null, there should be no value at all */
+                tinygltf::Value entry = parseValue(*value);
+                if(entry.Type() != tinygltf::NULL_TYPE)
+                    object[jsonString(*i)] = std::move(entry);
+                else object.erase(jsonString(*i));
+                i = value + value->tokenCount;
+            }
+            if(object.empty()) return {};
+            return tinygltf::Value{std::move(object)};
+        }
+
+        case JsonTokenType::Array: {
+            tinygltf::Value::Array array;
+            array.reserve(token.size);
+            const JsonToken* i = &token + 1;
+            for(UnsignedInt j = 0; j != token.size; ++j, i += i->tokenCount) {
+                tinygltf::Value entry = parseValue(*i);
+                if(entry.Type() != tinygltf::NULL_TYPE)
+                    array.push_back(std::move(entry));
+            }
+            if(array.empty()) return {};
+            return tinygltf::Value{std::move(array)};
+        }
+
+        case JsonTokenType::String:
+            return tinygltf::Value{jsonString(token)};
+
+        case JsonTokenType::True:
+        case JsonTokenType::False:
+            return tinygltf::Value{token.type == JsonTokenType::True};
+
+        case JsonTokenType::Number: {
+            const JsonNumber number = jsonNumber(token);
+            if(number.type == JsonNumberType::Float)
+                return tinygltf::Value{number.floatValue};
+            return tinygltf::Value{Int(number.type == JsonNumberType::Unsigned ? Long(number.unsignedValue) : number.signedValue)};
+        }
+
+        case JsonTokenType::Null:
+            return {};
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+void parseExtras(tinygltf::Value& out, const JsonToken& o) {
+    if(const JsonToken* const extras = find(o, "extras"))
+        out = parseValue(*extras);
+}
+
+void parseExtensions(tinygltf::ExtensionMap& out, const JsonToken& o) {
+    const JsonToken* const extensions = find(o, "extensions");
+    if(!extensions || extensions->type != JsonTokenType::Object) return;
+
+    tinygltf::ExtensionMap map;
+    forEachMember(*extensions, [&](const std::string& key, const JsonToken& value) {
+        if(value.type != JsonTokenType::Object) return;
+
+        /* Keep an extension object an object even if it's empty */
+        tinygltf::Value& extension = map[key];
+        extension = parseValue(value);
+        if(extension.Type() == tinygltf::NULL_TYPE && !key.empty())
+            extension = tinygltf::Value{tinygltf::Value::Object{}};
+    });
+
+    out = std::move(map);
+}
+
+bool parseParameter(tinygltf::Parameter& out, std::string& err, const JsonToken& o, const std::string& key) {
+    /* The key isn't null-terminated in the data, so the lookup can't go
+       through the helpers. The order of checks matches tinygltf. */
+    const JsonToken* const value = jsonFind(o, Containers::ArrayView<const char>{key.data(), key.size()});
+    if(!value) return false;
+
+    static_cast<void>(err);
+    switch(value->type) {
+        case JsonTokenType::String:
+            out.string_value = jsonString(*value);
+            return true;
+
+        case JsonTokenType::Array: {
+            out.number_array.clear();
+            const JsonToken* i = value + 1;
+            for(UnsignedInt j = 0; j != value->size; ++j, i += i->tokenCount) {
+                Double number;
+                if(!getNumber(*i, number)) return false;
+                out.number_array.push_back(number);
+            }
+            return true;
+        }
+
+        case JsonTokenType::Number:
+            getNumber(*value, out.number_value);
+            return out.has_number_value = true;
+
+        case JsonTokenType::Object:
+            out.json_double_value.clear();
+            forEachMember(*value, [&](const std::string& name, const JsonToken& member) {
+                Double number;
+                if(getNumber(member, number))
+                    out.json_double_value.emplace(name, number);
+            });
+            return true;
+
+        case JsonTokenType::True:
+        case JsonTokenType::False:
+            out.bool_value = value->type == JsonTokenType::True;
+            return true;
+
+        case JsonTokenType::Null:
+            return false;
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+bool loadExternalFile(std::vector<unsigned char>& out, std::string& err, const std::string& filename, const std::size_t requiredSize, const tinygltf::FsCallbacks& fs) {
+    out.clear();
+
+    /* tinygltf looks into the base directory, which is always empty, and then
+       into the current directory */
+    std::string path = fs.ExpandFilePath(filename, fs.user_data);
+    if(!fs.FileExists(path, fs.user_data)) {
+        path = fs.ExpandFilePath("./" + filename, fs.user_data);
+        if(!fs.FileExists(path, fs.user_data)) path = {};
+    }
+    if(path.empty() || filename.empty()) {
+        err += "File not found : " + filename + "\n";
+        return false;
+    }
+
+    std::vector<unsigned char> data;
+    std::string readError;
+    if(!fs.ReadWholeFile(&data, &readError, path, fs.user_data)) {
+        err += "File read error : " + path + " : " + readError + "\n";
+        return false;
+    }
+
+    if(data.empty()) {
+        err += "File is empty : " + path + "\n";
+        return false;
+    }
+
+    if(data.size() != requiredSize) {
+        err += Utility::formatString("File size mismatch : {}, requestedBytes {}, but got {}\n", path, requiredSize, data.size());
+        return false;
+    }
+
+    out.swap(data);
+    return true;
+}
+
+/* The binary chunk size includes the 8-byte chunk header, same as in
+   tinygltf */
+bool parseBuffer(tinygltf::Buffer& buffer, std::string& err, const JsonToken& o, const tinygltf::FsCallbacks& fs, const bool binary, const Containers::ArrayView<const char> binaryChunk, const std::size_t binarySize) {
+    std::size_t byteLength;
+    if(!parseUnsigned(byteLength, err, o, "byteLength", true, "Buffer"))
+        return false;
+
+    buffer.uri.clear();
+    parseString(buffer.uri, err, o, "uri", false, "Buffer");
+
+    if(!binary && buffer.uri.empty())
+        err += "'uri' is missing from non binary glTF file buffer.\n";
+
+    if(!buffer.uri.empty() || !binary) {
+        if(tinygltf::IsDataURI(buffer.uri)) {
+            std::string mimeType;
+            if(!tinygltf::DecodeDataURI(&buffer.data, mimeType, buffer.uri, byteLength, true)) {
+                err += "Failed to decode 'uri' : " + buffer.uri + " in Buffer\n";
+                return false;
+            }
+        } else if(!loadExternalFile(buffer.data, err, buffer.uri, byteLength, fs))
+            return false;
+
+    } else {
+        if(!binarySize) {
+            err += "Invalid binary data in `Buffer'.\n";
+            return false;
+        }
+
+        if(byteLength > binarySize) {
+            err += Utility::formatString("Invalid `byteLength'. Must be equal or less than binary size: `byteLength' = {}, binary size = {}\n", byteLength, binarySize);
+            return false;
+        }
+
+        /* Because the binary size includes the chunk header, byteLength can be
+           up to 8 bytes larger than the data actually present. tinygltf reads
+           past the end in that case, here the rest is zero-filled instead. */
+        buffer.data.resize(byteLength);
+        const std::size_t copySize = std::min(byteLength, binaryChunk.size());
+        if(copySize) std::memcpy(buffer.data.data(), binaryChunk.data(), copySize);
+    }
+
+    parseString(buffer.name, err, o, "name");
+    parseExtensions(buffer.extensions, o);
+    parseExtras(buffer.extras, o);
+    return true;
+}
+
+bool parseBufferView(tinygltf::BufferView& bufferView, std::string& err, const JsonToken& o) {
+    Int buffer = -1;
+    if(!parseInteger(buffer, err, o, "buffer", true, "BufferView"))
+        return false;
+
+    std::size_t byteOffset = 0;
+    parseUnsigned(byteOffset, err, o, "byteOffset");
+
+    std::size_t byteLength = 1;
+    if(!parseUnsigned(byteLength, err, o, "byteLength", true, "BufferView"))
+        return false;
+
+    std::size_t byteStride = 0;
+    if(!parseUnsigned(byteStride, err, o, "byteStride"))
+        byteStride = 0;
+    if(byteStride > 252 || byteStride % 4 != 0) {
+        err += Utility::formatString("Invalid `byteStride' value. `byteStride' must be the multiple of 4 : {}\n", byteStride);
+        return false;
+    }
+
+    Int target = 0;
+    parseInteger(target, err, o, "target");
+    if(target != TINYGLTF_TARGET_ARRAY_BUFFER && target != TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER)
+        target = 0;
+    bufferView.target = target;
+
+    parseString(bufferView.name, err, o, "name");
+    parseExtensions(bufferView.extensions, o);
+    parseExtras(bufferView.extras, o);
+
+    bufferView.buffer = buffer;
+    bufferView.byteOffset = byteOffset;
+    bufferView.byteLength = byteLength;
+    bufferView.byteStride = byteStride;
+    return true;
+}
+
+bool parseSparseAccessor(tinygltf::Accessor& accessor, std::string& err, const JsonToken& o) {
+    accessor.sparse.isSparse = true;
+
+    Int count = 0;
+    parseInteger(count, err, o, "count", true);
+
+    /* These overwrite all previous errors, same as in tinygltf */
+    const JsonToken* const indices = find(o, "indices");
+    if(!indices) {
+        err = "the sparse object of this accessor doesn't have indices";
+        return false;
+    }
+    const JsonToken* const values = find(o, "values");
+    if(!values) {
+        err = "the sparse object ob ths accessor doesn't have values";
+        return false;
+    }
+
+    Int indicesBufferView = 0, indicesByteOffset = 0, componentType = 0;
+    parseInteger(indicesBufferView, err, *indices, "bufferView", true);
+    parseInteger(indicesByteOffset, err, *indices, "byteOffset", true);
+    parseInteger(componentType, err, *indices, "componentType", true);
+
+    Int valuesBufferView = 0, valuesByteOffset = 0;
+    parseInteger(valuesBufferView, err, *values, "bufferView", true);
+    parseInteger(valuesByteOffset, err, *values, "byteOffset", true);
+
+    accessor.sparse.count = count;
+    accessor.sparse.indices.bufferView = indicesBufferView;
+    accessor.sparse.indices.byteOffset = indicesByteOffset;
+    accessor.sparse.indices.componentType = componentType;
+    accessor.sparse.values.bufferView = valuesBufferView;
+    accessor.sparse.values.byteOffset = valuesByteOffset;
+    return true;
+}
+
+bool parseAccessor(tinygltf::Accessor& accessor, std::string& err, const JsonToken& o) {
+    Int bufferView = -1;
+    parseInteger(bufferView, err, o, "bufferView");
+
+    std::size_t byteOffset = 0;
+    parseUnsigned(byteOffset, err, o, "byteOffset");
+
+    bool normalized = false;
+    parseBoolean(normalized, err, o, "normalized");
+
+    std::size_t componentType = 0;
+    if(!parseUnsigned(componentType, err, o, "componentType", true, "Accessor"))
+        return false;
+
+    std::size_t count = 0;
+    if(!parseUnsigned(count, err, o, "count", true, "Accessor"))
+        return false;
+
+    std::string type;
+    if(!parseString(type, err, o, "type", true, "Accessor"))
+        return false;
+
+    if(type == "SCALAR") accessor.type = TINYGLTF_TYPE_SCALAR;
+    else if(type == "VEC2") accessor.type = TINYGLTF_TYPE_VEC2;
+    else if(type == "VEC3") accessor.type = TINYGLTF_TYPE_VEC3;
+    else if(type == "VEC4") accessor.type = TINYGLTF_TYPE_VEC4;
+    else if(type == "MAT2") accessor.type = TINYGLTF_TYPE_MAT2;
+    else if(type == "MAT3") accessor.type = TINYGLTF_TYPE_MAT3;
+    else if(type == "MAT4") accessor.type = TINYGLTF_TYPE_MAT4;
+    else {
+        err += "Unsupported `type` for accessor object. Got \"" + type + "\"\n";
+        return false;
+    }
+
+    parseString(accessor.name, err, o, "name");
+
+    accessor.minValues.clear();
+    accessor.maxValues.clear();
+    parseNumberArray(accessor.minValues, err, o, "min");
+    parseNumberArray(accessor.maxValues, err, o, "max");
+
+    accessor.count = count;
+    accessor.bufferView = bufferView;
+    accessor.byteOffset = byteOffset;
+    accessor.normalized = normalized;
+    if(componentType < TINYGLTF_COMPONENT_TYPE_BYTE || componentType > TINYGLTF_COMPONENT_TYPE_DOUBLE) {
+        err += Utility::formatString("Invalid `componentType` in accessor. Got {}\n", componentType);
+        return false;
+    }
+    accessor.componentType = Int(componentType);
+
+    parseExtensions(accessor.extensions, o);
+    parseExtras(accessor.extras, o);
+
+    if(const JsonToken* const sparse = find(o, "sparse"))
+        return parseSparseAccessor(accessor, err, *sparse);
+
+    return true;
+}
+
+bool parsePrimitive(tinygltf::Primitive& primitive, std::string& err, const JsonToken& o) {
+    Int material = -1;
+    parseInteger(material, err, o, "material");
+    primitive.material = material;
+
+    Int mode = TINYGLTF_MODE_TRIANGLES;
+    parseInteger(mode, err, o, "mode");
+    primitive.mode = mode;
+
+    Int indices = -1;
+    parseInteger(indices, err, o, "indices");
+    primitive.indices = indices;
+
+    if(!parseStringInteger(primitive.attributes, err, o, "attributes", true, "Primitive"))
+        return false;
+
+    const JsonToken* const targets = find(o, "targets");
+    if(targets && targets->type == JsonTokenType::Array) {
+        primitive.targets.reserve(targets->size);
+        const JsonToken* i = targets + 1;
+        for(UnsignedInt j = 0; j != targets->size; ++j, i += i->tokenCount) {
+            /* Non-object targets are skipped */
+            if(i->type != JsonTokenType::Object) continue;
+
+            std::map<std::string, Int> attributes;
+            forEachMember(*i, [&](const std::string& key, const JsonToken& value) {
+                Int integer;
+                if(getInteger(value, integer)) attributes[key] = integer;
+            });
+            primitive.targets.push_back(std::move(attributes));
+        }
+    }
+
+    parseExtras(primitive.extras, o);
+    parseExtensions(primitive.extensions, o);
+    return true;
+}
+
+bool parseMesh(tinygltf::Mesh& mesh, std::string& err, const JsonToken& o) {
+    parseString(mesh.name, err, o, "name");
+
+    /* Only primitives that were parsed successfully are added */
+    const JsonToken* const primitives = find(o, "primitives");
+    if(primitives && primitives->type == JsonTokenType::Array) {
+        mesh.primitives.reserve(primitives->size);
+        const JsonToken* i = primitives + 1;
+        for(UnsignedInt j = 0; j != primitives->size; ++j, i += i->tokenCount) {
+            tinygltf::Primitive primitive;
+            if(parsePrimitive(primitive, err, *i))
+                mesh.primitives.push_back(std::move(primitive));
+        }
+    }
+
+    parseNumberArray(mesh.weights, err, o, "weights");
+    parseExtensions(mesh.extensions, o);
+    parseExtras(mesh.extras, o);
+    return true;
+}
+
+bool parseNode(tinygltf::Node& node, std::string& err, const JsonToken& o) {
+    parseString(node.name, err, o, "name");
+
+    Int skin = -1;
+    parseInteger(skin, err, o, "skin");
+    node.skin = skin;
+
+    /* Matrix and TRS are exclusive */
+    if(!parseNumberArray(node.matrix, err, o, "matrix")) {
+        parseNumberArray(node.rotation, err, o, "rotation");
+        parseNumberArray(node.scale, err, o, "scale");
+        parseNumberArray(node.translation, err, o, "translation");
+    }
+
+    Int camera = -1;
+    parseInteger(camera, err, o, "camera");
+    node.camera = camera;
+
+    Int mesh = -1;
+    parseInteger(mesh, err, o, "mesh");
+    node.mesh = mesh;
+
+    node.children.clear();
+    parseIntegerArray(node.children, err, o, "children");
+    parseNumberArray(node.weights, err, o, "weights");
+    parseExtensions(node.extensions, o);
+    parseExtras(node.extras, o);
+    return true;
+}
+
+bool parseScene(tinygltf::Scene& scene, std::string& err, const JsonToken& o) {
+    parseIntegerArray(scene.nodes, err, o, "nodes");
+    parseString(scene.name, err, o, "name");
+    parseExtensions(scene.extensions, o);
+    parseExtras(scene.extras, o);
+    return true;
+}
+
+bool parseTextureInfo(tinygltf::TextureInfo& info, std::string& err, const JsonToken& o) {
+    if(!parseInteger(info.index, err, o, "index", true, "TextureInfo"))
+        return false;
+
+    parseInteger(info.texCoord, err, o, "texCoord");
+    parseExtensions(info.extensions, o);
+    parseExtras(info.extras, o);
+    return true;
+}
+
+bool parseNormalTextureInfo(tinygltf::NormalTextureInfo& info, std::string& err, const JsonToken& o) {
+    if(!parseInteger(info.index, err, o, "index", true, "NormalTextureInfo"))
+        return false;
+
+    parseInteger(info.texCoord, err, o, "texCoord");
+    parseNumber(info.scale, err, o, "scale");
+    parseExtensions(info.extensions, o);
+    parseExtras(info.extras, o);
+    return true;
+}
+
+/* The parent name is NormalTextureInfo in tinygltf as well */
+bool parseOcclusionTextureInfo(tinygltf::OcclusionTextureInfo& info, std::string& err, const JsonToken& o) {
+    if(!parseInteger(info.index, err, o, "index", true, "NormalTextureInfo"))
+        return false;
+
+    parseInteger(info.texCoord, err, o, "texCoord");
+    parseNumber(info.strength, err, o, "strength");
+    parseExtensions(info.extensions, o);
+    parseExtras(info.extras, o);
+    return true;
+}
+
+void parsePbrMetallicRoughness(tinygltf::PbrMetallicRoughness& pbr, std::string& err, const JsonToken& o) {
+    /* tinygltf returns early on a wrong size, but the result is ignored by the
+       caller */
+    std::vector<Double> baseColorFactor;
+    if(parseNumberArray(baseColorFactor, err, o, "baseColorFactor")) {
+        if(baseColorFactor.size() != 4) {
+            err += Utility::formatString("Array length of `baseColorFactor` parameter in pbrMetallicRoughness must be 4, but got {}\n", baseColorFactor.size());
+            return;
+        }
+        pbr.baseColorFactor = std::move(baseColorFactor);
+    }
+
+    if(const JsonToken* const texture = find(o, "baseColorTexture"))
+        parseTextureInfo(pbr.baseColorTexture, err, *texture);
+    if(const JsonToken* const texture = find(o, "metallicRoughnessTexture"))
+        parseTextureInfo(pbr.metallicRoughnessTexture, err, *texture);
+
+    parseNumber(pbr.metallicFactor, err, o, "metallicFactor");
+    parseNumber(pbr.roughnessFactor, err, o, "roughnessFactor");
+    parseExtensions(pbr.extensions, o);
+    parseExtras(pbr.extras, o);
+}
+
+bool parseMaterial(tinygltf::Material& material, std::string& err, const JsonToken& o) {
+    parseString(material.name, err, o, "name");
+
+    if(parseNumberArray(material.emissiveFactor, err, o, "emissiveFactor")) {
+        if(material.emissiveFactor.size() != 3) {
+            err += Utility::formatString("Array length of `emissiveFactor` parameter in material must be 3, but got {}\n", material.emissiveFactor.size());
+            return false;
+        }
+    } else material.emissiveFactor = {0.0, 0.0, 0.0};
+
+    parseString(material.alphaMode, err, o, "alphaMode");
+    parseNumber(material.alphaCutoff, err, o, "alphaCutoff");
+    parseBoolean(material.doubleSided, err, o, "doubleSided");
+
+    if(const JsonToken* const pbr = find(o, "pbrMetallicRoughness"))
+        parsePbrMetallicRoughness(material.pbrMetallicRoughness, err, *pbr);
+    if(const JsonToken* const texture = find(o, "normalTexture"))
+        parseNormalTextureInfo(material.normalTexture, err, *texture);
+    if(const JsonToken* const texture = find(o, "occlusionTexture"))
+        parseOcclusionTextureInfo(material.occlusionTexture, err, *texture);
+    if(const JsonToken* const texture = find(o, "emissiveTexture"))
+        parseTextureInfo(material.emissiveTexture, err, *texture);
+
+    /* Material properties duplicated in the old parameter maps, tinygltf
+       still fills them for backwards compatibility */
+    material.values.clear();
+    material.additionalValues.clear();
+    forEachMember(o, [&](const std::string& key, const JsonToken& value) {
+        if(key == "pbrMetallicRoughness") {
+            if(value.type != JsonTokenType::Object) return;
+            forEachMember(value, [&](const std::string& name, const JsonToken&) {
+                tinygltf::Parameter parameter;
+                if(parseParameter(parameter, err, value, name))
+                    material.values.emplace(name, std::move(parameter));
+            });
+        } else if(key != "extensions" && key != "extras") {
+            tinygltf::Parameter parameter;
+            if(parseParameter(parameter, err, o, key) && key != "name")
+                material.additionalValues.emplace(key, std::move(parameter));
+        }
+    });
+
+    material.extensions.clear();
+    parseExtensions(material.extensions, o);
+    parseExtras(material.extras, o);
+    return true;
+}
+
+bool parseImage(tinygltf::Image& image, const Int id, std::string& err, const JsonToken& o) {
+    const bool hasBufferView = find(o, "bufferView");
+    const bool hasUri = find(o, "uri");
+
+    parseString(image.name, err, o, "name");
+
+    if(hasBufferView && hasUri) {
+        err += Utility::formatString("Only one of `bufferView` or `uri` should be defined, but both are defined for image[{}] name = \"{}\"\n", id, image.name);
+        return false;
+    }
+    if(!hasBufferView && !hasUri) {
+        err += Utility::formatString("Neither required `bufferView` nor `uri` defined for image[{}] name = \"{}\"\n", id, image.name);
+        return false;
+    }
+
+    parseExtensions(image.extensions, o);
+    parseExtras(image.extras, o);
+
+    if(hasBufferView) {
+        Int bufferView = -1;
+        if(!parseInteger(bufferView, err, o, "bufferView", true)) {
+            err += Utility::formatString("Failed to parse `bufferView` for image[{}] name = \"{}\"\n", id, image.name);
+            return false;
+        }
+
+        std::string mimeType;
+        parseString(mimeType, err, o, "mimeType");
+        Int width = 0;
+        parseInteger(width, err, o, "width");
+        Int height = 0;
+        parseInteger(height, err, o, "height");
+
+        image.bufferView = bufferView;
+        image.mimeType = std::move(mimeType);
+        image.width = width;
+        image.height = height;
+        return true;
+    }
+
+    std::string uri;
+    std::string uriError;
+    if(!parseString(uri, uriError, o, "uri", true)) {
+        err += Utility::formatString("Failed to parse `uri` for image[{}] name = \"{}\".\n", id, image.name);
+        return false;
+    }
+
+    /* Data URIs are decoded right into the image, which is what the image
+       loader callback set by the importer does with tinygltf. External files
+       are loaded by the importer itself. */
+    if(tinygltf::IsDataURI(uri)) {
+        if(!tinygltf::DecodeDataURI(&image.image, image.mimeType, uri, 0, false)) {
+            err += Utility::formatString("Failed to decode 'uri' for image[{}] name = [{}]\n", id, image.name);
+            return false;
+        }
+    } else image.uri = std::move(uri);
+
+    return true;
+}
+
+bool parseTexture(tinygltf::Texture& texture, std::string& err, const JsonToken& o) {
+    Int sampler = -1;
+    parseInteger(sampler, err, o, "sampler");
+    Int source = -1;
+    parseInteger(source, err, o, "source");
+    texture.sampler = sampler;
+    texture.source = source;
+
+    parseExtensions(texture.extensions, o);
+    parseExtras(texture.extras, o);
+    parseString(texture.name, err, o, "name");
+    return true;
+}
+
+bool parseAnimationChannel(tinygltf::AnimationChannel& channel, std::string& err, const JsonToken& o) {
+    Int sampler = -1;
+    if(!parseInteger(sampler, err, o, "sampler", true, "AnimationChannel")) {
+        err += "`sampler` field is missing in animation channels\n";
+        return false;
+    }
+
+    Int targetNode = -1;
+    const JsonToken* const target = find(o, "target");
+    if(target && target->type == JsonTokenType::Object) {
+        if(!parseInteger(targetNode, err, *target, "node", true)) {
+            err += "`node` field is missing in animation.channels.target\n";
+            return false;
+        }
+
+        if(!parseString(channel.target_path, err, *target, "path", true)) {
+            err += "`path` field is missing in animation.channels.target\n";
+            return false;
+        }
+    }
+
+    channel.sampler = sampler;
+    channel.target_node = targetNode;
+
+    parseExtensions(channel.extensions, o);
+    parseExtras(channel.extras, o);
+    return true;
+}
+
+bool parseAnimation(tinygltf::Animation& animation, std::string& err, const JsonToken& o) {
+    /* Only channels that were parsed successfully are added */
+    const JsonToken* const channels = find(o, "channels");
+    if(channels && channels->type == JsonTokenType::Array) {
+        animation.channels.reserve(channels->size);
+        const JsonToken* i = channels + 1;
+        for(UnsignedInt j = 0; j != channels->size; ++j, i += i->tokenCount) {
+            tinygltf::AnimationChannel channel;
+            if(parseAnimationChannel(channel, err, *i))
+                animation.channels.push_back(std::move(channel));
+        }
+    }
+
+    /* A sampler failure fails the whole file, on the other hand */
+    const JsonToken* const samplers = find(o, "samplers");
+    if(samplers && samplers->type == JsonTokenType::Array) {
+        animation.samplers.reserve(samplers->size);
+        const JsonToken* i = samplers + 1;
+        for(UnsignedInt j = 0; j != samplers->size; ++j, i += i->tokenCount) {
+            tinygltf::AnimationSampler sampler;
+            Int input = -1, output = -1;
+            if(!parseInteger(input, err, *i, "input", true)) {
+                err += "`input` field is missing in animation.sampler\n";
+                return false;
+            }
+            parseString(sampler.interpolation, err, *i, "interpolation");
+            if(!parseInteger(output, err, *i, "output", true)) {
+                err += "`output` field is missing in animation.sampler\n";
+                return false;
+            }
+            sampler.input = input;
+            sampler.output = output;
+
+            /* tinygltf takes sampler extensions from the animation object */
+            parseExtensions(sampler.extensions, o);
+            parseExtras(sampler.extras, *i);
+            animation.samplers.push_back(std::move(sampler));
+        }
+    }
+
+    parseString(animation.name, err, o, "name");
+    parseExtensions(animation.extensions, o);
+    parseExtras(animation.extras, o);
+    return true;
+}
+
+bool parseSkin(tinygltf::Skin& skin, std::string& err, const JsonToken& o) {
+    parseString(skin.name, err, o, "name", false, "Skin");
+
+    std::vector<Int> joints;
+    if(!parseIntegerArray(joints, err, o, "joints", false, "Skin"))
+        return false;
+    skin.joints = std::move(joints);
+
+    Int skeleton = -1;
+    parseInteger(skeleton, err, o, "skeleton", false, "Skin");
+    skin.skeleton = skeleton;
+
+    Int inverseBindMatrices = -1;
+    parseInteger(inverseBindMatrices, err, o, "inverseBindMatrices", true, "Skin");
+    skin.inverseBindMatrices = inverseBindMatrices;
+
+    parseExtensions(skin.extensions, o);
+    parseExtras(skin.extras, o);
+    return true;
+}
+
+bool parseSampler(tinygltf::Sampler& sampler, std::string& err, const JsonToken& o) {
+    parseString(sampler.name, err, o, "name");
+
+    Int minFilter = -1;
+    Int magFilter = -1;
+    Int wrapS = TINYGLTF_TEXTURE_WRAP_REPEAT;
+    Int wrapT = TINYGLTF_TEXTURE_WRAP_REPEAT;
+    Int wrapR = TINYGLTF_TEXTURE_WRAP_REPEAT;
+    parseInteger(minFilter, err, o, "minFilter");
+    parseInteger(magFilter, err, o, "magFilter");
+    parseInteger(wrapS, err, o, "wrapS");
+    parseInteger(wrapT, err, o, "wrapT");
+    parseInteger(wrapR, err, o, "wrapR");
+    sampler.minFilter = minFilter;
+    sampler.magFilter = magFilter;
+    sampler.wrapS = wrapS;
+    sampler.wrapT = wrapT;
+    sampler.wrapR = wrapR;
+
+    parseExtensions(sampler.extensions, o);
+    parseExtras(sampler.extras, o);
+    return true;
+}
+
+bool parseOrthographicCamera(tinygltf::OrthographicCamera& camera, std::string& err, const JsonToken& o) {
+    Double xmag = 0.0, ymag = 0.0, zfar = 0.0, znear = 0.0;
+    if(!parseNumber(xmag, err, o, "xmag", true, "OrthographicCamera") ||
+       !parseNumber(ymag, err, o, "ymag", true, "OrthographicCamera") ||
+       !parseNumber(zfar, err, o, "zfar", true, "OrthographicCamera") ||
+       !parseNumber(znear, err, o, "znear", true, "OrthographicCamera"))
+        return false;
+
+    parseExtensions(camera.extensions, o);
+    parseExtras(camera.extras, o);
+
+    camera.xmag = xmag;
+    camera.ymag = ymag;
+    camera.zfar = zfar;
+    camera.znear = znear;
+    return true;
+}
+
+/* The parent name of yfov is OrthographicCamera in tinygltf as well */
+bool parsePerspectiveCamera(tinygltf::PerspectiveCamera& camera, std::string& err, const JsonToken& o) {
+    Double yfov = 0.0, znear = 0.0;
+    if(!parseNumber(yfov, err, o, "yfov", true, "OrthographicCamera") ||
+       !parseNumber(znear, err, o, "znear", true, "PerspectiveCamera"))
+        return false;
+
+    Double aspectRatio = 0.0, zfar = 0.0;
+    parseNumber(aspectRatio, err, o, "aspectRatio", false, "PerspectiveCamera");
+    parseNumber(zfar, err, o, "zfar", false, "PerspectiveCamera");
+
+    camera.aspectRatio = aspectRatio;
+    camera.zfar = zfar;
+    camera.yfov = yfov;
+    camera.znear = znear;
+
+    parseExtensions(camera.extensions, o);
+    parseExtras(camera.extras, o);
+    return true;
+}
+
+bool parseCamera(tinygltf::Camera& camera, std::string& err, const JsonToken& o) {
+    if(!parseString(camera.type, err, o, "type", true, "Camera"))
+        return false;
+
+    if(camera.type == "orthographic") {
+        const JsonToken* const orthographic = find(o, "orthographic");
+        if(!orthographic) {
+            err += "Orhographic camera description not found.\n";
+            return false;
+        }
+        if(orthographic->type != JsonTokenType::Object) {
+            err += "\"orthographic\" is not a JSON object.\n";
+            return false;
+        }
+        if(!parseOrthographicCamera(camera.orthographic, err, *orthographic))
+            return false;
+
+    } else if(camera.type == "perspective") {
+        const JsonToken* const perspective = find(o, "perspective");
+        if(!perspective) {
+            err += "Perspective camera description not found.\n";
+            return false;
+        }
+        if(perspective->type != JsonTokenType::Object) {
+            err += "\"perspective\" is not a JSON object.\n";
+            return false;
+        }
+        if(!parsePerspectiveCamera(camera.perspective, err, *perspective))
+            return false;
+
+    } else {
+        err += "Invalid camera type: \"" + camera.type + "\". Must be \"perspective\" or \"orthographic\"\n";
+        return false;
+    }
+
+    parseString(camera.name, err, o, "name");
+    parseExtensions(camera.extensions, o);
+    parseExtras(camera.extras, o);
+    return true;
+}
+
+bool parseLight(tinygltf::Light& light, std::string& err, const JsonToken& o) {
+    if(!parseString(light.type, err, o, "type", true))
+        return false;
+
+    if(light.type == "spot") {
+        const JsonToken* const spot = find(o, "spot");
+        if(!spot) {
+            err += "Spot light description not found.\n";
+            return false;
+        }
+        if(spot->type != JsonTokenType::Object) {
+            err += "\"spot\" is not a JSON object.\n";
+            return false;
+        }
+
+        parseNumber(light.spot.innerConeAngle, err, *spot, "innerConeAngle");
+        parseNumber(light.spot.outerConeAngle, err, *spot, "outerConeAngle");
+        parseExtensions(light.spot.extensions, *spot);
+        parseExtras(light.spot.extras, *spot);
+    }
+
+    parseString(light.name, err, o, "name");
+    parseNumberArray(light.color, err, o, "color");
+    parseNumber(light.range, err, o, "range");
+    parseNumber(light.intensity, err, o, "intensity");
+    parseExtensions(light.extensions, o);
+    parseExtras(light.extras, o);
+    return true;
+}
+
+/* Parses all objects of a top-level array. Entries that aren't objects are
+   an error. */
+template<class T, class F> bool parseArray(std::vector<T>& out, std::string& err, const JsonToken& root, const char* const name, F parse) {
+    const JsonToken* const array = find(root, name);
+    if(!array || array->type != JsonTokenType::Array) return true;
+
+    out.reserve(array->size);
+    const JsonToken* i = array + 1;
+    for(UnsignedInt j = 0; j != array->size; ++j, i += i->tokenCount) {
+        if(i->type != JsonTokenType::Object) {
+            err += Utility::formatString("`{}' does not contain an JSON object.", name);
+            return false;
+        }
+
+        T item;
+        if(!parse(item, err, *i)) return false;
+        out.push_back(std::move(item));
+    }
+
+    return true;
+}
+
+void parseStringArray(std::vector<std::string>& out, const JsonToken& root, const char* const name) {
+    const JsonToken* const array = find(root, name);
+    if(!array || array->type != JsonTokenType::Array) return;
+
+    /* Entries that aren't strings are added as empty */
+    out.reserve(array->size);
+    const JsonToken* i = array + 1;
+    for(UnsignedInt j = 0; j != array->size; ++j, i += i->tokenCount)
+        out.push_back(i->type == JsonTokenType::String ? jsonString(*i) : std::string{});
+}
+
+}
+
+bool loadGltfModel(tinygltf::Model& model, std::string& err, const Containers::ArrayView<const char> data, const tinygltf::FsCallbacks& fs) {
+    Containers::ArrayView<const char> json = data;
+    bool binary = false;
+    Containers::ArrayView<const char> binaryChunk;
+    std::size_t binarySize = 0;
+    if(data.size() >= 4 && std::strncmp(data.data(), "glTF", 4) == 0) {
+        if(data.size() < 20) {
+            err = "Too short data size for glTF Binary.";
+            return false;
+        }
+
+        /* The version field is ignored, same as in tinygltf */
+        UnsignedInt header[4];
+        std::memcpy(header, data.data() + 4, sizeof(header));
+        const std::size_t length = Utility::Endianness::littleEndian(header[1]);
+        const std::size_t jsonLength = Utility::Endianness::littleEndian(header[2]);
+        const UnsignedInt jsonFormat = Utility::Endianness::littleEndian(header[3]);
+        if(20 + jsonLength > data.size() || jsonLength < 1 || length > data.size() || 20 + jsonLength > length || jsonFormat != 0x4E4F534A) {
+            err = "Invalid glTF binary.";
+            return false;
+        }
+
+        json = data.slice(20, 20 + jsonLength);
+        binary = true;
+        /* The reported size of the binary chunk includes its 8-byte header,
+           while the data pointer is after it. tinygltf bounds the copy only by
+           the reported size, so take everything up to the end of the data. */
+        binarySize = length - (20 + jsonLength);
+        if(20 + jsonLength + 8 < data.size())
+            binaryChunk = data.slice(20 + jsonLength + 8, data.size());
+    }
+
+    if(json.size() < 4) {
+        err = "JSON string too short.\n";
+        return false;
+    }
+
+    std::vector<JsonToken> tokens;
+    if(!tokenizeJson(json, tokens, err))
+        return false;
+
+    const JsonToken& root = tokens.front();
+    if(root.type != JsonTokenType::Object) {
+        err = "Root element is not a JSON object\n";
+        return false;
+    }
+
+    model.defaultScene = -1;
+
+    const JsonToken* const asset = find(root, "asset");
+    if(asset && asset->type == JsonTokenType::Object) {
+        parseString(model.asset.version, err, *asset, "version", true, "Asset");
+        parseString(model.asset.generator, err, *asset, "generator", false, "Asset");
+        parseString(model.asset.minVersion, err, *asset, "minVersion", false, "Asset");
+        parseExtensions(model.asset.extensions, *asset);
+        parseExtras(model.asset.extras, *asset);
+    }
+
+    parseStringArray(model.extensionsUsed, root, "extensionsUsed");
+    parseStringArray(model.extensionsRequired, root, "extensionsRequired");
+
+    if(!parseArray(model.buffers, err, root, "buffers", [&](tinygltf::Buffer& buffer, std::string& error, const JsonToken& o) {
+            return parseBuffer(buffer, error, o, fs, binary, binaryChunk, binarySize);
+        }) ||
+       !parseArray(model.bufferViews, err, root, "bufferViews", parseBufferView) ||
+       !parseArray(model.accessors, err, root, "accessors", parseAccessor) ||
+       !parseArray(model.meshes, err, root, "meshes", parseMesh))
+        return false;
+
+    /* Buffer views referenced by mesh indices are index buffers, all other
+       are vertex buffers */
+    for(const tinygltf::Mesh& mesh: model.meshes) {
+        for(const tinygltf::Primitive& primitive: mesh.primitives) {
+            if(primitive.indices < 0) continue;
+
+            if(std::size_t(primitive.indices) >= model.accessors.size()) {
+                err += "primitive indices accessor out of bounds";
+                return false;
+            }
+
+            const Int bufferView = model.accessors[primitive.indices].bufferView;
+            if(bufferView < 0 || std::size_t(bufferView) >= model.bufferViews.size()) {
+                err += Utility::formatString("accessor[{}] invalid bufferView", primitive.indices);
+                return false;
+            }
+
+            model.bufferViews[bufferView].target = TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER;
+        }
+    }
+    for(tinygltf::BufferView& bufferView: model.bufferViews)
+        if(bufferView.target == 0)
+            bufferView.target = TINYGLTF_TARGET_ARRAY_BUFFER;
+
+    if(!parseArray(model.nodes, err, root, "nodes", parseNode) ||
+       !parseArray(model.scenes, err, root, "scenes", parseScene))
+        return false;
+
+    if(const JsonToken* const scene = find(root, "scene"))
+        getInteger(*scene, model.defaultScene);
+
+    if(!parseArray(model.materials, err, root, "materials", parseMaterial))
+        return false;
+
+    /* Images have a different error message and check the buffer view
+       reference right after being parsed */
+    const JsonToken* const images = find(root, "images");
+    if(images && images->type == JsonTokenType::Array) {
+        model.images.reserve(images->size);
+        const JsonToken* i = images + 1;
+        for(UnsignedInt j = 0; j != images->size; ++j, i += i->tokenCount) {
+            if(i->type != JsonTokenType::Object) {
+                err += Utility::formatString("image[{}] is not a JSON object.", j);
+                return false;
+            }
+
+            tinygltf::Image image;
+            if(!parseImage(image, j, err, *i))
+                return false;
+
+            if(image.bufferView != -1) {
+                if(std::size_t(image.bufferView) >= model.bufferViews.size()) {
+                    err += Utility::formatString("image[{}] bufferView \"{}\" not found in the scene.\n", j, image.bufferView);
+                    return false;
+                }
+
+                const Int buffer = model.bufferViews[image.bufferView].buffer;
+                if(std::size_t(buffer) >= model.buffers.size()) {
+                    err += Utility::formatString("image[{}] buffer \"{}\" not found in the scene.\n", j, buffer);
+                    return false;
+                }
+            }
+
+            model.images.push_back(std::move(image));
+        }
+    }
+
+    if(!parseArray(model.textures, err, root, "textures", parseTexture) ||
+       !parseArray(model.animations, err, root, "animations", parseAnimation) ||
+       !parseArray(model.skins, err, root, "skins", parseSkin) ||
+       !parseArray(model.samplers, err, root, "samplers", parseSampler) ||
+       !parseArray(model.cameras, err, root, "cameras", parseCamera))
+        return false;
+
+    parseExtensions(model.extensions, root);
+
+    /* KHR_lights_punctual, entries that aren't objects fail the whole file
+       because of the required type property */
+    const JsonToken* const extensions = find(root, "extensions");
+    const JsonToken* const lightsPunctual = extensions ? find(*extensions, "KHR_lights_punctual") : nullptr;
+    const JsonToken* const lights = lightsPunctual ? find(*lightsPunctual, "lights") : nullptr;
+    if(lights && lights->type == JsonTokenType::Array) {
+        model.lights.reserve(lights->size);
+        const JsonToken* i = lights + 1;
+        for(UnsignedInt j = 0; j != lights->size; ++j, i += i->tokenCount) {
+            tinygltf::Light light;
+            if(!parseLight(light, err, *i))
+                return false;
+            model.lights.push_back(std::move(light));
+        }
+    }
+
+    parseExtras(model.extras, root);
+    return true;
+}
+
+}}}
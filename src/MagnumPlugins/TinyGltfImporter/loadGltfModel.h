@@ -0,0 +1,50 @@
+#ifndef Magnum_Trade_TinyGltfImporter_loadGltfModel_h
+#define Magnum_Trade_TinyGltfImporter_loadGltfModel_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <string>
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Magnum.h>
+
+namespace tinygltf {
+    class Model;
+    struct FsCallbacks;
+}
+
+namespace Magnum { namespace Trade { namespace Implementation {
+
+/* Fills an empty model from a glTF or GLB file using the tokenizer from
+   Json.h instead of the JSON DOM tinygltf builds. The resulting model and the
+   errors for invalid files are the same as from TinyGLTF::LoadASCIIFromString()
+   or LoadBinaryFromMemory() with SectionCheck::NO_REQUIRE, no base directory,
+   external images disabled and an image loader that copies only images
+   embedded in data URIs, which is how the plugin calls tinygltf. Only the
+   JSON syntax errors are worded differently. */
+bool loadGltfModel(tinygltf::Model& model, std::string& error, Containers::ArrayView<const char> data, const tinygltf::FsCallbacks& callbacks);
+
+}}}
+
+#endif